@@ -4,12 +4,16 @@
 
 #include "AutoFibIndicator.h"
 #include "bar.h"
+#include "BarArena.h"
+#include "BarSeries.h"
+#include "BarTime.h"
+#include "JsonWriter.h"
 
 AutoFibIndicator::AutoFibIndicator(int barsBack, int startBar)
     : bars_back(barsBack), start_bar(startBar),
       last_lowest_bar(-1), last_highest_bar(-1),
       last_high_value(0), last_low_value(0),
-      last_is_bullish(true) {
+      last_is_bullish(true), atr_filter_multiple(0), current_atr(0) {
 
     // Default Fibonacci levels (matching MQL5 version)
     fibo_level_values["level_0"] = 0.000;
@@ -22,6 +26,9 @@ AutoFibIndicator::AutoFibIndicator(int barsBack, int startBar)
     fibo_level_values["level_7"] = 1.000;
     fibo_level_values["level_8"] = 1.618;  // Extension
     fibo_level_values["level_9"] = 2.618;  // Extension
+
+    // Nothing calculated yet: getSignal() is NO_DATA and updatePrice() is ignored
+    results.error = "No completed bars";
 }
 
 void AutoFibIndicator::setFibonacciLevels(const std::map<std::string, double>& levels) {
@@ -35,17 +42,81 @@ std::string AutoFibIndicator::getCurrentTimestamp() const {
     return std::string(buf);
 }
 
-int AutoFibIndicator::findLowestBar(const std::vector<Bar>& bars, int start, int count) const {
-    if (start < 0 || count <= 0 || start + count > static_cast<int>(bars.size())) {
+namespace {
+
+// Bar sources accepted by AutoFibIndicator::calculateSeries()
+class VectorBars {
+private:
+    const std::vector<Bar>& bars;
+
+public:
+    explicit VectorBars(const std::vector<Bar>& b) : bars(b) {}
+
+    int size() const { return static_cast<int>(bars.size()); }
+    double high(int i) const { return bars[i].high; }
+    double low(int i) const { return bars[i].low; }
+    double close(int i) const { return bars[i].close; }
+    bool isLater(int a, int b) const { return bars[a].time > bars[b].time; }
+    std::string timeString(int i) const { return bars[i].time; }
+};
+
+class RecordBars {
+private:
+    const std::vector<BarRecord>& bars;
+
+public:
+    explicit RecordBars(const std::vector<BarRecord>& b) : bars(b) {}
+
+    int size() const { return static_cast<int>(bars.size()); }
+    double high(int i) const { return bars[i].high; }
+    double low(int i) const { return bars[i].low; }
+    double close(int i) const { return bars[i].close; }
+    bool isLater(int a, int b) const { return bars[a].time > bars[b].time; }
+    std::string timeString(int i) const { return formatWallClock(static_cast<long>(bars[i].time)); }
+};
+
+class ArenaBars {
+private:
+    const BarArena& bars;
+
+public:
+    explicit ArenaBars(const BarArena& b) : bars(b) {}
+
+    int size() const { return static_cast<int>(bars.size()); }
+    double high(int i) const { return bars[i].high; }
+    double low(int i) const { return bars[i].low; }
+    double close(int i) const { return bars[i].close; }
+    bool isLater(int a, int b) const { return bars[a].time > bars[b].time; }
+    std::string timeString(int i) const { return formatWallClock(static_cast<long>(bars[i].time)); }
+};
+
+class ColumnBars {
+private:
+    const BarSeries& series;
+
+public:
+    explicit ColumnBars(const BarSeries& s) : series(s) {}
+
+    int size() const { return static_cast<int>(series.size()); }
+    double high(int i) const { return series.high(i); }
+    double low(int i) const { return series.low(i); }
+    double close(int i) const { return series.close(i); }
+    bool isLater(int a, int b) const { return series.time(a) > series.time(b); }
+    std::string timeString(int i) const { return formatWallClock(static_cast<long>(series.time(i))); }
+};
+
+template <typename Series>
+int lowestIndex(const Series& bars, int start, int count) {
+    if (start < 0 || count <= 0 || start + count > bars.size()) {
         return -1;
     }
 
     int lowest_idx = start;
-    double lowest_value = bars[start].low;
+    double lowest_value = bars.low(start);
 
     for (int i = start; i < start + count; ++i) {
-        if (bars[i].low < lowest_value) {
-            lowest_value = bars[i].low;
+        if (bars.low(i) < lowest_value) {
+            lowest_value = bars.low(i);
             lowest_idx = i;
         }
     }
@@ -53,17 +124,18 @@ int AutoFibIndicator::findLowestBar(const std::vector<Bar>& bars, int start, int
     return lowest_idx;
 }
 
-int AutoFibIndicator::findHighestBar(const std::vector<Bar>& bars, int start, int count) const {
-    if (start < 0 || count <= 0 || start + count > static_cast<int>(bars.size())) {
+template <typename Series>
+int highestIndex(const Series& bars, int start, int count) {
+    if (start < 0 || count <= 0 || start + count > bars.size()) {
         return -1;
     }
 
     int highest_idx = start;
-    double highest_value = bars[start].high;
+    double highest_value = bars.high(start);
 
     for (int i = start; i < start + count; ++i) {
-        if (bars[i].high > highest_value) {
-            highest_value = bars[i].high;
+        if (bars.high(i) > highest_value) {
+            highest_value = bars.high(i);
             highest_idx = i;
         }
     }
@@ -71,18 +143,29 @@ int AutoFibIndicator::findHighestBar(const std::vector<Bar>& bars, int start, in
     return highest_idx;
 }
 
-FibonacciResults AutoFibIndicator::calculate(const std::vector<Bar>& bars) {
+} // namespace
+
+int AutoFibIndicator::findLowestBar(const std::vector<Bar>& bars, int start, int count) const {
+    return lowestIndex(VectorBars(bars), start, count);
+}
+
+int AutoFibIndicator::findHighestBar(const std::vector<Bar>& bars, int start, int count) const {
+    return highestIndex(VectorBars(bars), start, count);
+}
+
+template <typename Series>
+FibonacciResults AutoFibIndicator::calculateSeries(const Series& bars) {
     results = FibonacciResults();  // Reset results
 
     // Validate input
-    if (static_cast<int>(bars.size()) < bars_back + start_bar) {
+    if (bars.size() < bars_back + start_bar) {
         results.error = "Not enough bars";
         return results;
     }
 
     // Find highest and lowest bars in lookback period
-    int lowest_idx = findLowestBar(bars, start_bar, bars_back);
-    int highest_idx = findHighestBar(bars, start_bar, bars_back);
+    int lowest_idx = lowestIndex(bars, start_bar, bars_back);
+    int highest_idx = highestIndex(bars, start_bar, bars_back);
 
     // Error checking
     if (lowest_idx < 0 || highest_idx < 0) {
@@ -90,8 +173,8 @@ FibonacciResults AutoFibIndicator::calculate(const std::vector<Bar>& bars) {
         return results;
     }
 
-    double high_value = bars[highest_idx].high;
-    double low_value = bars[lowest_idx].low;
+    double high_value = bars.high(highest_idx);
+    double low_value = bars.low(lowest_idx);
 
     // Validate price data
     if (high_value <= 0 || low_value <= 0 || high_value <= low_value) {
@@ -99,11 +182,8 @@ FibonacciResults AutoFibIndicator::calculate(const std::vector<Bar>& bars) {
         return results;
     }
 
-    std::string high_time = bars[highest_idx].time;
-    std::string low_time = bars[lowest_idx].time;
-
     // Determine trend direction (bullish if high came after low)
-    bool is_bullish = high_time > low_time;
+    bool is_bullish = bars.isLater(highest_idx, lowest_idx);
 
     // Calculate Fibonacci range
     double fibo_range = high_value - low_value;
@@ -138,17 +218,20 @@ FibonacciResults AutoFibIndicator::calculate(const std::vector<Bar>& bars) {
     results.trend = is_bullish ? "BULLISH" : "BEARISH";
     results.high_value = high_value;
     results.low_value = low_value;
-    results.high_time = high_time;
-    results.low_time = low_time;
+    results.high_time = bars.timeString(highest_idx);
+    results.low_time = bars.timeString(lowest_idx);
     results.high_bar_index = highest_idx;
     results.low_bar_index = lowest_idx;
     results.fibo_range = fibo_range;
     results.fibo_levels = fibo_prices;
     results.golden_zone_low = golden_zone_low;
     results.golden_zone_high = golden_zone_high;
-    results.current_price = bars.back().close;
+    results.current_price = bars.close(bars.size() - 1);
     results.price_in_golden_zone = (results.current_price >= golden_zone_low &&
                                      results.current_price <= golden_zone_high);
+    results.atr = current_atr;
+    results.range_below_atr = atr_filter_multiple > 0 && current_atr > 0 &&
+                              fibo_range < atr_filter_multiple * current_atr;
 
     // Update cache
     last_lowest_bar = lowest_idx;
@@ -160,13 +243,43 @@ FibonacciResults AutoFibIndicator::calculate(const std::vector<Bar>& bars) {
     return results;
 }
 
+FibonacciResults AutoFibIndicator::calculate(const std::vector<Bar>& bars) {
+    return calculateSeries(VectorBars(bars));
+}
+
+FibonacciResults AutoFibIndicator::calculate(const BarSeries& series) {
+    return calculateSeries(ColumnBars(series));
+}
+
+FibonacciResults AutoFibIndicator::calculate(const std::vector<BarRecord>& bars) {
+    return calculateSeries(RecordBars(bars));
+}
+
+FibonacciResults AutoFibIndicator::calculate(const BarArena& bars) {
+    return calculateSeries(ArenaBars(bars));
+}
+
+void AutoFibIndicator::updatePrice(double price) {
+    if (!results.error.empty()) {
+        return;
+    }
+
+    results.current_price = price;
+    results.price_in_golden_zone = (price >= results.golden_zone_low &&
+                                    price <= results.golden_zone_high);
+}
+
 std::string AutoFibIndicator::getSignal() const {
+    return signalFor(results);
+}
+
+const char* AutoFibIndicator::signalFor(const FibonacciResults& results) {
     if (!results.error.empty()) {
         return "NO_DATA";
     }
 
     // Trading logic: Buy in golden zone during uptrend
-    if (results.price_in_golden_zone) {
+    if (results.price_in_golden_zone && !results.range_below_atr) {
         if (results.trend == "BULLISH") {
             return "BUY";
         } else {
@@ -225,31 +338,7 @@ void AutoFibIndicator::printReport() const {
 }
 
 std::string AutoFibIndicator::toJSON() const {
-    std::ostringstream json;
-    json << std::fixed << std::setprecision(2);
-
-    json << "{\n";
-
-    if (!results.error.empty()) {
-        json << "  \"error\": \"" << results.error << "\"\n";
-    } else {
-        json << "  \"timestamp\": \"" << results.timestamp << "\",\n";
-        json << "  \"trend\": \"" << results.trend << "\",\n";
-        json << "  \"high_value\": " << results.high_value << ",\n";
-        json << "  \"low_value\": " << results.low_value << ",\n";
-        json << "  \"high_time\": \"" << results.high_time << "\",\n";
-        json << "  \"low_time\": \"" << results.low_time << "\",\n";
-        json << "  \"fibo_range\": " << results.fibo_range << ",\n";
-        json << "  \"current_price\": " << results.current_price << ",\n";
-        json << "  \"price_in_golden_zone\": " << (results.price_in_golden_zone ? "true" : "false") << ",\n";
-        json << "  \"golden_zone\": {\n";
-        json << "    \"low\": " << results.golden_zone_low << ",\n";
-        json << "    \"high\": " << results.golden_zone_high << "\n";
-        json << "  },\n";
-        json << "  \"signal\": \"" << getSignal() << "\"\n";
-    }
-
-    json << "}";
-
+    JsonWriter json(1024);
+    writeResultsJSON(json, std::string(), results, signalFor(results));
     return json.str();
 }
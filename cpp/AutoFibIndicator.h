@@ -21,6 +21,9 @@
 
 // Forward declaration - use IBKR's Bar struct
 struct Bar;
+struct BarRecord;
+class BarArena;
+class BarSeries;
 
 /**
  * Structure to hold Fibonacci analysis results
@@ -40,12 +43,14 @@ struct FibonacciResults {
     double golden_zone_high;
     double current_price;
     bool price_in_golden_zone;
+    double atr;                     // ATR of the bar series when calculated, 0 if unknown
+    bool range_below_atr;           // fibo_range < ATR filter multiple * atr
     std::string error;
 
     FibonacciResults() : high_value(0), low_value(0), high_bar_index(0),
                          low_bar_index(0), fibo_range(0), golden_zone_low(0),
                          golden_zone_high(0), current_price(0),
-                         price_in_golden_zone(false) {}
+                         price_in_golden_zone(false), atr(0), range_below_atr(false) {}
 };
 
 /**
@@ -65,12 +70,19 @@ private:
     double last_low_value;
     bool last_is_bullish;
 
+    // Volatility filter: swings narrower than atr_filter_multiple * ATR give no signal
+    double atr_filter_multiple;
+    double current_atr;
+
     FibonacciResults results;
 
     std::string getCurrentTimestamp() const;
     int findLowestBar(const std::vector<Bar>& bars, int start, int count) const;
     int findHighestBar(const std::vector<Bar>& bars, int start, int count) const;
 
+    template <typename Series>
+    FibonacciResults calculateSeries(const Series& bars);
+
 public:
     /**
      * Constructor
@@ -85,6 +97,23 @@ public:
      */
     void setFibonacciLevels(const std::map<std::string, double>& levels);
 
+    /**
+     * Level names and ratios used by calculate()
+     */
+    const std::map<std::string, double>& getFibonacciLevels() const { return fibo_level_values; }
+
+    /**
+     * Suppress signals for swings that are small against volatility
+     * @param multiple Signals need fibo_range >= multiple * ATR (0 disables the filter)
+     */
+    void setAtrFilter(double multiple) { atr_filter_multiple = multiple; }
+
+    /**
+     * Set the current ATR of the bar series (e.g. AverageTrueRange::value())
+     * Used by the next calculate(); 0 means unknown and disables the filter
+     */
+    void setAtr(double atr) { current_atr = atr; }
+
     /**
      * Calculate Fibonacci levels from price bars
      * @param bars Vector of OHLC bars
@@ -92,12 +121,50 @@ public:
      */
     FibonacciResults calculate(const std::vector<Bar>& bars);
 
+    /**
+     * Calculate Fibonacci levels from a columnar bar series
+     * Bar times are reported as "yyyyMMdd HH:mm:ss"
+     * @param series Bars, oldest first (e.g. a memory-mapped bar file)
+     * @return FibonacciResults structure
+     */
+    FibonacciResults calculate(const BarSeries& series);
+
+    /**
+     * Calculate Fibonacci levels from numeric bar records
+     * Bar times are reported as "yyyyMMdd HH:mm:ss"
+     * @param bars Bars, oldest first
+     * @return FibonacciResults structure
+     */
+    FibonacciResults calculate(const std::vector<BarRecord>& bars);
+
+    /**
+     * Calculate Fibonacci levels from a bar arena without copying it
+     * Bar times are reported as "yyyyMMdd HH:mm:ss"
+     * @param bars Bars, oldest first
+     * @return FibonacciResults structure
+     */
+    FibonacciResults calculate(const BarArena& bars);
+
+    /**
+     * Update the current price without recalculating the swing high/low
+     * Refreshes current_price and golden zone membership of the last results;
+     * ignored until a calculate() succeeds
+     * @param price Latest traded price
+     */
+    void updatePrice(double price);
+
     /**
      * Get trading signal based on price position
+     * HOLD while the swing is below the ATR filter
      * @return Signal string: "BUY", "SELL", "HOLD", or "NO_DATA"
      */
     std::string getSignal() const;
 
+    /**
+     * Trading signal of any results (same rules as getSignal())
+     */
+    static const char* signalFor(const FibonacciResults& results);
+
     /**
      * Print formatted Fibonacci analysis report
      */
@@ -105,12 +172,13 @@ public:
 
     /**
      * Get results as JSON string
-     * @return JSON formatted results
+     * @return Compact JSON with every result field and the signal
      */
     std::string toJSON() const;
 
     /**
      * Get the last calculated results
+     * Carries the error "No completed bars" until the first calculate()
      * @return FibonacciResults structure
      */
     const FibonacciResults& getResults() const { return results; }
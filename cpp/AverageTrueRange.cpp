@@ -0,0 +1,72 @@
+/**
+ * Average True Range Implementation
+ */
+
+#include "AverageTrueRange.h"
+#include <algorithm>
+#include <cmath>
+
+AverageTrueRange::AverageTrueRange(int atrPeriod)
+    : period(std::max(1, atrPeriod)), ranges(static_cast<size_t>(period)) {
+    reset();
+}
+
+void AverageTrueRange::reset() {
+    std::fill(ranges.begin(), ranges.end(), 0.0);
+    range_sum = 0;
+    range_sum_sq = 0;
+    bar_count = 0;
+    atr = 0;
+    previous_close = 0;
+    last_range = 0;
+}
+
+void AverageTrueRange::update(double high, double low, double close) {
+    double range = high - low;
+    if (bar_count > 0) {
+        range = std::max(range, std::max(std::fabs(high - previous_close), std::fabs(low - previous_close)));
+    }
+    previous_close = close;
+    last_range = range;
+
+    int index = static_cast<int>(bar_count % period);
+    double evicted = ranges[index];
+    ranges[index] = range;
+    ++bar_count;
+
+    // Re-add the window once per lap so rounding in the running sums cannot build up
+    if (index == period - 1) {
+        range_sum = 0;
+        range_sum_sq = 0;
+        for (double r : ranges) {
+            range_sum += r;
+            range_sum_sq += r * r;
+        }
+    } else {
+        range_sum += range - evicted;
+        range_sum_sq += range * range - evicted * evicted;
+    }
+
+    if (bar_count < period) {
+        return;
+    }
+    if (bar_count == period) {
+        atr = range_sum / period;
+    } else {
+        atr = (atr * (period - 1) + range) / period;
+    }
+}
+
+double AverageTrueRange::meanTrueRange() const {
+    int64_t n = std::min<int64_t>(bar_count, period);
+    return n > 0 ? range_sum / n : 0;
+}
+
+double AverageTrueRange::trueRangeStdDev() const {
+    int64_t n = std::min<int64_t>(bar_count, period);
+    if (n < 2) {
+        return 0;
+    }
+    double mean = range_sum / n;
+    return std::sqrt(std::max(0.0, range_sum_sq / n - mean * mean));
+}
@@ -0,0 +1,68 @@
+/**
+ * Average True Range
+ * Incremental Wilder ATR and rolling true-range statistics of a bar series
+ */
+
+#ifndef AVERAGE_TRUE_RANGE_H
+#define AVERAGE_TRUE_RANGE_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Average True Range
+ * Fed one completed bar at a time; every update is O(1) and allocation-free
+ * (the true-range ring is sized once by the period).
+ */
+class AverageTrueRange {
+private:
+    int period;
+    std::vector<double> ranges;     // Last `period` true ranges (ring)
+    double range_sum;
+    double range_sum_sq;
+    int64_t bar_count;
+
+    double atr;                     // Wilder average, seeded with the mean of the first period
+    double previous_close;
+    double last_range;
+
+public:
+    /**
+     * Constructor
+     * @param atrPeriod Bars averaged (MQL5 input ATRPeriod, default 14)
+     */
+    explicit AverageTrueRange(int atrPeriod = 14);
+
+    /**
+     * Add a completed bar
+     */
+    void update(double high, double low, double close);
+
+    /**
+     * Wilder ATR, 0 until `period` bars have been seen
+     */
+    double value() const { return ready() ? atr : 0; }
+    bool ready() const { return bar_count >= period; }
+
+    /**
+     * True range of the latest bar
+     */
+    double trueRange() const { return last_range; }
+
+    /**
+     * Simple mean of the true ranges of the last `period` bars (fewer while warming up)
+     */
+    double meanTrueRange() const;
+
+    /**
+     * Standard deviation of the true ranges of the last `period` bars
+     */
+    double trueRangeStdDev() const;
+
+    int getPeriod() const { return period; }
+    int64_t bars() const { return bar_count; }
+
+    void reset();
+};
+
+#endif // AVERAGE_TRUE_RANGE_H
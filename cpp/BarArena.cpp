@@ -0,0 +1,157 @@
+/**
+ * Bar Arena Implementation
+ */
+
+#include "BarArena.h"
+#include "BarTime.h"
+#include <algorithm>
+
+const size_t BarChunkPool::DEFAULT_CHUNK_BARS;
+
+bool toBarRecord(const Bar& bar, BarRecord& record) {
+    long t;
+    if (!parseBarTime(bar.time.c_str(), t)) {
+        return false;
+    }
+
+    record.time = t;
+    record.open = bar.open;
+    record.high = bar.high;
+    record.low = bar.low;
+    record.close = bar.close;
+    record.volume = bar.volume;
+    record.wap = bar.wap;
+    record.count = bar.count;
+    return true;
+}
+
+Bar toBar(const BarRecord& record) {
+    Bar bar;
+    toBar(record, bar);
+    return bar;
+}
+
+void toBar(const BarRecord& record, Bar& bar) {
+    char time[WALL_CLOCK_CHARS + 1];
+    bar.time.assign(time, formatWallClock(static_cast<long>(record.time), time));
+    bar.open = record.open;
+    bar.high = record.high;
+    bar.low = record.low;
+    bar.close = record.close;
+    bar.volume = record.volume;
+    bar.wap = record.wap;
+    bar.count = record.count;
+}
+
+BarChunkPool::BarChunkPool(size_t chunkBars)
+    : chunk_bars(chunkBars > 0 ? chunkBars : DEFAULT_CHUNK_BARS) {
+}
+
+std::unique_ptr<BarRecord[]> BarChunkPool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        if (!free_chunks.empty()) {
+            std::unique_ptr<BarRecord[]> chunk = std::move(free_chunks.back());
+            free_chunks.pop_back();
+            return chunk;
+        }
+    }
+    return std::unique_ptr<BarRecord[]>(new BarRecord[chunk_bars]);
+}
+
+void BarChunkPool::release(std::unique_ptr<BarRecord[]> chunk) {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    free_chunks.push_back(std::move(chunk));
+}
+
+BarArena::BarArena(BarChunkPool* chunkPool)
+    : pool(chunkPool), bar_count(0), capacity(0) {
+}
+
+BarArena::~BarArena() {
+    clear();
+}
+
+BarArena::BarArena(BarArena&& other) noexcept
+    : own_pool(std::move(other.own_pool)), pool(other.pool), chunks(std::move(other.chunks)),
+      bar_count(other.bar_count), capacity(other.capacity) {
+    if (own_pool) {
+        other.pool = nullptr;
+    }
+    other.chunks.clear();
+    other.bar_count = 0;
+    other.capacity = 0;
+}
+
+BarArena& BarArena::operator=(BarArena&& other) noexcept {
+    if (this != &other) {
+        clear();
+        own_pool = std::move(other.own_pool);
+        pool = other.pool;
+        chunks = std::move(other.chunks);
+        bar_count = other.bar_count;
+        capacity = other.capacity;
+        if (own_pool) {
+            other.pool = nullptr;
+        }
+        other.chunks.clear();
+        other.bar_count = 0;
+        other.capacity = 0;
+    }
+    return *this;
+}
+
+void BarArena::grow() {
+    if (!pool) {
+        own_pool.reset(new BarChunkPool());
+        pool = own_pool.get();
+    }
+    chunks.push_back(pool->acquire());
+    capacity += pool->chunkBars();
+}
+
+void BarArena::reserve(size_t bars) {
+    while (capacity < bars) {
+        grow();
+    }
+}
+
+void BarArena::append(const BarRecord* first, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    reserve(bar_count + count);
+
+    size_t chunk_bars = pool->chunkBars();
+    while (count > 0) {
+        size_t offset = bar_count % chunk_bars;
+        size_t n = std::min(count, chunk_bars - offset);
+        std::copy(first, first + n, chunks[bar_count / chunk_bars].get() + offset);
+        bar_count += n;
+        first += n;
+        count -= n;
+    }
+}
+
+void BarArena::appendTo(std::vector<BarRecord>& out) const {
+    out.reserve(out.size() + bar_count);
+
+    size_t remaining = bar_count;
+    for (const auto& chunk : chunks) {
+        if (remaining == 0) {
+            break;
+        }
+        size_t n = std::min(remaining, pool->chunkBars());
+        out.insert(out.end(), chunk.get(), chunk.get() + n);
+        remaining -= n;
+    }
+}
+
+void BarArena::clear() {
+    for (auto& chunk : chunks) {
+        pool->release(std::move(chunk));
+    }
+    chunks.clear();
+    bar_count = 0;
+    capacity = 0;
+}
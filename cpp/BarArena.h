@@ -0,0 +1,134 @@
+/**
+ * Bar Arena
+ * Numeric bar records appended into pooled fixed-size chunks
+ */
+
+#ifndef BAR_ARENA_H
+#define BAR_ARENA_H
+
+#include "bar.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Numeric form of an IBKR Bar; the time is parsed once on ingestion
+ */
+struct BarRecord {
+    int64_t time;       // Wall-clock seconds (see parseBarTime())
+    double open;
+    double high;
+    double low;
+    double close;
+    Decimal volume;
+    Decimal wap;
+    int count;
+};
+
+/**
+ * Convert an IBKR bar
+ * @return false if the bar time could not be parsed
+ */
+bool toBarRecord(const Bar& bar, BarRecord& record);
+
+/**
+ * Convert back to an IBKR bar (time formatted as "yyyyMMdd HH:mm:ss")
+ */
+Bar toBar(const BarRecord& record);
+
+/**
+ * Convert back into an existing IBKR bar, reusing its time string
+ */
+void toBar(const BarRecord& record, Bar& bar);
+
+/**
+ * Bar Chunk Pool
+ * Recycles arena chunks between requests; thread-safe (locked per chunk, not per bar)
+ */
+class BarChunkPool {
+private:
+    size_t chunk_bars;
+    std::vector<std::unique_ptr<BarRecord[]>> free_chunks;
+    std::mutex pool_mutex;
+
+public:
+    static const size_t DEFAULT_CHUNK_BARS = 1024;
+
+    explicit BarChunkPool(size_t chunkBars = DEFAULT_CHUNK_BARS);
+
+    size_t chunkBars() const { return chunk_bars; }
+
+    std::unique_ptr<BarRecord[]> acquire();
+    void release(std::unique_ptr<BarRecord[]> chunk);
+};
+
+/**
+ * Bar Arena
+ * Append-only; records never move once written. Not thread-safe: one writer
+ * at a time, handed to a reader only after writing finished.
+ */
+class BarArena {
+private:
+    std::unique_ptr<BarChunkPool> own_pool;     // Used when no pool is given
+    BarChunkPool* pool;
+    std::vector<std::unique_ptr<BarRecord[]>> chunks;
+    size_t bar_count;
+    size_t capacity;
+
+    void grow();
+
+public:
+    /**
+     * Constructor
+     * @param chunkPool Shared chunk pool; nullptr gives the arena a pool of its own
+     *                  (created by the first append)
+     */
+    explicit BarArena(BarChunkPool* chunkPool = nullptr);
+    ~BarArena();
+
+    BarArena(BarArena&& other) noexcept;
+    BarArena& operator=(BarArena&& other) noexcept;
+    BarArena(const BarArena&) = delete;
+    BarArena& operator=(const BarArena&) = delete;
+
+    /**
+     * Acquire enough chunks for a number of bars up front
+     */
+    void reserve(size_t bars);
+
+    void append(const BarRecord& record) {
+        if (bar_count == capacity) {
+            grow();
+        }
+        size_t chunk_bars = pool->chunkBars();
+        chunks[bar_count / chunk_bars][bar_count % chunk_bars] = record;
+        ++bar_count;
+    }
+
+    size_t size() const { return bar_count; }
+    bool empty() const { return bar_count == 0; }
+
+    const BarRecord& operator[](size_t i) const {
+        size_t chunk_bars = pool->chunkBars();
+        return chunks[i / chunk_bars][i % chunk_bars];
+    }
+
+    /**
+     * Append records of a contiguous range
+     */
+    void append(const BarRecord* first, size_t count);
+
+    /**
+     * Append all records to a contiguous vector
+     */
+    void appendTo(std::vector<BarRecord>& out) const;
+
+    /**
+     * Drop all records and return the chunks to the pool
+     */
+    void clear();
+};
+
+#endif // BAR_ARENA_H
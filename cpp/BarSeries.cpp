@@ -0,0 +1,188 @@
+/**
+ * Bar Series Implementation
+ *
+ * Both mapped files and in-memory series hold the exact file image, so
+ * writeFile() is a single write and map() only validates the header.
+ */
+
+#include "BarSeries.h"
+#include "InternalUtil.h"
+#include "BarTime.h"
+#include "Decimal.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char BAR_FILE_MAGIC[8] = {'A', 'F', 'B', 'A', 'R', 'S', 0, 0};
+static const uint32_t BAR_FILE_BYTE_ORDER = 0x01020304;
+static const uint32_t BAR_FILE_COLUMNS = 6;
+
+static_assert(sizeof(BarFileHeader) == BarSeries::COLUMN_ALIGNMENT,
+              "bar file header must keep the first column aligned");
+
+const uint32_t BarSeries::FORMAT_VERSION;
+const size_t BarSeries::COLUMN_ALIGNMENT;
+
+static uint64_t columnStride(uint64_t count) {
+    uint64_t bytes = count * sizeof(double);
+    return (bytes + BarSeries::COLUMN_ALIGNMENT - 1) & ~static_cast<uint64_t>(BarSeries::COLUMN_ALIGNMENT - 1);
+}
+
+BarSeries::BarSeries()
+    : time_col(nullptr), open_col(nullptr), high_col(nullptr), low_col(nullptr),
+      close_col(nullptr), volume_col(nullptr), bar_count(0) {
+}
+
+bool BarSeries::attach(std::shared_ptr<const void> block, size_t bytes, std::string* error) {
+    if (bytes < sizeof(BarFileHeader)) {
+        setError(error, "File too small");
+        return false;
+    }
+
+    const char* base = static_cast<const char*>(block.get());
+    const BarFileHeader* header = reinterpret_cast<const BarFileHeader*>(base);
+
+    if (std::memcmp(header->magic, BAR_FILE_MAGIC, sizeof(BAR_FILE_MAGIC)) != 0) {
+        setError(error, "Not a bar file");
+        return false;
+    }
+    if (header->byte_order != BAR_FILE_BYTE_ORDER) {
+        setError(error, "Bar file byte order does not match this machine");
+        return false;
+    }
+    if (header->version != FORMAT_VERSION) {
+        setError(error, "Unsupported bar file version " + std::to_string(header->version));
+        return false;
+    }
+    if (header->header_size != sizeof(BarFileHeader) || header->column_count != BAR_FILE_COLUMNS ||
+        header->column_stride != columnStride(header->count) ||
+        header->count > (bytes - sizeof(BarFileHeader)) / BAR_FILE_COLUMNS / sizeof(double) ||
+        sizeof(BarFileHeader) + BAR_FILE_COLUMNS * header->column_stride > bytes) {
+        setError(error, "Corrupt bar file header");
+        return false;
+    }
+
+    const char* columns = base + header->header_size;
+    size_t stride = static_cast<size_t>(header->column_stride);
+
+    storage = std::move(block);
+    bar_count = static_cast<size_t>(header->count);
+    time_col = reinterpret_cast<const int64_t*>(columns);
+    open_col = reinterpret_cast<const double*>(columns + stride);
+    high_col = reinterpret_cast<const double*>(columns + 2 * stride);
+    low_col = reinterpret_cast<const double*>(columns + 3 * stride);
+    close_col = reinterpret_cast<const double*>(columns + 4 * stride);
+    volume_col = reinterpret_cast<const double*>(columns + 5 * stride);
+    return true;
+}
+
+BarSeries BarSeries::map(const std::string& path, std::string* error) {
+    BarSeries series;
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        setError(error, "Cannot open " + path);
+        return series;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        setError(error, "Cannot stat " + path);
+        return series;
+    }
+
+    size_t bytes = static_cast<size_t>(st.st_size);
+    void* addr = mapAndClose(fd, bytes, PROT_READ, MAP_PRIVATE);
+    if (addr == MAP_FAILED) {
+        setError(error, "Cannot map " + path);
+        return series;
+    }
+
+    ::madvise(addr, bytes, MADV_WILLNEED);
+
+    std::shared_ptr<const void> mapping(addr, [bytes](const void* p) {
+        ::munmap(const_cast<void*>(p), bytes);
+    });
+    series.attach(std::move(mapping), bytes, error);
+    return series;
+}
+
+BarSeries BarSeries::fromBars(const std::vector<Bar>& bars) {
+    uint64_t count = bars.size();
+    uint64_t stride = columnStride(count);
+    size_t bytes = sizeof(BarFileHeader) + BAR_FILE_COLUMNS * stride;
+
+    // One zeroed, aligned block holding the file image (padding included)
+    void* raw = nullptr;
+    if (::posix_memalign(&raw, COLUMN_ALIGNMENT, bytes) != 0) {
+        return BarSeries();
+    }
+    std::memset(raw, 0, bytes);
+    std::shared_ptr<const void> block(raw, [](const void* p) { std::free(const_cast<void*>(p)); });
+
+    char* base = static_cast<char*>(raw);
+    BarFileHeader* header = reinterpret_cast<BarFileHeader*>(base);
+    std::memcpy(header->magic, BAR_FILE_MAGIC, sizeof(BAR_FILE_MAGIC));
+    header->version = FORMAT_VERSION;
+    header->byte_order = BAR_FILE_BYTE_ORDER;
+    header->count = count;
+    header->column_stride = stride;
+    header->column_count = BAR_FILE_COLUMNS;
+    header->header_size = sizeof(BarFileHeader);
+
+    char* columns = base + sizeof(BarFileHeader);
+    int64_t* time_out = reinterpret_cast<int64_t*>(columns);
+    double* open_out = reinterpret_cast<double*>(columns + stride);
+    double* high_out = reinterpret_cast<double*>(columns + 2 * stride);
+    double* low_out = reinterpret_cast<double*>(columns + 3 * stride);
+    double* close_out = reinterpret_cast<double*>(columns + 4 * stride);
+    double* volume_out = reinterpret_cast<double*>(columns + 5 * stride);
+
+    for (size_t i = 0; i < bars.size(); ++i) {
+        const Bar& bar = bars[i];
+        long t = 0;
+        parseBarTime(bar.time, t);
+        time_out[i] = t;
+        open_out[i] = bar.open;
+        high_out[i] = bar.high;
+        low_out[i] = bar.low;
+        close_out[i] = bar.close;
+        volume_out[i] = DecimalFunctions::decimalToDouble(bar.volume);
+    }
+
+    BarSeries series;
+    series.attach(std::move(block), bytes, nullptr);
+    return series;
+}
+
+bool BarSeries::writeFile(const std::string& path, std::string* error) const {
+    if (!storage) {
+        setError(error, "Empty series");
+        return false;
+    }
+
+    const BarFileHeader* header = static_cast<const BarFileHeader*>(storage.get());
+    size_t bytes = header->header_size + BAR_FILE_COLUMNS * static_cast<size_t>(header->column_stride);
+
+    // Write to a temporary file and rename, so readers never map a torn file
+    std::string tmp_path = path + ".tmp";
+    std::FILE* out = std::fopen(tmp_path.c_str(), "wb");
+    if (!out) {
+        setError(error, "Cannot create " + tmp_path);
+        return false;
+    }
+
+    bool ok = std::fwrite(storage.get(), 1, bytes, out) == bytes;
+    ok = std::fclose(out) == 0 && ok;
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        setError(error, "Cannot write " + path);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,103 @@
+/**
+ * Bar Series
+ * Read-only columnar view of OHLCV bars, backed by a memory-mapped bar file
+ *
+ * Bar file layout (little-endian, every column starts on a 64-byte boundary):
+ *
+ *   BarFileHeader                 64 bytes
+ *   int64  time[count]            wall-clock seconds (see parseBarTime())
+ *   double open[count]
+ *   double high[count]
+ *   double low[count]
+ *   double close[count]
+ *   double volume[count]
+ *
+ * Each column occupies column_stride bytes (count * 8 rounded up to 64).
+ */
+
+#ifndef BAR_SERIES_H
+#define BAR_SERIES_H
+
+#include "bar.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * On-disk header of a bar file
+ */
+struct BarFileHeader {
+    char magic[8];              // "AFBARS\0\0"
+    uint32_t version;           // BarSeries::FORMAT_VERSION
+    uint32_t byte_order;        // 0x01020304 as written by the producer
+    uint64_t count;             // Number of bars
+    uint64_t column_stride;     // Bytes per column
+    uint32_t column_count;      // Columns present (6 in version 1)
+    uint32_t header_size;       // sizeof(BarFileHeader); columns start here
+    uint8_t reserved[24];
+};
+
+/**
+ * Bar Series
+ * Cheap to copy; copies share the underlying mapping or buffer
+ */
+class BarSeries {
+private:
+    std::shared_ptr<const void> storage;    // Keeps the mapping / buffer alive
+    const int64_t* time_col;
+    const double* open_col;
+    const double* high_col;
+    const double* low_col;
+    const double* close_col;
+    const double* volume_col;
+    size_t bar_count;
+
+    bool attach(std::shared_ptr<const void> block, size_t bytes, std::string* error);
+
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+    static const size_t COLUMN_ALIGNMENT = 64;
+
+    BarSeries();
+
+    /**
+     * Map a bar file read-only; no data is copied or parsed
+     * @param path Bar file
+     * @param error Receives the reason on failure (optional)
+     * @return Series, empty on failure
+     */
+    static BarSeries map(const std::string& path, std::string* error = nullptr);
+
+    /**
+     * Build an in-memory series (same layout as the file) from IBKR bars
+     */
+    static BarSeries fromBars(const std::vector<Bar>& bars);
+
+    /**
+     * Write the series as a bar file
+     * @return false if the file could not be written
+     */
+    bool writeFile(const std::string& path, std::string* error = nullptr) const;
+
+    size_t size() const { return bar_count; }
+    bool empty() const { return bar_count == 0; }
+
+    int64_t time(size_t i) const { return time_col[i]; }
+    double open(size_t i) const { return open_col[i]; }
+    double high(size_t i) const { return high_col[i]; }
+    double low(size_t i) const { return low_col[i]; }
+    double close(size_t i) const { return close_col[i]; }
+    double volume(size_t i) const { return volume_col[i]; }
+
+    // Raw columns for vectorised consumers
+    const int64_t* times() const { return time_col; }
+    const double* opens() const { return open_col; }
+    const double* highs() const { return high_col; }
+    const double* lows() const { return low_col; }
+    const double* closes() const { return close_col; }
+    const double* volumes() const { return volume_col; }
+};
+
+#endif // BAR_SERIES_H
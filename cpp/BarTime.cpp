@@ -0,0 +1,276 @@
+/**
+ * Bar Time Helpers Implementation
+ */
+
+#include "BarTime.h"
+#include <cstdlib>
+#include <ctime>
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+static long daysFromCivil(long y, long m, long d) {
+    y -= m <= 2 ? 1 : 0;
+    long era = (y >= 0 ? y : y - 399) / 400;
+    long yoe = y - era * 400;
+    long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// Proleptic Gregorian date of a day count since 1970-01-01
+static void civilFromDays(long z, long& y, long& m, long& d) {
+    z += 719468;
+    long era = (z >= 0 ? z : z - 146096) / 146097;
+    long doe = z - era * 146097;
+    long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = yoe + era * 400 + (m <= 2 ? 1 : 0);
+}
+
+static long localOffset(long epoch) {
+    std::time_t t = static_cast<std::time_t>(epoch);
+    std::tm tm_buf;
+    localtime_r(&t, &tm_buf);
+    return tm_buf.tm_gmtoff;
+}
+
+// UTC offset of an epoch time. localtime_r takes a lock and may check the
+// zone file, so the offset of the last UTC day without a DST change is
+// remembered per thread; epoch bars arrive in time order.
+static long utcOffset(long epoch) {
+    thread_local long cached_day = -1;
+    thread_local long cached_offset = 0;
+
+    long day = epoch / 86400;
+    if (day == cached_day) {
+        return cached_offset;
+    }
+
+    long first = localOffset(day * 86400);
+    if (localOffset(day * 86400 + 86399) != first) {
+        return localOffset(epoch);
+    }
+    cached_day = day;
+    cached_offset = first;
+    return first;
+}
+
+int barSizeToSeconds(const std::string& barSize) {
+    char* unit = nullptr;
+    long count = std::strtol(barSize.c_str(), &unit, 10);
+    if (count <= 0 || unit == barSize.c_str()) {
+        return 0;
+    }
+
+    while (*unit == ' ') {
+        ++unit;
+    }
+
+    // Units may be singular or plural ("1 min" / "5 mins")
+    std::string u(unit);
+    long scale = 0;
+    if (u.compare(0, 3, "sec") == 0) {
+        scale = 1;
+    } else if (u.compare(0, 3, "min") == 0) {
+        scale = 60;
+    } else if (u.compare(0, 4, "hour") == 0) {
+        scale = 3600;
+    } else if (u.compare(0, 3, "day") == 0) {
+        scale = 86400;
+    } else if (u.compare(0, 4, "week") == 0) {
+        scale = 7 * 86400;
+    } else if (u.compare(0, 5, "month") == 0) {
+        scale = 30 * 86400;
+    }
+
+    return static_cast<int>(count * scale);
+}
+
+long durationToSeconds(const std::string& duration) {
+    char* unit = nullptr;
+    long count = std::strtol(duration.c_str(), &unit, 10);
+    if (count <= 0 || unit == duration.c_str()) {
+        return 0;
+    }
+
+    while (*unit == ' ') {
+        ++unit;
+    }
+
+    switch (*unit) {
+        case 'S': return count;
+        case 'D': return count * 86400;
+        case 'W': return count * 7 * 86400;
+        case 'M': return count * 30 * 86400;
+        case 'Y': return count * 365 * 86400;
+        default:  return 0;
+    }
+}
+
+std::string secondsToDuration(long seconds, bool wholeDays) {
+    if (seconds < 1) {
+        seconds = 1;
+    }
+    if (seconds <= 86400 && !wholeDays) {
+        return std::to_string(seconds) + " S";
+    }
+    return std::to_string((seconds + 86399) / 86400) + " D";
+}
+
+size_t expectedBarCount(const std::string& duration, const std::string& barSize, bool regularHoursOnly) {
+    long span = durationToSeconds(duration);
+    long bar = barSizeToSeconds(barSize);
+    if (span <= 0 || bar <= 0) {
+        return 0;
+    }
+
+    const long session = regularHoursOnly ? 23400 : 86400;
+
+    if (bar >= 86400) {
+        return static_cast<size_t>(span * 5 / 7 / bar + 1);
+    }
+    if (span <= 86400) {
+        return static_cast<size_t>((span < session ? span : session) / bar + 1);
+    }
+
+    long trading_days = span / 86400 * 5 / 7 + 1;
+    return static_cast<size_t>(trading_days * (session / bar + 1));
+}
+
+// Parse exactly n digits; advances p on success
+static bool parseDigits(const char*& p, int n, long& value) {
+    long v = 0;
+    for (int i = 0; i < n; ++i) {
+        unsigned d = static_cast<unsigned>(p[i] - '0');
+        if (d > 9) {
+            return false;
+        }
+        v = v * 10 + d;
+    }
+    p += n;
+    value = v;
+    return true;
+}
+
+// Parse one or two digits followed by an optional separator; advances p on success
+static bool parseField(const char*& p, char separator, long& value) {
+    unsigned d = static_cast<unsigned>(*p - '0');
+    if (d > 9) {
+        return false;
+    }
+    long v = d;
+    ++p;
+    d = static_cast<unsigned>(*p - '0');
+    if (d <= 9) {
+        v = v * 10 + d;
+        ++p;
+    }
+    if (separator) {
+        if (*p != separator) {
+            return false;
+        }
+        ++p;
+    }
+    value = v;
+    return true;
+}
+
+bool parseBarTime(const char* p, long& seconds) {
+    size_t digits = 0;
+    while (static_cast<unsigned>(p[digits] - '0') <= 9) {
+        ++digits;
+    }
+
+    // Epoch seconds (formatDate = 2), shifted onto the local wall clock
+    if (digits > 8) {
+        long epoch = 0;
+        for (size_t i = 0; i < digits; ++i) {
+            epoch = epoch * 10 + (p[i] - '0');
+        }
+        seconds = epoch + utcOffset(epoch);
+        return true;
+    }
+    if (digits != 8) {
+        return false;
+    }
+
+    long y = 0, mo = 0, d = 0;
+    parseDigits(p, 4, y);
+    parseDigits(p, 2, mo);
+    parseDigits(p, 2, d);
+    if (mo < 1 || mo > 12 || d < 1 || d > 31) {
+        return false;
+    }
+
+    long h = 0, mi = 0, sec = 0;
+    while (*p == ' ') {
+        ++p;
+    }
+    if (*p && (!parseField(p, ':', h) || !parseField(p, ':', mi) || !parseField(p, 0, sec))) {
+        return false;
+    }
+
+    seconds = daysFromCivil(y, mo, d) * 86400L + h * 3600L + mi * 60L + sec;
+    return true;
+}
+
+bool parseBarTime(const std::string& time, long& seconds) {
+    return parseBarTime(time.c_str(), seconds);
+}
+
+long wallClockNow() {
+    std::time_t now = std::time(nullptr);
+    std::tm tm_buf;
+    localtime_r(&now, &tm_buf);
+    return static_cast<long>(now) + tm_buf.tm_gmtoff;
+}
+
+std::string formatBarTime(long epochSeconds) {
+    std::time_t t = static_cast<std::time_t>(epochSeconds);
+    std::tm tm_buf;
+    localtime_r(&t, &tm_buf);
+
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y%m%d %H:%M:%S", &tm_buf);
+    return std::string(buf);
+}
+
+// Write n digits of value, most significant first
+static char* putDigits(char* out, long value, int n) {
+    for (int i = n - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return out + n;
+}
+
+size_t formatWallClock(long wallSeconds, char* out) {
+    long days = wallSeconds / 86400;
+    long secs = wallSeconds % 86400;
+    if (secs < 0) {
+        secs += 86400;
+        --days;
+    }
+
+    long y, m, d;
+    civilFromDays(days, y, m, d);
+
+    char* p = putDigits(out, y, 4);
+    p = putDigits(p, m, 2);
+    p = putDigits(p, d, 2);
+    *p++ = ' ';
+    p = putDigits(p, secs / 3600, 2);
+    *p++ = ':';
+    p = putDigits(p, secs / 60 % 60, 2);
+    *p++ = ':';
+    p = putDigits(p, secs % 60, 2);
+    *p = '\0';
+    return static_cast<size_t>(p - out);
+}
+
+std::string formatWallClock(long wallSeconds) {
+    char buf[WALL_CLOCK_CHARS + 1];
+    return std::string(buf, formatWallClock(wallSeconds, buf));
+}
@@ -0,0 +1,86 @@
+/**
+ * Bar Time Helpers
+ * Conversions between IBKR bar size settings, epoch seconds and bar time strings
+ */
+
+#ifndef BAR_TIME_H
+#define BAR_TIME_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Convert an IBKR bar size setting to seconds
+ * @param barSize Bar size setting, e.g. "5 secs", "1 min", "5 mins", "1 hour", "1 day"
+ * @return Bar length in seconds, or 0 if the setting is not recognised
+ */
+int barSizeToSeconds(const std::string& barSize);
+
+/**
+ * Convert an IBKR duration string to seconds
+ * @param duration Duration, e.g. "3600 S", "1 D", "2 W", "1 M", "1 Y"
+ * @return Duration in seconds (D = 1 day, W = 7, M = 30, Y = 365), or 0 if not recognised
+ */
+long durationToSeconds(const std::string& duration);
+
+/**
+ * Build the shortest IBKR duration string covering a number of seconds
+ * @param seconds Span to cover
+ * @param wholeDays Always use days (required for bar sizes of one day or more)
+ * @return "N S" up to one day, "N D" beyond
+ */
+std::string secondsToDuration(long seconds, bool wholeDays = false);
+
+/**
+ * Estimate how many bars a historical request returns, for pre-sizing buffers
+ * @param duration Duration string (see durationToSeconds())
+ * @param barSize Bar size setting (see barSizeToSeconds())
+ * @param regularHoursOnly useRTH = 1 (6.5 trading hours per day)
+ * @return Expected bar count (weekends excluded), or 0 if either setting is not recognised
+ */
+size_t expectedBarCount(const std::string& duration, const std::string& barSize, bool regularHoursOnly);
+
+/**
+ * Parse an IBKR bar time into wall-clock seconds
+ * Accepts "yyyyMMdd HH:mm:ss" (any number of spaces, optional time zone suffix),
+ * "yyyyMMdd" for daily bars, and epoch seconds (formatDate = 2). Wall-clock
+ * seconds count the printed date/time as if it were UTC, so they only compare
+ * with other parsed times and wallClockNow().
+ * @param time Bar time string
+ * @param seconds Receives the parsed time
+ * @return true on success
+ */
+bool parseBarTime(const std::string& time, long& seconds);
+bool parseBarTime(const char* time, long& seconds);
+
+/**
+ * Current local wall-clock time on the same scale as parseBarTime()
+ */
+long wallClockNow();
+
+/**
+ * Format epoch seconds the way IBKR reports bar times (formatDate = 1)
+ * @param epochSeconds Seconds since the Unix epoch
+ * @return Local time string "yyyyMMdd HH:mm:ss"
+ */
+std::string formatBarTime(long epochSeconds);
+
+/**
+ * Format wall-clock seconds (see parseBarTime()) back into a bar time string
+ * @param wallSeconds Wall-clock seconds
+ * @return "yyyyMMdd HH:mm:ss"
+ */
+std::string formatWallClock(long wallSeconds);
+
+/** Length of a formatWallClock() string */
+const size_t WALL_CLOCK_CHARS = 17;
+
+/**
+ * Format wall-clock seconds into a caller buffer, without allocating
+ * @param wallSeconds Wall-clock seconds (years 0 to 9999)
+ * @param out Receives "yyyyMMdd HH:mm:ss" and a terminating NUL (WALL_CLOCK_CHARS + 1 bytes)
+ * @return Characters written, excluding the NUL
+ */
+size_t formatWallClock(long wallSeconds, char* out);
+
+#endif // BAR_TIME_H
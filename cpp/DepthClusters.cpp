@@ -0,0 +1,61 @@
+/**
+ * Depth Clusters Implementation
+ */
+
+#include "DepthClusters.h"
+#include <algorithm>
+#include <cmath>
+
+void detectClusters(const double* prices, const double* sizes, int count,
+                    const ClusterConfig& config, std::vector<double>& clusters) {
+    clusters.clear();
+    if (count <= 0) {
+        return;
+    }
+
+    double window = std::max(config.window, config.tick_size * 5);
+
+    double side_total = 0;
+    for (int i = 0; i < count; ++i) {
+        side_total += sizes[i];
+    }
+    double avg_volume = side_total / count;
+
+    // Levels [lo, hi) are within the window of level i; both ends only move forward
+    int lo = 0, hi = 0;
+    double sum = 0, sum_sq = 0;
+
+    for (int i = 0; i < count; ++i) {
+        double center = prices[i];
+
+        while (hi < count && std::fabs(prices[hi] - center) <= window) {
+            sum += sizes[hi];
+            sum_sq += sizes[hi] * sizes[hi];
+            ++hi;
+        }
+        while (std::fabs(prices[lo] - center) > window) {
+            sum -= sizes[lo];
+            sum_sq -= sizes[lo] * sizes[lo];
+            ++lo;
+        }
+
+        int n = hi - lo;
+        bool cluster;
+        if (n >= 2) {
+            double average = sum / n;
+            double variance = std::max(0.0, (sum_sq - sum * average) / (n - 1));
+            cluster = sizes[i] > average + config.std_dev_threshold * std::sqrt(variance) / 2.0;
+        } else {
+            cluster = sizes[i] > avg_volume * 2.0;
+        }
+
+        if (cluster) {
+            clusters.push_back(center);
+        }
+    }
+}
+
+void detectClusters(const OrderBook& book, int side, const ClusterConfig& config,
+                    std::vector<double>& clusters) {
+    detectClusters(book.prices(side), book.sizes(side), book.levels(side), config, clusters);
+}
@@ -0,0 +1,47 @@
+/**
+ * Depth Clusters
+ * Order-book cluster detection (port of DetectClusters in MarketDepthIndicator_Fixed.mq5)
+ */
+
+#ifndef DEPTH_CLUSTERS_H
+#define DEPTH_CLUSTERS_H
+
+#include "OrderBook.h"
+#include <vector>
+
+/**
+ * Cluster detection parameters (MQL5 inputs ClusterWindow / ClusterStdDevThreshold)
+ */
+struct ClusterConfig {
+    double window;              // Price distance around a level
+    double std_dev_threshold;   // Std devs above the local mean, halved as in MQL5
+    double tick_size;           // The window is at least 5 ticks
+
+    ClusterConfig() : window(0.005), std_dev_threshold(1.0), tick_size(0.01) {}
+};
+
+/**
+ * Find levels whose size stands out from the levels within the window around them
+ * A level is a cluster if its size exceeds mean + threshold * stddev / 2 of the
+ * levels within the window (itself included), or, when it has no neighbours in
+ * the window, twice the average size of the side.
+ *
+ * Runs in O(n) over price-ordered levels with a two-pointer window and running
+ * sum / sum of squares.
+ *
+ * @param prices Level prices, monotonic (book order: bids descending, asks ascending)
+ * @param sizes Level sizes
+ * @param count Number of levels
+ * @param config Detection parameters
+ * @param clusters Receives the cluster prices in level order (cleared first)
+ */
+void detectClusters(const double* prices, const double* sizes, int count,
+                    const ClusterConfig& config, std::vector<double>& clusters);
+
+/**
+ * Detect clusters on one side of an order book
+ */
+void detectClusters(const OrderBook& book, int side, const ClusterConfig& config,
+                    std::vector<double>& clusters);
+
+#endif // DEPTH_CLUSTERS_H
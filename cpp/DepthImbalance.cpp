@@ -0,0 +1,51 @@
+/**
+ * Depth Imbalance Implementation
+ */
+
+#include "DepthImbalance.h"
+#include <algorithm>
+
+void computeImbalance(const OrderBook& book, double range, const ImbalanceConfig& config,
+                      DepthImbalance& result) {
+    result = DepthImbalance();
+
+    double best_bid = book.bestBid();
+    double best_ask = book.bestAsk();
+    double midpoint = (best_bid + best_ask) / 2;
+    range = std::max(range, config.min_range);
+
+    // Volume imbalance around the midpoint
+    result.buy_volume_in_range = book.sizeWithin(BOOK_SIDE_BID, midpoint - range);
+    result.sell_volume_in_range = book.sizeWithin(BOOK_SIDE_ASK, midpoint + range);
+    result.ratio = result.sell_volume_in_range > 0
+                   ? result.buy_volume_in_range / result.sell_volume_in_range : 0;
+    result.prediction = result.ratio > config.upper_threshold ? PREDICTION_UP :
+                        result.ratio < config.lower_threshold ? PREDICTION_DOWN : PREDICTION_NEUTRAL;
+
+    // Depth scores next to the touch
+    result.bid_depth = book.sizeWithin(BOOK_SIDE_BID, best_bid - config.depth_range);
+    result.ask_depth = book.sizeWithin(BOOK_SIDE_ASK, best_ask + config.depth_range);
+
+    double buy_total = book.totalSize(BOOK_SIDE_BID);
+    double sell_total = book.totalSize(BOOK_SIDE_ASK);
+    result.imbalance_percent = buy_total > 0 ? sell_total / buy_total * 100.0 : 0.0;
+    result.pressure = result.imbalance_percent > config.threshold_percent ? PRESSURE_STRONG_SELL :
+                      result.imbalance_percent < 100.0 / (config.threshold_percent / 100.0) ? PRESSURE_STRONG_BUY :
+                      PRESSURE_BALANCED;
+}
+
+const char* predictionName(int prediction) {
+    switch (prediction) {
+        case PREDICTION_UP: return "Up";
+        case PREDICTION_DOWN: return "Down";
+        default: return "Neutral";
+    }
+}
+
+const char* pressureName(int pressure) {
+    switch (pressure) {
+        case PRESSURE_STRONG_BUY: return "Strong Buy Pressure";
+        case PRESSURE_STRONG_SELL: return "Strong Sell Pressure";
+        default: return "Balanced";
+    }
+}
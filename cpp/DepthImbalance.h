@@ -0,0 +1,79 @@
+/**
+ * Depth Imbalance
+ * Volume imbalance and depth scores of an order book
+ * (port of the imbalance / depth logic in OnBookEvent of MarketDepthIndicator_Fixed.mq5)
+ */
+
+#ifndef DEPTH_IMBALANCE_H
+#define DEPTH_IMBALANCE_H
+
+#include "OrderBook.h"
+
+enum DepthPrediction {
+    PREDICTION_DOWN = -1,
+    PREDICTION_NEUTRAL = 0,
+    PREDICTION_UP = 1
+};
+
+enum DepthPressure {
+    PRESSURE_STRONG_BUY = -1,
+    PRESSURE_BALANCED = 0,
+    PRESSURE_STRONG_SELL = 1
+};
+
+/**
+ * Imbalance parameters (MQL5 "Volume Imbalance" / "Depth & Range" inputs)
+ */
+struct ImbalanceConfig {
+    double upper_threshold;     // Buy/sell ratio above which the prediction is Up
+    double lower_threshold;     // Buy/sell ratio below which the prediction is Down
+    double threshold_percent;   // Sell/buy percentage marking strong pressure
+    double depth_range;         // Price distance from the best level for depth scores
+    double min_range;           // Smallest imbalance window around the midpoint
+    double atr_factor;          // Imbalance window = max(ATR * atr_factor, min_range)
+
+    ImbalanceConfig() : upper_threshold(1.5), lower_threshold(0.67), threshold_percent(150.0),
+                        depth_range(0.001), min_range(0.10), atr_factor(0.5) {}
+};
+
+/**
+ * Imbalance of one book
+ */
+struct DepthImbalance {
+    double buy_volume_in_range;     // Bid size within range of the midpoint
+    double sell_volume_in_range;    // Ask size within range of the midpoint
+    double ratio;                   // buy / sell in range, 0 if no sell volume
+    int prediction;                 // DepthPrediction
+    double bid_depth;               // Bid size within depth_range of the best bid
+    double ask_depth;               // Ask size within depth_range of the best ask
+    double imbalance_percent;       // Total sell size / total buy size * 100
+    int pressure;                   // DepthPressure
+
+    DepthImbalance() : buy_volume_in_range(0), sell_volume_in_range(0), ratio(0),
+                       prediction(PREDICTION_NEUTRAL), bid_depth(0), ask_depth(0),
+                       imbalance_percent(0), pressure(PRESSURE_BALANCED) {}
+};
+
+/**
+ * Compute imbalance and depth scores
+ * Uses the book's prefix sums, so the cost is a few binary searches over the
+ * levels instead of passes over the whole book.
+ * @param book Order book
+ * @param range Imbalance window around the midpoint (at least config.min_range is used)
+ * @param config Thresholds
+ * @param result Receives the imbalance
+ */
+void computeImbalance(const OrderBook& book, double range, const ImbalanceConfig& config,
+                      DepthImbalance& result);
+
+/**
+ * Display name of a prediction: "Up", "Down" or "Neutral"
+ */
+const char* predictionName(int prediction);
+
+/**
+ * Display name of a pressure: "Strong Buy Pressure", "Strong Sell Pressure" or "Balanced"
+ */
+const char* pressureName(int pressure);
+
+#endif // DEPTH_IMBALANCE_H
@@ -0,0 +1,141 @@
+/**
+ * Depth Scorer Implementation
+ */
+
+#include "DepthScorer.h"
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+double* weightField(ScorerWeights& weights, const std::string& key) {
+    if (key == "MLRangeMultiplier") return &weights.range_multiplier;
+    if (key == "MLBuyVolumeWeight") return &weights.buy_volume;
+    if (key == "MLSellVolumeWeight") return &weights.sell_volume;
+    if (key == "MLSpreadWeight") return &weights.spread;
+    if (key == "MLVelocityWeight") return &weights.velocity;
+    if (key == "MLDepthWeight") return &weights.depth;
+    if (key == "MLNeutralThreshold") return &weights.neutral_threshold;
+    return nullptr;
+}
+
+}
+
+bool loadScorerWeights(const std::string& path, ScorerWeights& weights, std::string* error) {
+    std::ifstream infile(path);
+    if (!infile.is_open()) {
+        if (error) *error = "Cannot open " + path;
+        return false;
+    }
+
+    ScorerWeights loaded = weights;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(infile, line)) {
+        ++line_number;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        std::string key = trim(line.substr(0, equals));
+        double* field = equals == std::string::npos ? nullptr : weightField(loaded, key);
+        if (!field) {
+            if (error) *error = path + ":" + std::to_string(line_number) + ": unknown setting '" + key + "'";
+            return false;
+        }
+
+        std::string value = trim(line.substr(equals + 1));
+        char* end = nullptr;
+        errno = 0;
+        double number = std::strtod(value.c_str(), &end);
+        if (value.empty() || *end != '\0' || errno == ERANGE || !std::isfinite(number)) {
+            if (error) *error = path + ":" + std::to_string(line_number) + ": bad value for " + key;
+            return false;
+        }
+        *field = number;
+    }
+
+    weights = loaded;
+    return true;
+}
+
+DepthScorer::DepthScorer(const ScorerWeights& scorerWeights)
+    : weights(scorerWeights) {
+}
+
+int DepthScorer::addSlot() {
+    norm_buy.push_back(0);
+    norm_sell.push_back(0);
+    spreads.push_back(0);
+    velocities.push_back(0);
+    depth_ratios.push_back(0);
+    scores.push_back(0);
+    predictions.push_back(PREDICTION_NEUTRAL);
+    return static_cast<int>(scores.size()) - 1;
+}
+
+void DepthScorer::setFeatures(int slot, const OrderBook& book, double range, const DepthImbalance& imbalance,
+                              double velocity) {
+    double midpoint = (book.bestBid() + book.bestAsk()) / 2;
+    double ml_range = range * weights.range_multiplier;
+    double buy_volume = book.sizeWithin(BOOK_SIDE_BID, midpoint - ml_range);
+    double sell_volume = book.sizeWithin(BOOK_SIDE_ASK, midpoint + ml_range);
+    double total_volume = buy_volume + sell_volume;
+    double total_depth = imbalance.bid_depth + imbalance.ask_depth;
+
+    norm_buy[slot] = total_volume > 0 ? buy_volume / total_volume : 0;
+    norm_sell[slot] = total_volume > 0 ? sell_volume / total_volume : 0;
+    spreads[slot] = book.spread();
+    velocities[slot] = velocity;
+    depth_ratios[slot] = total_depth > 0 ? (imbalance.bid_depth - imbalance.ask_depth) / total_depth : 0;
+}
+
+void DepthScorer::clear(int slot) {
+    norm_buy[slot] = 0;
+    norm_sell[slot] = 0;
+    spreads[slot] = 0;
+    velocities[slot] = 0;
+    depth_ratios[slot] = 0;
+    scores[slot] = 0;
+    predictions[slot] = PREDICTION_NEUTRAL;
+}
+
+void DepthScorer::scoreAll() {
+    const size_t n = scores.size();
+    const double* __restrict buy = norm_buy.data();
+    const double* __restrict sell = norm_sell.data();
+    const double* __restrict spread = spreads.data();
+    const double* __restrict velocity = velocities.data();
+    const double* __restrict depth = depth_ratios.data();
+    double* __restrict score = scores.data();
+    int* __restrict prediction = predictions.data();
+
+    const double w_buy = weights.buy_volume;
+    const double w_sell = weights.sell_volume;
+    const double w_spread = weights.spread;
+    const double w_velocity = weights.velocity;
+    const double w_depth = weights.depth;
+    const double neutral = weights.neutral_threshold;
+
+    // Plain multiply-adds over contiguous columns, vectorised in Release builds
+    for (size_t i = 0; i < n; ++i) {
+        score[i] = buy[i] * w_buy + sell[i] * w_sell + spread[i] * w_spread +
+                   velocity[i] * w_velocity + depth[i] * w_depth;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        prediction[i] = (score[i] >= neutral) - (score[i] <= -neutral);
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ * Depth Scorer
+ * Linear "ML prediction" score of every depth symbol
+ * (port of the ML prediction in OnBookEvent of MarketDepthIndicator_Fixed.mq5)
+ */
+
+#ifndef DEPTH_SCORER_H
+#define DEPTH_SCORER_H
+
+#include "OrderBook.h"
+#include "DepthImbalance.h"
+#include <string>
+#include <vector>
+
+/**
+ * Score weights (MQL5 "ML Prediction" inputs)
+ */
+struct ScorerWeights {
+    double range_multiplier;    // ML window = imbalance range * multiplier
+    double buy_volume;          // Weight of the bid share of volume in the window
+    double sell_volume;         // Weight of the ask share of volume in the window
+    double spread;
+    double velocity;
+    double depth;               // Weight of (bid_depth - ask_depth) / total depth
+    double neutral_threshold;   // |score| below this is Neutral
+
+    ScorerWeights() : range_multiplier(2.0), buy_volume(0.4), sell_volume(-0.4), spread(1000.0),
+                      velocity(0.1), depth(0.2), neutral_threshold(0.1) {}
+};
+
+/**
+ * Load weights from a text file
+ * One "key = value" per line; '#' starts a comment. Keys are the MQL5 input
+ * names (MLRangeMultiplier, MLBuyVolumeWeight, MLSellVolumeWeight,
+ * MLSpreadWeight, MLVelocityWeight, MLDepthWeight, MLNeutralThreshold);
+ * keys not in the file keep their current value.
+ * @param path Weight file
+ * @param weights Updated in place, unchanged on failure
+ * @param error Receives the reason on failure (optional)
+ * @return false if the file cannot be read or has an unknown key or bad value
+ */
+bool loadScorerWeights(const std::string& path, ScorerWeights& weights, std::string* error = nullptr);
+
+/**
+ * Depth Scorer
+ * Features of all symbols are kept column by column (one array per feature,
+ * indexed by depth slot), so scoreAll() is a single branch-free pass the
+ * compiler turns into SIMD code.
+ */
+class DepthScorer {
+private:
+    ScorerWeights weights;
+    std::vector<double> norm_buy;
+    std::vector<double> norm_sell;
+    std::vector<double> spreads;
+    std::vector<double> velocities;
+    std::vector<double> depth_ratios;
+    std::vector<double> scores;
+    std::vector<int> predictions;
+
+public:
+    explicit DepthScorer(const ScorerWeights& scorerWeights = ScorerWeights());
+
+    void setWeights(const ScorerWeights& scorerWeights) { weights = scorerWeights; }
+    const ScorerWeights& getWeights() const { return weights; }
+
+    /**
+     * Add a slot with neutral features
+     * @return Index of the new slot
+     */
+    int addSlot();
+
+    /**
+     * Store the features of a slot
+     * @param book Order book of the slot
+     * @param range Imbalance window around the midpoint (multiplied by range_multiplier)
+     * @param imbalance Imbalance of the book (depth scores)
+     * @param velocity Order-flow velocity of the book
+     */
+    void setFeatures(int slot, const OrderBook& book, double range, const DepthImbalance& imbalance,
+                     double velocity);
+
+    /**
+     * Reset the features of a slot to neutral
+     */
+    void clear(int slot);
+
+    /**
+     * Score every slot from its stored features
+     */
+    void scoreAll();
+
+    int size() const { return static_cast<int>(scores.size()); }
+    double score(int slot) const { return scores[slot]; }
+    int prediction(int slot) const { return predictions[slot]; }     // DepthPrediction
+};
+
+#endif // DEPTH_SCORER_H
@@ -0,0 +1,170 @@
+/**
+ * Historical Bar Cache Implementation
+ *
+ * File format: one bar per line, "time,open,high,low,close,volume,wap,count".
+ * Prices are written with 17 significant digits and Decimal values as their
+ * raw integer representation, so a load/store round trip is exact.
+ */
+
+#include "HistoricalBarCache.h"
+#include "BarTime.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sys/stat.h>
+
+HistoricalBarCache::HistoricalBarCache(const std::string& directory)
+    : cache_dir(directory) {
+}
+
+std::string HistoricalBarCache::makeKey(const std::string& symbol, const std::string& secType,
+                                        const std::string& exchange, const std::string& currency,
+                                        const std::string& barSize, const std::string& whatToShow) {
+    return symbol + "_" + secType + "_" + exchange + "_" + currency + "_" + barSize + "_" + whatToShow;
+}
+
+std::string HistoricalBarCache::pathFor(const std::string& key) const {
+    std::string name = key;
+    for (auto& c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-') {
+            c = '_';
+        }
+    }
+    return cache_dir + "/" + name + ".csv";
+}
+
+bool HistoricalBarCache::load(const std::string& key, std::vector<BarRecord>& bars) const {
+    std::ifstream infile(pathFor(key));
+    if (!infile.is_open()) {
+        return false;
+    }
+
+    bars.clear();
+    std::string line;
+    while (std::getline(infile, line)) {
+        size_t comma = line.find(',');
+        if (comma == std::string::npos) {
+            continue;
+        }
+
+        BarRecord bar;
+        line[comma] = '\0';
+        long t;
+        if (!parseBarTime(line.c_str(), t)) {
+            continue;
+        }
+        bar.time = t;
+
+        char* p = &line[comma + 1];
+        bar.open = std::strtod(p, &p);
+        bar.high = std::strtod(p + 1, &p);
+        bar.low = std::strtod(p + 1, &p);
+        bar.close = std::strtod(p + 1, &p);
+        bar.volume = std::strtoull(p + 1, &p, 10);
+        bar.wap = std::strtoull(p + 1, &p, 10);
+        bar.count = static_cast<int>(std::strtol(p + 1, &p, 10));
+
+        bars.push_back(bar);
+    }
+
+    return !bars.empty();
+}
+
+template <typename Bars>
+bool HistoricalBarCache::storeBars(const std::string& key, const Bars& bars) const {
+    ::mkdir(cache_dir.c_str(), 0755);
+
+    // Write to a temporary file and rename, so a crash never leaves a torn cache
+    std::string path = pathFor(key);
+    std::string tmp_path = path + ".tmp";
+
+    std::FILE* out = std::fopen(tmp_path.c_str(), "w");
+    if (!out) {
+        return false;
+    }
+
+    char time[WALL_CLOCK_CHARS + 1];
+    for (size_t i = 0; i < bars.size(); ++i) {
+        const BarRecord& bar = bars[i];
+        formatWallClock(static_cast<long>(bar.time), time);
+        std::fprintf(out, "%s,%.17g,%.17g,%.17g,%.17g,%llu,%llu,%d\n",
+                     time, bar.open, bar.high, bar.low, bar.close,
+                     static_cast<unsigned long long>(bar.volume),
+                     static_cast<unsigned long long>(bar.wap), bar.count);
+    }
+
+    bool ok = std::fclose(out) == 0;
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool HistoricalBarCache::store(const std::string& key, const std::vector<BarRecord>& bars) const {
+    return storeBars(key, bars);
+}
+
+bool HistoricalBarCache::store(const std::string& key, const BarArena& bars) const {
+    return storeBars(key, bars);
+}
+
+void HistoricalBarCache::merge(std::vector<BarRecord>& cached, const BarArena& fresh) {
+    if (fresh.empty()) {
+        return;
+    }
+
+    // Drop the cached tail that the fresh download covers again
+    int64_t first_fresh = fresh[0].time;
+    size_t keep = cached.size();
+    while (keep > 0 && cached[keep - 1].time >= first_fresh) {
+        --keep;
+    }
+    cached.resize(keep);
+
+    fresh.appendTo(cached);
+}
+
+void HistoricalBarCache::trimToSpan(std::vector<BarRecord>& bars, long spanSeconds) {
+    if (bars.empty() || spanSeconds <= 0) {
+        return;
+    }
+
+    // Bars are sorted, so find the first one inside the span by binary search
+    int64_t cutoff = bars.back().time - spanSeconds;
+    auto first = std::upper_bound(bars.begin(), bars.end(), cutoff,
+                                  [](int64_t t, const BarRecord& bar) { return t < bar.time; });
+    bars.erase(bars.begin(), first);
+}
+
+void HistoricalBarCache::trimToDuration(std::vector<BarRecord>& bars, const std::string& duration) {
+    char* unit = nullptr;
+    long count = std::strtol(duration.c_str(), &unit, 10);
+    while (unit && *unit == ' ') {
+        ++unit;
+    }
+    if (count <= 0 || !unit || *unit != 'D') {
+        trimToSpan(bars, durationToSeconds(duration));
+        return;
+    }
+
+    // Walk back over the last count distinct dates (wall-clock seconds, so
+    // time / 86400 is the printed date)
+    size_t first = bars.size();
+    long days = 0;
+    int64_t day = -1;
+    while (first > 0) {
+        int64_t bar_day = bars[first - 1].time / 86400;
+        if (bar_day != day) {
+            if (days == count) {
+                break;
+            }
+            day = bar_day;
+            ++days;
+        }
+        --first;
+    }
+    bars.erase(bars.begin(), bars.begin() + first);
+}
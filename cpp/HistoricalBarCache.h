@@ -0,0 +1,77 @@
+/**
+ * Historical Bar Cache
+ * Persists downloaded bars on disk so later runs only fetch the missing tail
+ */
+
+#ifndef HISTORICAL_BAR_CACHE_H
+#define HISTORICAL_BAR_CACHE_H
+
+#include "BarArena.h"
+#include <string>
+#include <vector>
+
+/**
+ * Historical Bar Cache
+ * One file per contract / bar size / whatToShow, bars oldest first
+ */
+class HistoricalBarCache {
+private:
+    std::string cache_dir;
+
+    std::string pathFor(const std::string& key) const;
+
+    template <typename Bars>
+    bool storeBars(const std::string& key, const Bars& bars) const;
+
+public:
+    /**
+     * Constructor
+     * @param directory Cache directory (created on first store)
+     */
+    explicit HistoricalBarCache(const std::string& directory = "bar_cache");
+
+    /**
+     * Build the cache key of a request
+     */
+    static std::string makeKey(const std::string& symbol, const std::string& secType,
+                               const std::string& exchange, const std::string& currency,
+                               const std::string& barSize, const std::string& whatToShow);
+
+    /**
+     * Load cached bars
+     * @return false if nothing is cached for the key
+     */
+    bool load(const std::string& key, std::vector<BarRecord>& bars) const;
+
+    /**
+     * Replace the cached bars of a key
+     * @return false if the file could not be written
+     */
+    bool store(const std::string& key, const std::vector<BarRecord>& bars) const;
+    bool store(const std::string& key, const BarArena& bars) const;
+
+    /**
+     * Merge freshly downloaded bars into cached ones
+     * Fresh bars replace every cached bar from the first fresh bar time onwards
+     * (the last cached bar may have been incomplete when it was stored).
+     */
+    static void merge(std::vector<BarRecord>& cached, const BarArena& fresh);
+
+    /**
+     * Keep only the bars within a span of the newest bar
+     * @param bars Bars, oldest first
+     * @param spanSeconds Span in seconds (see durationToSeconds())
+     */
+    static void trimToSpan(std::vector<BarRecord>& bars, long spanSeconds);
+
+    /**
+     * Keep only the bars an uncached request of a duration would return
+     * "N D" keeps the last N trading days present in the bars (TWS counts
+     * sessions, not 24-hour periods); other units keep a calendar span.
+     * @param bars Bars, oldest first
+     * @param duration Duration string, e.g. "1 D", "3600 S", "1 M"
+     */
+    static void trimToDuration(std::vector<BarRecord>& bars, const std::string& duration);
+};
+
+#endif // HISTORICAL_BAR_CACHE_H
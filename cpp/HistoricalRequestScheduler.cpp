@@ -0,0 +1,99 @@
+/**
+ * Historical Request Scheduler Implementation
+ */
+
+#include "HistoricalRequestScheduler.h"
+#include <algorithm>
+
+HistoricalRequestScheduler::HistoricalRequestScheduler(const PacingConfig& pacing)
+    : config(pacing), tokens(pacing.burst), last_refill(Clock::now()),
+      blocked_until(Clock::now()), backoff_seconds(pacing.initial_backoff_seconds),
+      in_flight(0), issued_count(0), violation_count(0) {
+}
+
+void HistoricalRequestScheduler::refill(Clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - last_refill).count();
+    if (elapsed > 0) {
+        tokens = std::min(config.burst, tokens + elapsed * config.refill_per_second);
+        last_refill = now;
+    }
+}
+
+void HistoricalRequestScheduler::enqueue(int reqId, const std::string& key, bool paced) {
+    Pending pending;
+    pending.req_id = reqId;
+    pending.key = key;
+    pending.paced = paced;
+    queue.push_back(pending);
+}
+
+int HistoricalRequestScheduler::nextReady(Clock::time_point now) {
+    refill(now);
+
+    if (queue.empty() || in_flight >= config.max_in_flight || now < blocked_until) {
+        return -1;
+    }
+
+    std::chrono::duration<double> identical_gap(config.identical_gap_seconds);
+
+    // First queued request that is neither an identical repeat nor out of tokens
+    for (auto it = queue.begin(); it != queue.end(); ++it) {
+        auto last = last_issued.find(it->key);
+        if (last != last_issued.end() && now - last->second < identical_gap) {
+            continue;
+        }
+        if (it->paced && tokens < 1.0) {
+            continue;
+        }
+
+        int req_id = it->req_id;
+        if (it->paced) {
+            tokens -= 1.0;
+        }
+        last_issued[it->key] = now;
+        queue.erase(it);
+
+        ++in_flight;
+        ++issued_count;
+        return req_id;
+    }
+
+    return -1;
+}
+
+void HistoricalRequestScheduler::onCompleted(int reqId) {
+    release(reqId);
+
+    // A request went through, so pacing has recovered
+    backoff_seconds = config.initial_backoff_seconds;
+}
+
+void HistoricalRequestScheduler::release(int reqId) {
+    if (in_flight > 0) {
+        --in_flight;
+    }
+}
+
+void HistoricalRequestScheduler::onPacingViolation(int reqId, const std::string& key, bool paced,
+                                                   Clock::time_point now) {
+    if (in_flight > 0) {
+        --in_flight;
+    }
+    ++violation_count;
+
+    // TWS has no spare capacity: drain the bucket and pause all requests
+    tokens = 0;
+    last_refill = now;
+    blocked_until = now + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(backoff_seconds));
+    backoff_seconds = std::min(backoff_seconds * 2.0, config.max_backoff_seconds);
+
+    // The identical-request timer must not delay the retry beyond the back-off
+    last_issued.erase(key);
+
+    Pending pending;
+    pending.req_id = reqId;
+    pending.key = key;
+    pending.paced = paced;
+    queue.push_front(pending);
+}
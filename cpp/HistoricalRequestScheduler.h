@@ -0,0 +1,108 @@
+/**
+ * Historical Request Scheduler
+ * Token-bucket pacing for IBKR historical data requests
+ *
+ * IBKR pacing rules for historical data:
+ *   - at most 60 requests in any 10 minute period (bars of 30 secs or less)
+ *   - no identical request within 15 seconds
+ *   - at most 50 requests open at the same time
+ * Violations are reported through error() (codes 162 / 420) and are answered
+ * here with an exponential back-off.
+ */
+
+#ifndef HISTORICAL_REQUEST_SCHEDULER_H
+#define HISTORICAL_REQUEST_SCHEDULER_H
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <string>
+
+/**
+ * Pacing parameters
+ * A token bucket never exceeds burst + rate * T requests in any window T,
+ * so the defaults (20 + 40 per 600 s) stay within 60 requests per 10 minutes.
+ */
+struct PacingConfig {
+    double burst;                   // Bucket capacity (requests)
+    double refill_per_second;       // Sustained request rate
+    int max_in_flight;              // Open requests allowed at once
+    double identical_gap_seconds;   // Minimum spacing of identical requests
+    double initial_backoff_seconds; // First back-off after a pacing violation
+    double max_backoff_seconds;     // Back-off ceiling
+
+    PacingConfig() : burst(20), refill_per_second(40.0 / 600.0), max_in_flight(50),
+                     identical_gap_seconds(15), initial_backoff_seconds(15),
+                     max_backoff_seconds(600) {}
+};
+
+/**
+ * Historical Request Scheduler
+ * Queues request ids and releases them as fast as pacing allows
+ */
+class HistoricalRequestScheduler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+private:
+    struct Pending {
+        int req_id;
+        std::string key;    // Identifies identical requests
+        bool paced;         // Consumes a token (small bar sizes only)
+    };
+
+    PacingConfig config;
+    std::deque<Pending> queue;
+    std::map<std::string, Clock::time_point> last_issued;
+
+    double tokens;
+    Clock::time_point last_refill;
+    Clock::time_point blocked_until;
+    double backoff_seconds;
+    int in_flight;
+
+    int issued_count;
+    int violation_count;
+
+    void refill(Clock::time_point now);
+
+public:
+    explicit HistoricalRequestScheduler(const PacingConfig& pacing = PacingConfig());
+
+    /**
+     * Queue a request
+     * @param reqId Request id to release later
+     * @param key Request identity (contract, bar size, duration, whatToShow)
+     * @param paced Whether the request counts against the 60 per 10 minute limit
+     */
+    void enqueue(int reqId, const std::string& key, bool paced = true);
+
+    /**
+     * Release the next request allowed to go out now
+     * @return Request id, or -1 if nothing may be issued yet
+     */
+    int nextReady(Clock::time_point now);
+
+    /**
+     * Mark an issued request as answered (data received or failed); resets the back-off
+     */
+    void onCompleted(int reqId);
+
+    /**
+     * Free the slot of an issued request that got no answer (timed out or
+     * abandoned); the back-off is kept, since TWS may still be pacing
+     */
+    void release(int reqId);
+
+    /**
+     * Handle a pacing violation: re-queue the request at the front and back off
+     */
+    void onPacingViolation(int reqId, const std::string& key, bool paced, Clock::time_point now);
+
+    size_t pending() const { return queue.size(); }
+    int inFlight() const { return in_flight; }
+    int issued() const { return issued_count; }
+    int violations() const { return violation_count; }
+};
+
+#endif // HISTORICAL_REQUEST_SCHEDULER_H
@@ -5,17 +5,56 @@
 #include "IBKRAutoFibClient.h"
 #include "Contract.h"
 #include "Order.h"
+#include "BarTime.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <ctime>
 
+const int IBKRAutoFibClient::LOOKBACK_BARS;
+const TickerId IBKRAutoFibClient::HISTORICAL_REQ_ID_BASE;
+const TickerId IBKRAutoFibClient::REALTIME_REQ_ID_BASE;
+const TickerId IBKRAutoFibClient::TICK_REQ_ID_BASE;
+const TickerId IBKRAutoFibClient::DEPTH_REQ_ID_BASE;
+const std::chrono::seconds IBKRAutoFibClient::REQUEST_TIMEOUT(30);
+
+static Contract makeContract(const std::string& symbol, const std::string& secType,
+                             const std::string& exchange, const std::string& currency) {
+    Contract contract;
+    contract.symbol = symbol;
+    contract.secType = secType;
+    contract.exchange = exchange;
+    contract.currency = currency;
+    return contract;
+}
+
 IBKRAutoFibClient::IBKRAutoFibClient()
-    : data_ready(false), data_end_received(false), next_order_id(0) {
+    : next_historical_req_id(HISTORICAL_REQ_ID_BASE), last_historical_req_id(0),
+      ingest_req_id(-1), ingest_arena(nullptr), realtime_bars(LOOKBACK_BARS),
+      atr_filter_multiple(0), next_order_id(0) {
 
-    os_signal = std::make_unique<EReaderOSSignal>();
+    // Wake up periodically so queued historical requests are issued on time
+    os_signal = std::make_unique<EReaderOSSignal>(100);
     client_socket = std::make_unique<EClientSocket>(this, os_signal.get());
-    indicator = std::make_unique<AutoFibIndicator>(20);  // 20 bars lookback
+    indicator = std::make_unique<AutoFibIndicator>(LOOKBACK_BARS);
+
+    // Sampled by the metrics exporter, never on the callback path
+    metrics.addGauge("historical_queue_depth", "Historical requests waiting for pacing", [this] {
+        std::lock_guard<std::mutex> lock(data_mutex);
+        return static_cast<double>(scheduler.pending());
+    });
+    metrics.addGauge("historical_in_flight", "Historical requests sent and not yet answered", [this] {
+        std::lock_guard<std::mutex> lock(data_mutex);
+        return static_cast<double>(scheduler.inFlight());
+    });
+    metrics.addGauge("live_symbols", "Symbols with real-time bars or tick-by-tick data", [this] {
+        std::lock_guard<std::mutex> lock(realtime_mutex);
+        return static_cast<double>(realtime_slots.size());
+    });
+    metrics.addGauge("depth_symbols", "Symbols with market depth", [this] {
+        std::lock_guard<std::mutex> lock(depth_mutex);
+        return static_cast<double>(depth_slots.size());
+    });
 }
 
 IBKRAutoFibClient::~IBKRAutoFibClient() {
@@ -26,6 +65,21 @@ IBKRAutoFibClient::~IBKRAutoFibClient() {
 
 bool IBKRAutoFibClient::connect(const char* host, int port, int clientId) {
     std::cout << "Connecting to " << host << ":" << port << "..." << std::endl;
+
+    // With capture enabled the client talks to TWS through a local relay
+    if (!wire_capture_path.empty()) {
+        wire_capture = std::make_unique<WireCapture>();
+        std::string error;
+        if (!wire_capture->start(host, port, wire_capture_path, &error)) {
+            std::cout << "Connection failed: " << error << std::endl;
+            wire_capture.reset();
+            return false;
+        }
+        std::cout << "Recording inbound messages to " << wire_capture_path << std::endl;
+        host = "127.0.0.1";
+        port = wire_capture->port();
+    }
+
     bool result = client_socket->eConnect(host, port, clientId, false);
 
     if (result) {
@@ -39,18 +93,332 @@ bool IBKRAutoFibClient::connect(const char* host, int port, int clientId) {
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     } else {
         std::cout << "Connection failed" << std::endl;
+        wire_capture.reset();
     }
 
     return result;
 }
 
 void IBKRAutoFibClient::disconnect() {
+    if (replay) {
+        replay.reset();
+        std::cout << "Replay closed" << std::endl;
+        return;
+    }
+
     client_socket->eDisconnect();
+    if (wire_capture) {
+        wire_capture->stop();
+        wire_capture.reset();
+    }
     std::cout << "Disconnected" << std::endl;
 }
 
 bool IBKRAutoFibClient::isConnected() const {
-    return client_socket->isConnected();
+    return replay || client_socket->isConnected();
+}
+
+void IBKRAutoFibClient::enableWireCapture(const std::string& path) {
+    wire_capture_path = path;
+}
+
+bool IBKRAutoFibClient::openReplay(const std::string& path, double speed) {
+    std::unique_ptr<WireReplay> session = std::make_unique<WireReplay>();
+    std::string error;
+    if (!session->open(path, this, speed, &error)) {
+        std::cout << "Cannot replay: " << error << std::endl;
+        return false;
+    }
+
+    std::cout << "Replaying " << path << " (server version " << session->serverVersion() << ")" << std::endl;
+    replay = std::move(session);
+    return true;
+}
+
+void IBKRAutoFibClient::enableBarCache(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(data_mutex);
+    bar_cache = std::make_unique<HistoricalBarCache>(directory);
+}
+
+bool IBKRAutoFibClient::enableResultPublisher(const std::string& name, int maxSymbols) {
+    std::unique_ptr<ResultPublisher> publisher = std::make_unique<ResultPublisher>();
+    std::string error;
+    if (!publisher->open(name, maxSymbols, &error)) {
+        std::cout << "Result publisher disabled: " << error << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(publisher_mutex);
+    result_publisher = std::move(publisher);
+    return true;
+}
+
+bool IBKRAutoFibClient::enableMetrics(int httpPort, const std::string& statsFile, int intervalSeconds) {
+    std::unique_ptr<MetricsExporter> exporter = std::make_unique<MetricsExporter>();
+    std::string error;
+    if (!exporter->start(&metrics, httpPort, statsFile, intervalSeconds * 1000, &error)) {
+        std::cout << "Metrics disabled: " << error << std::endl;
+        return false;
+    }
+
+    if (httpPort >= 0) {
+        std::cout << "Metrics at http://127.0.0.1:" << exporter->port() << "/metrics" << std::endl;
+    }
+    if (!statsFile.empty()) {
+        std::cout << "Writing metrics to " << statsFile << " every " << intervalSeconds << "s" << std::endl;
+    }
+    metrics_exporter = std::move(exporter);
+    return true;
+}
+
+int IBKRAutoFibClient::submitHistoricalRequest(
+    const std::string& symbol,
+    const std::string& secType,
+    const std::string& exchange,
+    const std::string& currency,
+    const std::string& duration,
+    const std::string& barSize
+) {
+    const std::string what_to_show = "TRADES";
+    int bar_seconds = barSizeToSeconds(barSize);
+
+    // With a warm cache only the span since the last cached bar is downloaded
+    std::string cache_key;
+    std::string fetch_duration = duration;
+    std::vector<BarRecord> cached;
+    if (bar_cache) {
+        cache_key = HistoricalBarCache::makeKey(symbol, secType, exchange, currency, barSize, what_to_show);
+
+        if (bar_cache->load(cache_key, cached)) {
+            // Re-fetch the last cached bar as well, it may have been incomplete.
+            // Bar times are wall-clock in the zone TWS prints (dropped when
+            // parsed) and wallClockNow() is the host's, so a day of padding
+            // covers any difference; merge() drops the overlap
+            long gap = wallClockNow() - static_cast<long>(cached.back().time) + bar_seconds + 86400;
+            if (gap > 0 && gap < durationToSeconds(duration)) {
+                fetch_duration = secondsToDuration(gap, bar_seconds >= 86400);
+                std::cout << "Using " << cached.size() << " cached bars for " << symbol
+                          << ", fetching last " << fetch_duration << std::endl;
+            } else {
+                cached.clear();
+            }
+        } else {
+            cached.clear();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(data_mutex);
+
+    int req_id = allocateHistoricalReqId();
+    if (req_id < 0) {
+        std::cout << "Too many open historical requests, dropping " << symbol << std::endl;
+        return -1;
+    }
+
+    HistoricalRequest& request = historical_requests[req_id];
+    request.symbol = symbol;
+    request.secType = secType;
+    request.exchange = exchange;
+    request.currency = currency;
+    request.duration = duration;
+    request.fetch_duration = fetch_duration;
+    request.barSize = barSize;
+    request.whatToShow = what_to_show;
+    request.key = symbol + "|" + secType + "|" + exchange + "|" + currency + "|" +
+                  fetch_duration + "|" + barSize + "|" + what_to_show;
+    request.cache_key = cache_key;
+    request.cached = std::move(cached);
+    request.expected_bars = expectedBarCount(fetch_duration, barSize, true);
+
+    // Only bars of 30 secs or less count against the 60 requests / 10 minutes limit
+    request.paced = bar_seconds <= 30;
+
+    scheduler.enqueue(req_id, request.key, request.paced);
+    last_historical_req_id = req_id;
+    return req_id;
+}
+
+int IBKRAutoFibClient::allocateHistoricalReqId() {
+    // Ids wrap within their own range so they never reach the live-feed ids;
+    // ids whose request has not been taken yet are skipped
+    const int range = static_cast<int>(REALTIME_REQ_ID_BASE - HISTORICAL_REQ_ID_BASE);
+    for (int attempt = 0; attempt < range; ++attempt) {
+        int req_id = next_historical_req_id;
+        next_historical_req_id = req_id + 1 < REALTIME_REQ_ID_BASE ? req_id + 1
+                                                                   : static_cast<int>(HISTORICAL_REQ_ID_BASE);
+        if (historical_requests.find(req_id) == historical_requests.end()) {
+            return req_id;
+        }
+    }
+    return -1;
+}
+
+void IBKRAutoFibClient::pumpHistoricalRequests() {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(data_mutex);
+
+    // Expire requests TWS never answered so their slots are released
+    for (auto& entry : historical_requests) {
+        HistoricalRequest& request = entry.second;
+        if (request.issued && !request.done && now - request.issued_at > REQUEST_TIMEOUT) {
+            std::cout << "Timeout waiting for historical data for " << request.symbol << std::endl;
+            request.error = "Timeout waiting for historical data";
+            request.done = true;
+            scheduler.release(entry.first);
+            metrics.increment(METRIC_REQUEST_TIMEOUTS);
+            if (!replay) {
+                client_socket->cancelHistoricalData(entry.first);
+            }
+        }
+    }
+
+    int req_id;
+    while ((req_id = scheduler.nextReady(now)) >= 0) {
+        auto it = historical_requests.find(req_id);
+        if (it == historical_requests.end()) {
+            scheduler.release(req_id);
+            continue;
+        }
+
+        HistoricalRequest& request = it->second;
+        request.issued = true;
+        request.issued_at = now;
+
+        std::cout << "Requesting historical data for " << request.symbol << "..." << std::endl;
+        metrics.increment(METRIC_HISTORICAL_REQUESTS);
+
+        if (!replay) {
+            client_socket->reqHistoricalData(
+                req_id,
+                makeContract(request.symbol, request.secType, request.exchange, request.currency),
+                "",                 // endDateTime (empty = now)
+                request.fetch_duration, // durationStr
+                request.barSize,    // barSizeSetting
+                request.whatToShow, // whatToShow
+                1,                  // useRTH (regular trading hours)
+                1,                  // formatDate (1 = yyyyMMdd HH:mm:ss)
+                false,              // keepUpToDate
+                TagValueListSPtr()  // chartOptions
+            );
+        }
+    }
+
+    if (scheduler.pending() > 0) {
+        metrics.increment(METRIC_PACING_WAITS);
+    }
+}
+
+void IBKRAutoFibClient::waitForHistoricalData(const std::vector<int>& reqIds) {
+    while (true) {
+        pumpHistoricalRequests();
+
+        {
+            std::lock_guard<std::mutex> lock(data_mutex);
+            bool all_done = true;
+            for (int req_id : reqIds) {
+                auto it = historical_requests.find(req_id);
+                if (it != historical_requests.end() && !it->second.done) {
+                    all_done = false;
+                    break;
+                }
+            }
+            if (all_done) {
+                return;
+            }
+
+            bool replay_ended = replay && replay->done();
+            if (!isConnected() || replay_ended) {
+                for (int req_id : reqIds) {
+                    auto it = historical_requests.find(req_id);
+                    if (it != historical_requests.end() && !it->second.done) {
+                        it->second.error = replay_ended ? "Not in the replayed session" : "Connection lost";
+                        it->second.done = true;
+                    }
+                }
+                return;
+            }
+        }
+
+        readMessages();
+    }
+}
+
+void IBKRAutoFibClient::readMessages() {
+    if (replay) {
+        // Decode what is due, or wait for it as the reader would for the socket
+        latency.markBatch();
+        if (replay->pump() == 0) {
+            int wait_ms = replay->nextDueMs();
+            if (wait_ms > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(wait_ms < 100 ? wait_ms : 100));
+            }
+        }
+    } else if (reader) {
+        os_signal->waitForSignal();
+        latency.markBatch();
+        reader->processMsgs();
+    }
+
+    // Depth events of this batch only updated the books; analyse the changed
+    // ones here, so analytics keep running while waiting for historical data
+    std::lock_guard<std::mutex> lock(depth_mutex);
+    if (depth_engine.size() > 0) {
+        depth_engine.runAnalytics(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
+BarArena IBKRAutoFibClient::takeHistoricalData(int reqId, std::string& error) {
+    HistoricalRequest request;
+    {
+        std::lock_guard<std::mutex> lock(data_mutex);
+
+        auto it = historical_requests.find(reqId);
+        if (it == historical_requests.end()) {
+            error = "Unknown request";
+            return BarArena(&bar_pool);
+        }
+
+        request = std::move(it->second);
+        historical_requests.erase(it);
+    }
+
+    error = request.error;
+
+    // Uncached: hand the download arena over without copying it
+    if (request.cached.empty()) {
+        if (!request.cache_key.empty() && error.empty() && !request.bars.empty()) {
+            if (!bar_cache->store(request.cache_key, request.bars)) {
+                std::cout << "Could not write bar cache for " << request.symbol << std::endl;
+            }
+        }
+        return std::move(request.bars);
+    }
+
+    if (!error.empty()) {
+        // A timeout or lost connection says nothing about newer bars, so
+        // stale cached bars are not passed off as current
+        if (!request.no_data) {
+            return BarArena(&bar_pool);
+        }
+        std::cout << "No new bars for " << request.symbol << ", using cached bars" << std::endl;
+        error.clear();
+        request.bars.clear();
+    }
+
+    std::vector<BarRecord>& bars = request.cached;
+    HistoricalBarCache::merge(bars, request.bars);
+    if (!bar_cache->store(request.cache_key, bars)) {
+        std::cout << "Could not write bar cache for " << request.symbol << std::endl;
+    }
+
+    // The cache may hold more history than was asked for; return what an
+    // uncached request would have
+    HistoricalBarCache::trimToDuration(bars, request.duration);
+
+    BarArena out(&bar_pool);
+    out.append(bars.data(), bars.size());
+    return out;
 }
 
 bool IBKRAutoFibClient::requestHistoricalData(
@@ -66,49 +434,36 @@ bool IBKRAutoFibClient::requestHistoricalData(
         return false;
     }
 
-    Contract contract;
-    contract.symbol = symbol;
-    contract.secType = secType;
-    contract.exchange = exchange;
-    contract.currency = currency;
+    submitHistoricalRequest(symbol, secType, exchange, currency, duration, barSize);
+    pumpHistoricalRequests();
+    return true;
+}
 
-    // Clear previous data
+BarArena IBKRAutoFibClient::getHistoricalRecords() {
+    int req_id;
     {
         std::lock_guard<std::mutex> lock(data_mutex);
-        historical_data.clear();
-        data_ready = false;
-        data_end_received = false;
-    }
-
-    std::cout << "Requesting historical data for " << symbol << "..." << std::endl;
-
-    client_socket->reqHistoricalData(
-        1,                  // reqId
-        contract,
-        "",                 // endDateTime (empty = now)
-        duration,           // durationStr
-        barSize,            // barSizeSetting
-        "TRADES",           // whatToShow
-        1,                  // useRTH (regular trading hours)
-        1,                  // formatDate (1 = yyyyMMdd HH:mm:ss)
-        false,              // keepUpToDate
-        TagValueListSPtr()  // chartOptions
-    );
+        req_id = last_historical_req_id;
+    }
 
-    return true;
+    waitForHistoricalData(std::vector<int>(1, req_id));
+
+    std::string error;
+    BarArena records = takeHistoricalData(req_id, error);
+    if (!error.empty()) {
+        std::cout << "Historical data request failed: " << error << std::endl;
+    }
+    return records;
 }
 
 std::vector<Bar> IBKRAutoFibClient::getHistoricalData() {
-    std::unique_lock<std::mutex> lock(data_mutex);
+    BarArena records = getHistoricalRecords();
 
-    // Wait for data with timeout
-    if (!data_cv.wait_for(lock, std::chrono::seconds(30),
-        [this] { return data_end_received.load(); })) {
-        std::cout << "Timeout waiting for historical data" << std::endl;
-        return std::vector<Bar>();
+    std::vector<Bar> bars(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        toBar(records[i], bars[i]);
     }
-
-    return historical_data;
+    return bars;
 }
 
 FibonacciResults IBKRAutoFibClient::runIndicator(
@@ -119,53 +474,493 @@ FibonacciResults IBKRAutoFibClient::runIndicator(
     const std::string& duration,
     const std::string& barSize
 ) {
+    return runIndicators(std::vector<std::string>(1, symbol),
+                         secType, exchange, currency, duration, barSize).front();
+}
+
+std::vector<FibonacciResults> IBKRAutoFibClient::runIndicators(
+    const std::vector<std::string>& symbols,
+    const std::string& secType,
+    const std::string& exchange,
+    const std::string& currency,
+    const std::string& duration,
+    const std::string& barSize
+) {
+    std::vector<FibonacciResults> all_results(symbols.size());
+
+    if (!isConnected()) {
+        std::cout << "Not connected to TWS/Gateway" << std::endl;
+        for (auto& results : all_results) {
+            results.error = "Failed to request historical data";
+        }
+        return all_results;
+    }
+
+    // Queue everything up front; the scheduler issues requests as pacing allows
+    std::vector<int> req_ids;
+    req_ids.reserve(symbols.size());
+    for (const auto& symbol : symbols) {
+        std::cout << "\nFetching data for " << symbol << "..." << std::endl;
+        req_ids.push_back(submitHistoricalRequest(symbol, secType, exchange, currency, duration, barSize));
+    }
+
+    waitForHistoricalData(req_ids);
+
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        std::string error;
+        BarArena bars = takeHistoricalData(req_ids[i], error);
+
+        if (!error.empty()) {
+            all_results[i].error = error;
+            continue;
+        }
+        if (bars.empty()) {
+            all_results[i].error = "No data received";
+            continue;
+        }
+
+        std::cout << "Received " << bars.size() << " bars for " << symbols[i] << std::endl;
+        std::cout << "Calculating Fibonacci levels..." << std::endl;
+
+        int64_t start = latency.begin();
+        all_results[i] = indicator->calculate(bars);
+        metrics.increment(METRIC_CALCULATIONS);
+        latency.recordSince(LATENCY_INDICATOR, start);
+        publishResults(symbols[i], all_results[i]);
+    }
+
+    return all_results;
+}
+
+int IBKRAutoFibClient::liveSlot(const std::string& symbol, int barSeconds) {
+    auto it = realtime_slots.find(symbol);
+    if (it != realtime_slots.end()) {
+        return it->second;
+    }
+
+    int slot = realtime_bars.addSymbol(symbol, barSeconds);
+    realtime_indicators.push_back(AutoFibIndicator(LOOKBACK_BARS));
+    realtime_indicators.back().setAtrFilter(atr_filter_multiple);
+    live_feeds.push_back(LiveFeeds());
+    realtime_slots[symbol] = slot;
+    return slot;
+}
+
+bool IBKRAutoFibClient::updateLiveIndicator(int slot, bool barClosed, double price) {
+    AutoFibIndicator& live_indicator = realtime_indicators[slot];
+    bool was_in_zone = live_indicator.getResults().price_in_golden_zone;
+    int64_t start = latency.begin();
+
+    // Levels move only when a bar completes; the price moves on every update
+    if (barClosed) {
+        const RealTimeBarState& state = realtime_bars.state(slot);
+        double atr = state.atr.value();
+        live_indicator.setAtr(atr);
+        live_indicator.calculate(state.window);
+        metrics.increment(METRIC_CALCULATIONS);
+
+        // The same ATR sizes the imbalance window of the symbol's depth book
+        std::lock_guard<std::mutex> lock(depth_mutex);
+        auto it = depth_slots.find(state.symbol);
+        if (it != depth_slots.end()) {
+            depth_engine.setAtr(it->second, atr);
+        }
+    }
+    live_indicator.updatePrice(price);
+    latency.recordSince(LATENCY_INDICATOR, start);
+    publishResults(realtime_bars.state(slot).symbol, live_indicator.getResults());
+
+    return barClosed || live_indicator.getResults().price_in_golden_zone != was_in_zone;
+}
+
+void IBKRAutoFibClient::publishRealTime(int slot) {
+    RealTimeCallback callback;
+    std::string symbol;
     FibonacciResults results;
 
-    std::cout << "\nFetching data for " << symbol << "..." << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(realtime_mutex);
+        if (!realtime_callback) {
+            return;
+        }
+        callback = realtime_callback;
+        symbol = realtime_bars.state(slot).symbol;
+        results = realtime_indicators[slot].getResults();
+    }
 
-    if (!requestHistoricalData(symbol, secType, exchange, currency, duration, barSize)) {
-        results.error = "Failed to request historical data";
-        return results;
+    callback(symbol, results);
+}
+
+void IBKRAutoFibClient::publishResults(const std::string& symbol, const FibonacciResults& results) {
+    int64_t start = latency.begin();
+    std::lock_guard<std::mutex> lock(publisher_mutex);
+    metrics.increment(METRIC_RESULTS_PUBLISHED);
+
+    // Every update is published; a slot write is a copy and two stores
+    if (result_publisher) {
+        result_publisher->publish(symbol, std::time(nullptr), results);
     }
 
-    // Process messages while waiting for data
-    auto start = std::chrono::steady_clock::now();
-    while (!data_end_received &&
-           std::chrono::steady_clock::now() - start < std::chrono::seconds(30)) {
-        os_signal->waitForSignal();
-        reader->processMsgs();
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // Subscribers only hear about changes of the signal
+    auto it = signal_states.find(symbol);
+    if (it == signal_states.end()) {
+        SignalState state;
+        state.id = static_cast<uint32_t>(signal_states.size());
+        state.signal = RESULT_SIGNAL_NO_DATA;
+        it = signal_states.emplace(symbol, state).first;
+    }
+
+    int signal = resultSignalCode(AutoFibIndicator::signalFor(results));
+    if (signal != it->second.signal) {
+        int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        signal_bus.publish(makeSignalEvent(it->second.id, symbol, it->second.signal, signal,
+                                           results.current_price, now_ns));
+        it->second.signal = signal;
+        metrics.increment(METRIC_SIGNAL_EVENTS);
+    }
+
+    latency.recordSince(LATENCY_PUBLISH, start);
+    latency.recordPublished();
+}
+
+bool IBKRAutoFibClient::subscribeRealTimeBars(
+    const std::string& symbol,
+    const std::string& secType,
+    const std::string& exchange,
+    const std::string& currency,
+    const std::string& barSize,
+    const std::string& whatToShow
+) {
+    if (!isConnected()) {
+        std::cout << "Not connected to TWS/Gateway" << std::endl;
+        return false;
+    }
+
+    int bar_seconds = barSizeToSeconds(barSize);
+    if (bar_seconds <= 0) {
+        std::cout << "Unsupported bar size: " << barSize << std::endl;
+        return false;
+    }
+
+    int slot;
+    {
+        std::lock_guard<std::mutex> lock(realtime_mutex);
+        slot = liveSlot(symbol, bar_seconds);
+        if (live_feeds[slot].bars) {
+            std::cout << "Already subscribed to real-time bars for " << symbol << std::endl;
+            return false;
+        }
+        live_feeds[slot].bars = true;
+    }
+
+    std::cout << "Subscribing to real-time bars for " << symbol << " (" << barSize << ")" << std::endl;
+
+    if (!replay) {
+        client_socket->reqRealTimeBars(
+            REALTIME_REQ_ID_BASE + slot,
+            makeContract(symbol, secType, exchange, currency),
+            RealTimeBarAggregator::SOURCE_BAR_SECONDS,
+            whatToShow,
+            true,               // useRTH
+            TagValueListSPtr()  // realTimeBarsOptions
+        );
+    }
+
+    return true;
+}
+
+void IBKRAutoFibClient::cancelRealTimeBars(const std::string& symbol) {
+    int slot;
+    {
+        std::lock_guard<std::mutex> lock(realtime_mutex);
+        auto it = realtime_slots.find(symbol);
+        if (it == realtime_slots.end() || !live_feeds[it->second].bars) {
+            return;
+        }
+        slot = it->second;
+        live_feeds[slot].bars = false;
+        realtime_bars.endBarFeed(slot);
+    }
+
+    // The slot is kept so reqIds of other subscriptions stay valid
+    if (!replay) {
+        client_socket->cancelRealTimeBars(REALTIME_REQ_ID_BASE + slot);
+    }
+}
+
+bool IBKRAutoFibClient::subscribeTickByTick(
+    const std::string& symbol,
+    const std::string& secType,
+    const std::string& exchange,
+    const std::string& currency,
+    const std::string& tickType,
+    const std::string& barSize
+) {
+    if (!isConnected()) {
+        std::cout << "Not connected to TWS/Gateway" << std::endl;
+        return false;
+    }
+
+    int bar_seconds = barSizeToSeconds(barSize);
+    if (bar_seconds <= 0) {
+        std::cout << "Unsupported bar size: " << barSize << std::endl;
+        return false;
+    }
+
+    int slot;
+    {
+        std::lock_guard<std::mutex> lock(realtime_mutex);
+        slot = liveSlot(symbol, bar_seconds);
+        if (live_feeds[slot].ticks) {
+            std::cout << "Already subscribed to tick-by-tick data for " << symbol << std::endl;
+            return false;
+        }
+        live_feeds[slot].ticks = true;
+        tick_ingestor.addSymbol(slot);
+    }
+
+    std::cout << "Subscribing to tick-by-tick " << tickType << " data for " << symbol << std::endl;
+
+    if (!replay) {
+        client_socket->reqTickByTickData(
+            static_cast<int>(TICK_REQ_ID_BASE + slot),
+            makeContract(symbol, secType, exchange, currency),
+            tickType,           // "Last", "AllLast", "BidAsk" or "MidPoint"
+            0,                  // numberOfTicks (0 = streaming only)
+            false               // ignoreSize
+        );
+    }
+
+    return true;
+}
+
+void IBKRAutoFibClient::cancelTickByTick(const std::string& symbol) {
+    int slot;
+    {
+        std::lock_guard<std::mutex> lock(realtime_mutex);
+        auto it = realtime_slots.find(symbol);
+        if (it == realtime_slots.end() || !live_feeds[it->second].ticks) {
+            return;
+        }
+        slot = it->second;
+        live_feeds[slot].ticks = false;
+    }
+
+    if (!replay) {
+        client_socket->cancelTickByTickData(static_cast<int>(TICK_REQ_ID_BASE + slot));
+    }
+}
+
+size_t IBKRAutoFibClient::getRecentTicks(const std::string& symbol, std::vector<TickRecord>& out) {
+    std::lock_guard<std::mutex> lock(realtime_mutex);
+    out.clear();
+
+    auto it = realtime_slots.find(symbol);
+    if (it == realtime_slots.end() || !tick_ingestor.hasSymbol(it->second)) {
+        return 0;
+    }
+
+    const TickRingBuffer<TickRecord>& ticks = tick_ingestor.ticks(it->second);
+    out.reserve(ticks.size());
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        out.push_back(ticks[i]);
+    }
+    return out.size();
+}
+
+bool IBKRAutoFibClient::subscribeMarketDepth(
+    const std::string& symbol,
+    const std::string& secType,
+    const std::string& exchange,
+    const std::string& currency,
+    int numRows,
+    bool smartDepth
+) {
+    if (!isConnected()) {
+        std::cout << "Not connected to TWS/Gateway" << std::endl;
+        return false;
+    }
+
+    int slot;
+    {
+        std::lock_guard<std::mutex> lock(depth_mutex);
+        slot = depth_engine.addSymbol(symbol);
+        if (slot >= static_cast<int>(depth_feeds.size())) {
+            depth_feeds.resize(slot + 1);
+        }
+        if (depth_feeds[slot].active) {
+            std::cout << "Already subscribed to market depth for " << symbol << std::endl;
+            return false;
+        }
+        depth_feeds[slot].active = true;
+        depth_feeds[slot].smart_depth = smartDepth;
+        depth_slots[symbol] = slot;
+        depth_engine.reset(slot);
+    }
+
+    std::cout << "Subscribing to market depth for " << symbol << std::endl;
+
+    if (!replay) {
+        client_socket->reqMktDepth(
+            DEPTH_REQ_ID_BASE + slot,
+            makeContract(symbol, secType, exchange, currency),
+            numRows < OrderBook::MAX_LEVELS ? numRows : OrderBook::MAX_LEVELS,
+            smartDepth,         // isSmartDepth (aggregate all exchanges)
+            TagValueListSPtr()  // mktDepthOptions
+        );
+    }
+
+    return true;
+}
+
+void IBKRAutoFibClient::cancelMarketDepth(const std::string& symbol) {
+    int slot;
+    bool smart_depth;
+    {
+        std::lock_guard<std::mutex> lock(depth_mutex);
+        auto it = depth_slots.find(symbol);
+        if (it == depth_slots.end() || !depth_feeds[it->second].active) {
+            return;
+        }
+        slot = it->second;
+        smart_depth = depth_feeds[slot].smart_depth;
+        depth_feeds[slot].active = false;
+    }
+
+    if (!replay) {
+        client_socket->cancelMktDepth(DEPTH_REQ_ID_BASE + slot, smart_depth);
+    }
+}
+
+bool IBKRAutoFibClient::getOrderBook(const std::string& symbol, OrderBook& out) {
+    std::lock_guard<std::mutex> lock(depth_mutex);
+
+    auto it = depth_slots.find(symbol);
+    if (it == depth_slots.end()) {
+        return false;
+    }
+
+    out = depth_engine.book(it->second);
+    return true;
+}
+
+bool IBKRAutoFibClient::getDepthSignals(const std::string& symbol, DepthSignals& out) {
+    std::lock_guard<std::mutex> lock(depth_mutex);
+
+    auto it = depth_slots.find(symbol);
+    if (it == depth_slots.end()) {
+        return false;
+    }
+
+    out = depth_engine.signals(it->second);
+    return true;
+}
+
+bool IBKRAutoFibClient::loadDepthScorerWeights(const std::string& path) {
+    std::lock_guard<std::mutex> lock(depth_mutex);
+
+    ScorerWeights weights = depth_engine.scorerWeights();
+    std::string error;
+    if (!loadScorerWeights(path, weights, &error)) {
+        std::cout << "Depth scorer weights not loaded: " << error << std::endl;
+        return false;
     }
 
-    std::vector<Bar> bars = getHistoricalData();
+    depth_engine.setScorerWeights(weights);
+    return true;
+}
+
+size_t IBKRAutoFibClient::getIcebergEvents(std::vector<IcebergEvent>& out) {
+    std::lock_guard<std::mutex> lock(depth_mutex);
+    out.clear();
+
+    const TickRingBuffer<IcebergEvent>& events = depth_engine.icebergEvents();
+    out.reserve(events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        out.push_back(events[i]);
+    }
+    return out.size();
+}
+
+FibonacciResults IBKRAutoFibClient::getRealTimeResults(const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(realtime_mutex);
 
-    if (bars.empty()) {
-        results.error = "No data received";
+    auto it = realtime_slots.find(symbol);
+    if (it == realtime_slots.end()) {
+        FibonacciResults results;
+        results.error = "Not subscribed";
         return results;
     }
 
-    std::cout << "Received " << bars.size() << " bars" << std::endl;
-    std::cout << "Calculating Fibonacci levels..." << std::endl;
+    return realtime_indicators[it->second].getResults();
+}
+
+void IBKRAutoFibClient::setAtrFilter(double multiple) {
+    std::lock_guard<std::mutex> lock(realtime_mutex);
+    atr_filter_multiple = multiple;
+    for (AutoFibIndicator& live_indicator : realtime_indicators) {
+        live_indicator.setAtrFilter(multiple);
+    }
+}
 
-    results = indicator->calculate(bars);
-    return results;
+void IBKRAutoFibClient::setRealTimeCallback(RealTimeCallback callback) {
+    std::lock_guard<std::mutex> lock(realtime_mutex);
+    realtime_callback = std::move(callback);
 }
 
 void IBKRAutoFibClient::processMessages() {
-    if (reader) {
-        os_signal->waitForSignal();
-        reader->processMsgs();
-    }
+    pumpHistoricalRequests();
+    readMessages();
 }
 
 // EWrapper implementations
 
 void IBKRAutoFibClient::error(int id, int errorCode, const std::string& errorString, const std::string& advancedOrderRejectJson) {
+    LatencyScope scope(latency);
+    metrics.increment(METRIC_MSG_ERROR);
+    metrics.countError(errorCode);
     std::cout << "Error [" << id << "][" << errorCode << "]: " << errorString << std::endl;
 
     if (errorCode == 502 || errorCode == 503) {
         std::cout << "Connection error - ensure TWS/Gateway is running" << std::endl;
     }
+
+    // 2100-2199 are informational (farm status, fractional size warnings, ...)
+    if (id < 0 || (errorCode >= 2100 && errorCode < 2200)) {
+        return;
+    }
+
+    // Market depth was reset; TWS re-sends the book from scratch
+    if (id >= DEPTH_REQ_ID_BASE && errorCode == 317) {
+        std::lock_guard<std::mutex> lock(depth_mutex);
+        depth_engine.reset(static_cast<int>(id - DEPTH_REQ_ID_BASE));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(data_mutex);
+    auto it = historical_requests.find(id);
+    if (it == historical_requests.end() || !it->second.issued || it->second.done) {
+        return;
+    }
+
+    HistoricalRequest& request = it->second;
+    bool pacing_violation = errorCode == 420 ||
+        (errorCode == 162 && errorString.find("acing violation") != std::string::npos);
+
+    if (pacing_violation) {
+        std::cout << "Pacing violation - retrying " << request.symbol << " after back-off" << std::endl;
+        metrics.increment(METRIC_PACING_VIOLATIONS);
+        request.issued = false;
+        dropIngest(id);
+        scheduler.onPacingViolation(id, request.key, request.paced, std::chrono::steady_clock::now());
+    } else {
+        request.error = errorString;
+        request.no_data = errorCode == 162 && errorString.find("returned no data") != std::string::npos;
+        request.done = true;
+        dropIngest(id);
+        scheduler.onCompleted(id);
+    }
 }
 
 void IBKRAutoFibClient::nextValidId(OrderId orderId) {
@@ -173,19 +968,201 @@ void IBKRAutoFibClient::nextValidId(OrderId orderId) {
     std::cout << "Next valid order ID: " << orderId << std::endl;
 }
 
+void IBKRAutoFibClient::beginIngest(int reqId) {
+    ingest_req_id = reqId;
+    ingest_arena = nullptr;
+
+    auto found = ingest_arenas.find(reqId);
+    if (found != ingest_arenas.end()) {
+        ingest_arena = &found->second;
+        return;
+    }
+
+    // Once per request: check it is still wanted and size the arena
+    size_t expected_bars;
+    {
+        std::lock_guard<std::mutex> lock(data_mutex);
+        auto it = historical_requests.find(reqId);
+        if (it == historical_requests.end() || !it->second.issued || it->second.done) {
+            return;
+        }
+        expected_bars = it->second.expected_bars;
+    }
+
+    BarArena& arena = ingest_arenas.emplace(reqId, BarArena(&bar_pool)).first->second;
+    arena.reserve(expected_bars);
+    ingest_arena = &arena;
+}
+
+BarArena IBKRAutoFibClient::dropIngest(int reqId) {
+    if (ingest_req_id == reqId) {
+        ingest_req_id = -1;
+        ingest_arena = nullptr;
+    }
+
+    BarArena arena(&bar_pool);
+    auto found = ingest_arenas.find(reqId);
+    if (found != ingest_arenas.end()) {
+        arena = std::move(found->second);
+        ingest_arenas.erase(found);
+    }
+    return arena;
+}
+
 void IBKRAutoFibClient::historicalData(TickerId reqId, const Bar& bar) {
-    std::lock_guard<std::mutex> lock(data_mutex);
+    LatencyScope scope(latency);
+    metrics.increment(METRIC_MSG_HISTORICAL_DATA);
+    if (static_cast<int>(reqId) != ingest_req_id) {
+        beginIngest(static_cast<int>(reqId));
+    }
+    if (!ingest_arena) {
+        return;
+    }
 
-    // IBKR's Bar already has the correct format
-    historical_data.push_back(bar);
+    BarRecord record;
+    if (toBarRecord(bar, record)) {
+        ingest_arena->append(record);
+        metrics.increment(METRIC_BARS_INGESTED);
+    }
 }
 
 void IBKRAutoFibClient::historicalDataEnd(int reqId, const std::string& startDateStr, const std::string& endDateStr) {
+    LatencyScope scope(latency);
+    metrics.increment(METRIC_MSG_HISTORICAL_DATA_END);
+    BarArena bars = dropIngest(reqId);
+
     std::lock_guard<std::mutex> lock(data_mutex);
-    std::cout << "Historical data received: " << historical_data.size() << " bars" << std::endl;
-    data_end_received = true;
-    data_ready = true;
-    data_cv.notify_all();
+
+    // Release arenas of requests that timed out while bars were arriving
+    for (auto found = ingest_arenas.begin(); found != ingest_arenas.end();) {
+        auto it = historical_requests.find(found->first);
+        if (it == historical_requests.end() || it->second.done) {
+            int stale_id = found->first;
+            ++found;
+            dropIngest(stale_id);
+        } else {
+            ++found;
+        }
+    }
+
+    auto it = historical_requests.find(reqId);
+    if (it == historical_requests.end() || it->second.done) {
+        return;
+    }
+
+    std::cout << "Historical data received: " << bars.size() << " bars" << std::endl;
+    it->second.bars = std::move(bars);
+    it->second.done = true;
+    scheduler.onCompleted(reqId);
+}
+
+void IBKRAutoFibClient::realtimeBar(TickerId reqId, long time, double open, double high, double low, double close,
+                                    Decimal volume, Decimal wap, int count) {
+    LatencyScope scope(latency);
+    metrics.increment(METRIC_MSG_REALTIME_BAR);
+    int slot = static_cast<int>(reqId - REALTIME_REQ_ID_BASE);
+
+    {
+        // Bars still in flight after a cancel must not move the bar
+        std::lock_guard<std::mutex> lock(realtime_mutex);
+        if (slot < 0 || slot >= static_cast<int>(realtime_bars.size()) || !live_feeds[slot].bars) {
+            return;
+        }
+
+        bool closed = realtime_bars.onRealTimeBar(
+            slot, time, open, high, low, close,
+            DecimalFunctions::decimalToDouble(volume),
+            DecimalFunctions::decimalToDouble(wap),
+            count);
+        updateLiveIndicator(slot, closed, close);
+    }
+
+    publishRealTime(slot);
+}
+
+void IBKRAutoFibClient::tickByTickAllLast(int reqId, int tickType, time_t time, double price, Decimal size,
+                                          const TickAttribLast& tickAttribLast, const std::string& exchange,
+                                          const std::string& specialConditions) {
+    LatencyScope scope(latency);
+    metrics.increment(METRIC_MSG_TICK_LAST);
+    int slot = static_cast<int>(reqId - TICK_REQ_ID_BASE);
+    bool notify;
+
+    {
+        std::lock_guard<std::mutex> lock(realtime_mutex);
+        if (!tick_ingestor.hasSymbol(slot) || !live_feeds[slot].ticks) {
+            return;
+        }
+
+        double qty = DecimalFunctions::decimalToDouble(size);
+        tick_ingestor.onLast(slot, time, price, qty);
+        bool closed = realtime_bars.onTick(slot, time, price, qty);
+        notify = updateLiveIndicator(slot, closed, price);
+    }
+
+    // Only bar completions and golden zone transitions are published at tick rate
+    if (notify) {
+        publishRealTime(slot);
+    }
+}
+
+void IBKRAutoFibClient::tickByTickBidAsk(int reqId, time_t time, double bidPrice, double askPrice,
+                                         Decimal bidSize, Decimal askSize, const TickAttribBidAsk& tickAttribBidAsk) {
+    LatencyScope scope(latency);
+    metrics.increment(METRIC_MSG_TICK_BID_ASK);
+    int slot = static_cast<int>(reqId - TICK_REQ_ID_BASE);
+
+    // Quotes are retained for consumers but do not move the bar or the indicator
+    std::lock_guard<std::mutex> lock(realtime_mutex);
+    if (!tick_ingestor.hasSymbol(slot) || !live_feeds[slot].ticks) {
+        return;
+    }
+
+    tick_ingestor.onBidAsk(slot, time, bidPrice, askPrice,
+                           DecimalFunctions::decimalToDouble(bidSize),
+                           DecimalFunctions::decimalToDouble(askSize));
+}
+
+void IBKRAutoFibClient::tickByTickMidPoint(int reqId, time_t time, double midPoint) {
+    LatencyScope scope(latency);
+    metrics.increment(METRIC_MSG_TICK_MIDPOINT);
+    int slot = static_cast<int>(reqId - TICK_REQ_ID_BASE);
+    bool notify;
+
+    {
+        std::lock_guard<std::mutex> lock(realtime_mutex);
+        if (!tick_ingestor.hasSymbol(slot) || !live_feeds[slot].ticks) {
+            return;
+        }
+
+        tick_ingestor.onMidPoint(slot, time, midPoint);
+        bool closed = realtime_bars.onTick(slot, time, midPoint, 0);
+        notify = updateLiveIndicator(slot, closed, midPoint);
+    }
+
+    if (notify) {
+        publishRealTime(slot);
+    }
+}
+
+void IBKRAutoFibClient::updateMktDepth(TickerId id, int position, int operation, int side,
+                                       double price, Decimal size) {
+    LatencyScope scope(latency);
+    metrics.increment(METRIC_MSG_MARKET_DEPTH);
+    int slot = static_cast<int>(id - DEPTH_REQ_ID_BASE);
+
+    std::lock_guard<std::mutex> lock(depth_mutex);
+    if (!depth_engine.hasSymbol(slot) || !depth_feeds[slot].active) {
+        return;
+    }
+
+    depth_engine.onDepth(slot, position, operation, side, price, DecimalFunctions::decimalToDouble(size));
+}
+
+void IBKRAutoFibClient::updateMktDepthL2(TickerId id, int position, const std::string& marketMaker, int operation,
+                                         int side, double price, Decimal size, bool isSmartDepth) {
+    // Levels are addressed by position whether or not they carry a market maker
+    updateMktDepth(id, position, operation, side, price, size);
 }
 
 void IBKRAutoFibClient::connectionClosed() {
@@ -216,15 +1193,12 @@ void IBKRAutoFibClient::bondContractDetails(int, const ContractDetails&) {}
 void IBKRAutoFibClient::contractDetailsEnd(int) {}
 void IBKRAutoFibClient::execDetails(int, const Contract&, const Execution&) {}
 void IBKRAutoFibClient::execDetailsEnd(int) {}
-void IBKRAutoFibClient::updateMktDepth(TickerId, int, int, int, double, Decimal) {}
-void IBKRAutoFibClient::updateMktDepthL2(TickerId, int, const std::string&, int, int, double, Decimal, bool) {}
 void IBKRAutoFibClient::updateNewsBulletin(int, int, const std::string&, const std::string&) {}
 void IBKRAutoFibClient::managedAccounts(const std::string&) {}
 void IBKRAutoFibClient::receiveFA(faDataType, const std::string&) {}
 void IBKRAutoFibClient::scannerParameters(const std::string&) {}
 void IBKRAutoFibClient::scannerData(int, int, const ContractDetails&, const std::string&, const std::string&, const std::string&, const std::string&) {}
 void IBKRAutoFibClient::scannerDataEnd(int) {}
-void IBKRAutoFibClient::realtimeBar(TickerId, long, double, double, double, double, Decimal, Decimal, int) {}
 void IBKRAutoFibClient::currentTime(long) {}
 void IBKRAutoFibClient::fundamentalData(TickerId, const std::string&) {}
 void IBKRAutoFibClient::deltaNeutralValidation(int, const DeltaNeutralContract&) {}
@@ -269,9 +1243,6 @@ void IBKRAutoFibClient::pnlSingle(int, Decimal, double, double, double, double)
 void IBKRAutoFibClient::historicalTicks(int, const std::vector<HistoricalTick>&, bool) {}
 void IBKRAutoFibClient::historicalTicksBidAsk(int, const std::vector<HistoricalTickBidAsk>&, bool) {}
 void IBKRAutoFibClient::historicalTicksLast(int, const std::vector<HistoricalTickLast>&, bool) {}
-void IBKRAutoFibClient::tickByTickAllLast(int, int, time_t, double, Decimal, const TickAttribLast&, const std::string&, const std::string&) {}
-void IBKRAutoFibClient::tickByTickBidAsk(int, time_t, double, double, Decimal, Decimal, const TickAttribBidAsk&) {}
-void IBKRAutoFibClient::tickByTickMidPoint(int, time_t, double) {}
 void IBKRAutoFibClient::orderBound(long long, int, int) {}
 void IBKRAutoFibClient::completedOrder(const Contract&, const Order&, const OrderState&) {}
 void IBKRAutoFibClient::completedOrdersEnd() {}
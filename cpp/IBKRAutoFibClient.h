@@ -12,27 +12,156 @@
 #include "EReaderOSSignal.h"
 #include "bar.h"
 #include "AutoFibIndicator.h"
+#include "RealTimeBarAggregator.h"
+#include "TickIngestor.h"
+#include "MarketDepthEngine.h"
+#include "HistoricalRequestScheduler.h"
+#include "HistoricalBarCache.h"
+#include "BarArena.h"
+#include "ResultPublisher.h"
+#include "SignalEventBus.h"
+#include "WireCapture.h"
+#include "WireReplay.h"
+#include "LatencyHistogram.h"
+#include "RuntimeMetrics.h"
 #include <memory>
 #include <vector>
+#include <map>
 #include <mutex>
-#include <condition_variable>
-#include <atomic>
+#include <chrono>
+#include <functional>
 
 class IBKRAutoFibClient : public EWrapper {
+public:
+    // Invoked on the message-processing thread after every 5-second bar, and on
+    // tick-by-tick data when a bar completes or golden zone membership changes
+    typedef std::function<void(const std::string& symbol, const FibonacciResults& results)> RealTimeCallback;
+
+    static const int LOOKBACK_BARS = 20;
+    static const TickerId HISTORICAL_REQ_ID_BASE = 1;       // Historical ids wrap below REALTIME_REQ_ID_BASE
+    static const TickerId REALTIME_REQ_ID_BASE = 10000;
+    static const TickerId TICK_REQ_ID_BASE = 20000;
+    static const TickerId DEPTH_REQ_ID_BASE = 30000;
+    static const std::chrono::seconds REQUEST_TIMEOUT;
+
 private:
     std::unique_ptr<EReaderOSSignal> os_signal;
     std::unique_ptr<EClientSocket> client_socket;
     std::unique_ptr<EReader> reader;
     std::unique_ptr<AutoFibIndicator> indicator;
 
-    std::vector<Bar> historical_data;
+    // Wire capture relay (connect() with capture enabled) or recorded session
+    // replacing the socket; requests are not sent while replaying
+    std::string wire_capture_path;
+    std::unique_ptr<WireCapture> wire_capture;
+    std::unique_ptr<WireReplay> replay;
+
+    // Historical data requests by reqId (guarded by data_mutex)
+    struct HistoricalRequest {
+        std::string symbol;
+        std::string secType;
+        std::string exchange;
+        std::string currency;
+        std::string duration;       // Requested span
+        std::string fetch_duration; // Span actually requested from TWS (cache top-up)
+        std::string barSize;
+        std::string whatToShow;
+        std::string key;
+        std::string cache_key;
+        std::vector<BarRecord> cached; // Cached bars the fetched tail is merged into
+        bool paced;
+        bool issued;
+        bool done;
+        bool no_data;               // Error was HMDS finding no bars, not a failure
+        std::string error;
+        std::chrono::steady_clock::time_point issued_at;
+        size_t expected_bars;       // Capacity reserved for bars when issued
+        BarArena bars;              // Handed over by historicalDataEnd()
+
+        HistoricalRequest() : paced(true), issued(false), done(false), no_data(false), expected_bars(0) {}
+    };
+
+    BarChunkPool bar_pool;
+    std::map<int, HistoricalRequest> historical_requests;
+    HistoricalRequestScheduler scheduler;
+    std::unique_ptr<HistoricalBarCache> bar_cache;
+    int next_historical_req_id;
+    int last_historical_req_id;
     std::mutex data_mutex;
-    std::condition_variable data_cv;
-    std::atomic<bool> data_ready;
-    std::atomic<bool> data_end_received;
+
+    // Bars being received per reqId. Only touched from EWrapper callbacks (the
+    // thread calling processMsgs), so historicalData() takes no lock per bar.
+    std::map<int, BarArena> ingest_arenas;
+    int ingest_req_id;
+    BarArena* ingest_arena;
+
+    // Live feeds per symbol slot (reqId = REALTIME_REQ_ID_BASE / TICK_REQ_ID_BASE + slot)
+    struct LiveFeeds {
+        bool bars;
+        bool ticks;
+        LiveFeeds() : bars(false), ticks(false) {}
+    };
+
+    RealTimeBarAggregator realtime_bars;
+    TickIngestor tick_ingestor;
+    std::vector<AutoFibIndicator> realtime_indicators;
+    std::vector<LiveFeeds> live_feeds;
+    std::map<std::string, int> realtime_slots;
+    std::mutex realtime_mutex;
+    RealTimeCallback realtime_callback;
+    double atr_filter_multiple;
+
+    // Market depth per depth slot (reqId = DEPTH_REQ_ID_BASE + slot)
+    struct DepthFeed {
+        bool active;
+        bool smart_depth;
+        DepthFeed() : active(false), smart_depth(false) {}
+    };
+
+    MarketDepthEngine depth_engine;
+    std::vector<DepthFeed> depth_feeds;
+    std::map<std::string, int> depth_slots;
+    std::mutex depth_mutex;             // Taken after realtime_mutex when both are held
+
+    // Results fan-out to other consumers (guarded by publisher_mutex)
+    struct SignalState {
+        uint32_t id;
+        int signal;                     // ResultSignal of the last published results
+    };
+
+    std::unique_ptr<ResultPublisher> result_publisher;  // One writer per slot at a time
+    std::map<std::string, SignalState> signal_states;
+    std::mutex publisher_mutex;         // Taken after realtime_mutex when both are held
+    SignalEventBus signal_bus;          // Lock-free; read without publisher_mutex
+
+    // Per-stage latency of the threads that process messages (off until enabled)
+    LatencyRecorder latency;
+
+    // Counters of the callback and request paths (always on) and their exporter,
+    // which samples the gauges on its own thread
+    MetricsRegistry metrics;
+    std::unique_ptr<MetricsExporter> metrics_exporter;
 
     int next_order_id;
 
+    // Live slot helpers (realtime_mutex must be held by the caller)
+    int liveSlot(const std::string& symbol, int barSeconds);
+    bool updateLiveIndicator(int slot, bool barClosed, double price);
+
+    void publishRealTime(int slot);
+    void publishResults(const std::string& symbol, const FibonacciResults& results);
+
+    // Historical request pipeline
+    int allocateHistoricalReqId();  // data_mutex must be held; -1 if every id is in use
+    void pumpHistoricalRequests();
+    void waitForHistoricalData(const std::vector<int>& reqIds);
+    void readMessages();            // One batch from the reader (or the due replayed messages), then depth analytics
+    BarArena takeHistoricalData(int reqId, std::string& error);   // Download arena as is when uncached
+
+    // Reader-thread ingestion helpers
+    void beginIngest(int reqId);
+    BarArena dropIngest(int reqId);
+
 public:
     IBKRAutoFibClient();
     virtual ~IBKRAutoFibClient();
@@ -42,6 +171,31 @@ public:
     void disconnect();
     bool isConnected() const;
 
+    // Record every inbound message of the next connect() to a wire log
+    void enableWireCapture(const std::string& path);
+
+    // Use a wire log instead of a connection: processMessages() decodes its
+    // messages through the normal callbacks (speed <= 0 = as fast as possible).
+    // Make the same requests in the same order as the recorded session.
+    bool openReplay(const std::string& path, double speed = 0.0);
+
+    // Persist historical bars in a directory; later requests only fetch the missing tail
+    void enableBarCache(const std::string& directory = "bar_cache");
+
+    // Publish the latest results of every symbol in a shared-memory segment
+    // that other processes read with ResultSubscriber
+    bool enableResultPublisher(const std::string& name = "/autofib_results", int maxSymbols = 256);
+
+    // Queue a historical data request; returns its reqId (-1 if too many are open)
+    int submitHistoricalRequest(
+        const std::string& symbol,
+        const std::string& secType = "STK",
+        const std::string& exchange = "SMART",
+        const std::string& currency = "USD",
+        const std::string& duration = "1 D",
+        const std::string& barSize = "5 mins"
+    );
+
     // Historical data request
     bool requestHistoricalData(
         const std::string& symbol,
@@ -52,9 +206,14 @@ public:
         const std::string& barSize = "5 mins"
     );
 
-    // Get historical data
+    // Get historical data of the most recent request (waits for it)
+    // The received buffer is moved out, so a second call returns no bars.
+    // Bar times are reported as "yyyyMMdd HH:mm:ss".
     std::vector<Bar> getHistoricalData();
 
+    // As getHistoricalData(), as numeric records without a time string per bar
+    BarArena getHistoricalRecords();
+
     // Run indicator
     FibonacciResults runIndicator(
         const std::string& symbol,
@@ -65,6 +224,87 @@ public:
         const std::string& barSize = "5 mins"
     );
 
+    // Run indicator over many symbols; requests are pipelined within IBKR pacing limits
+    std::vector<FibonacciResults> runIndicators(
+        const std::vector<std::string>& symbols,
+        const std::string& secType = "STK",
+        const std::string& exchange = "SMART",
+        const std::string& currency = "USD",
+        const std::string& duration = "1 D",
+        const std::string& barSize = "5 mins"
+    );
+
+    // Real-time bars: 5-second bars aggregated into barSize
+    bool subscribeRealTimeBars(
+        const std::string& symbol,
+        const std::string& secType = "STK",
+        const std::string& exchange = "SMART",
+        const std::string& currency = "USD",
+        const std::string& barSize = "5 mins",
+        const std::string& whatToShow = "TRADES"
+    );
+    void cancelRealTimeBars(const std::string& symbol);
+
+    // Tick-by-tick data: trades/midpoints move the in-progress bar and the
+    // indicator's current price; all ticks are kept in a per-symbol ring buffer
+    bool subscribeTickByTick(
+        const std::string& symbol,
+        const std::string& secType = "STK",
+        const std::string& exchange = "SMART",
+        const std::string& currency = "USD",
+        const std::string& tickType = "AllLast",
+        const std::string& barSize = "5 mins"
+    );
+    void cancelTickByTick(const std::string& symbol);
+
+    // Copy the retained ticks of a symbol (oldest first); returns the count copied
+    size_t getRecentTicks(const std::string& symbol, std::vector<TickRecord>& out);
+
+    // Level-2 market depth: TWS depth operations maintain a native order book
+    bool subscribeMarketDepth(
+        const std::string& symbol,
+        const std::string& secType = "STK",
+        const std::string& exchange = "SMART",
+        const std::string& currency = "USD",
+        int numRows = 10,
+        bool smartDepth = true
+    );
+    void cancelMarketDepth(const std::string& symbol);
+
+    // Copy the current order book of a subscribed symbol; false if not subscribed
+    bool getOrderBook(const std::string& symbol, OrderBook& out);
+
+    // Copy the latest depth analytics of a subscribed symbol; false if not subscribed
+    bool getDepthSignals(const std::string& symbol, DepthSignals& out);
+
+    // Load depth score weights ("MLSpreadWeight = 1000" lines); false if the file is invalid
+    bool loadDepthScorerWeights(const std::string& path);
+
+    // Copy the recent iceberg refills of all depth symbols (oldest first); returns the count copied
+    size_t getIcebergEvents(std::vector<IcebergEvent>& out);
+
+    // Latest real-time indicator results for a subscribed symbol
+    FibonacciResults getRealTimeResults(const std::string& symbol);
+
+    // Live signals need a swing of at least multiple * ATR of the live bars (0 disables)
+    void setAtrFilter(double multiple);
+    void setRealTimeCallback(RealTimeCallback callback);
+
+    // Signal transitions of every symbol (historical and live). Each
+    // subscription polls its own cursor and never blocks the client.
+    SignalSubscription subscribeSignals() { return signal_bus.subscribe(); }
+
+    // Record decode, callback, indicator, publish and end-to-end latencies of
+    // the data callbacks; latencyReport() gives count/p50/p99/p99.9/max per stage
+    void enableLatencyTracking(bool enabled = true) { latency.setEnabled(enabled); }
+    std::string latencyReport() const { return latency.report(); }
+
+    // Export message, bar, calculation, error and queue-depth metrics as
+    // Prometheus text on http://127.0.0.1:httpPort/metrics (< 0 = no endpoint)
+    // and/or to a stats file rewritten every intervalSeconds (empty = no file)
+    bool enableMetrics(int httpPort = 9464, const std::string& statsFile = "", int intervalSeconds = 10);
+    std::string metricsText() const { return metrics.format(); }
+
     // Process messages
     void processMessages();
 
@@ -0,0 +1,123 @@
+/**
+ * Iceberg Detector Implementation
+ */
+
+#include "IcebergDetector.h"
+#include <algorithm>
+#include <cmath>
+
+IcebergDetector::IcebergDetector(const IcebergConfig& icebergConfig)
+    : config(icebergConfig) {
+    config.max_levels = std::max(0, std::min(config.max_levels, OrderBook::MAX_LEVELS));
+    reset();
+}
+
+void IcebergDetector::reset() {
+    sides[BOOK_SIDE_ASK].count = 0;
+    sides[BOOK_SIDE_BID].count = 0;
+    gone[BOOK_SIDE_ASK].count = 0;
+    gone[BOOK_SIDE_BID].count = 0;
+}
+
+void IcebergDetector::update(const OrderBook& book, int64_t timeMs, int slot,
+                             std::vector<double>& bidIcebergs, std::vector<double>& askIcebergs,
+                             TickRingBuffer<IcebergEvent>& events) {
+    bidIcebergs.clear();
+    askIcebergs.clear();
+
+    int book_levels = book.levels(BOOK_SIDE_BID) + book.levels(BOOK_SIDE_ASK);
+    double avg_book_volume = (book.totalSize(BOOK_SIDE_BID) + book.totalSize(BOOK_SIDE_ASK)) /
+                             std::max(1, book_levels);
+    double large = avg_book_volume * config.size_multiple;
+    double tol = config.volume_tolerance;
+
+    for (int side = BOOK_SIDE_ASK; side <= BOOK_SIDE_BID; ++side) {
+        const Levels& prev = sides[side];
+        const Levels& prev_gone = gone[side];
+        Levels next;
+        Levels next_gone;
+        next.count = std::min(book.levels(side), config.max_levels);
+        next_gone.count = 0;
+        std::vector<double>& icebergs = side == BOOK_SIDE_BID ? bidIcebergs : askIcebergs;
+
+        // Remember a level that left the book with the size it held
+        auto remove = [&next_gone](const Level& level) {
+            Level& removed = next_gone.level[next_gone.count++];
+            removed = level;
+            removed.peak = std::max(level.peak, level.size);
+            removed.size = 0;
+        };
+
+        // Both snapshots are in book order, so prices are matched with one merge pass
+        int j = 0;
+        for (int i = 0; i < next.count; ++i) {
+            double price = book.price(side, i);
+            double size = book.size(side, i);
+
+            while (j < prev.count && (side == BOOK_SIDE_BID ? prev.level[j].price > price
+                                                            : prev.level[j].price < price)) {
+                remove(prev.level[j++]);
+            }
+            const Level* seen = nullptr;
+            if (j < prev.count && prev.level[j].price == price) {
+                seen = &prev.level[j++];
+            } else {
+                // Back at a price that was hit in full by the last update
+                for (int k = 0; k < prev_gone.count; ++k) {
+                    if (prev_gone.level[k].price == price) {
+                        seen = &prev_gone.level[k];
+                        break;
+                    }
+                }
+            }
+
+            Level& level = next.level[i];
+            level.price = price;
+            level.size = size;
+            level.peak = 0;
+            level.refills = 0;
+            if (!seen) {
+                continue;
+            }
+            level.peak = seen->peak;
+            level.refills = seen->refills;
+
+            // Large size that held at the same price since the last update
+            if (size > large && seen->size > 0 && std::fabs(size - seen->size) / size <= tol) {
+                icebergs.push_back(price);
+            }
+
+            if (size < seen->size * (1 - tol)) {
+                // Hit: remember what the level held before
+                level.peak = std::max(seen->peak, seen->size);
+            } else if (seen->peak > 0 && size > 0 && std::fabs(size - seen->peak) / size <= tol) {
+                // Refilled to its earlier size
+                level.peak = 0;
+                ++level.refills;
+                if (size > large) {
+                    IcebergEvent event;
+                    event.time_ms = timeMs;
+                    event.slot = slot;
+                    event.side = side;
+                    event.price = price;
+                    event.size = size;
+                    event.refills = level.refills;
+                    events.push(event);
+                }
+            }
+        }
+
+        // Unmatched levels beyond the last one were removed too, unless the
+        // book is deeper than the levels examined (they only moved out of view)
+        if (next.count < config.max_levels) {
+            while (j < prev.count) {
+                remove(prev.level[j++]);
+            }
+        }
+
+        sides[side].count = next.count;
+        std::copy(next.level, next.level + next.count, sides[side].level);
+        gone[side].count = next_gone.count;
+        std::copy(next_gone.level, next_gone.level + next_gone.count, gone[side].level);
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * Iceberg Detector
+ * Iceberg-order detection on the native depth book
+ * (port of the iceberg logic in OnBookEvent of MarketDepthIndicator_Fixed.mq5)
+ */
+
+#ifndef ICEBERG_DETECTOR_H
+#define ICEBERG_DETECTOR_H
+
+#include "OrderBook.h"
+#include "TickRingBuffer.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Iceberg parameters (MQL5 input IcebergVolumeTolerance)
+ */
+struct IcebergConfig {
+    double volume_tolerance;    // Relative size change still counted as "the same size"
+    double size_multiple;       // Level must exceed this multiple of the average level size
+    int max_levels;             // Levels examined per side, from the touch
+
+    IcebergConfig() : volume_tolerance(0.05), size_multiple(2.0), max_levels(10) {}
+};
+
+/**
+ * A large level that was hit and refilled to its previous size
+ */
+struct IcebergEvent {
+    int64_t time_ms;
+    int slot;           // Depth slot of the symbol
+    int side;           // BookSide
+    double price;
+    double size;
+    int refills;        // Refills seen at this price so far
+};
+
+/**
+ * Iceberg Detector
+ * Tracks the top levels of each side by price (not position), so a level keeps
+ * its history when levels above it come and go. A level that is hit in full
+ * leaves the book; it is remembered for one update, so a refill at the same
+ * price still counts. State is a fixed array per side; updates never allocate.
+ */
+class IcebergDetector {
+private:
+    struct Level {
+        double price;
+        double size;
+        double peak;        // Size before the level was last hit, 0 if not hit
+        int refills;
+    };
+
+    struct Levels {
+        Level level[OrderBook::MAX_LEVELS];
+        int count;
+    };
+
+    IcebergConfig config;
+    Levels sides[2];
+    Levels gone[2];         // Levels removed by the last update (peak = size before removal)
+
+public:
+    explicit IcebergDetector(const IcebergConfig& icebergConfig = IcebergConfig());
+
+    /**
+     * Compare the book with the previous update
+     * @param book Current book
+     * @param timeMs Monotonic time in milliseconds (stamped on events)
+     * @param slot Depth slot (stamped on events)
+     * @param bidIcebergs Receives bid prices whose large size held within tolerance
+     * @param askIcebergs Receives ask prices whose large size held within tolerance
+     * @param events Receives an event for every large level that was refilled
+     */
+    void update(const OrderBook& book, int64_t timeMs, int slot,
+                std::vector<double>& bidIcebergs, std::vector<double>& askIcebergs,
+                TickRingBuffer<IcebergEvent>& events);
+
+    void reset();
+};
+
+#endif // ICEBERG_DETECTOR_H
@@ -0,0 +1,66 @@
+/**
+ * Internal Utilities
+ * Small POSIX helpers shared by the implementation files (not part of any
+ * public interface)
+ */
+
+#ifndef INTERNAL_UTIL_H
+#define INTERNAL_UTIL_H
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * Monotonic clock in nanoseconds
+ */
+inline int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Store message in error if the caller asked for one
+ */
+inline void setError(std::string* error, const std::string& message) {
+    if (error) {
+        *error = message;
+    }
+}
+
+/**
+ * Send all of data, retrying after interrupts and short writes
+ * @return false once the socket fails
+ */
+inline bool sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * Map the first bytes of fd and close it; the mapping stays valid after the
+ * descriptor is closed
+ * @return The mapping, or MAP_FAILED with errno from mmap()
+ */
+inline void* mapAndClose(int fd, size_t bytes, int prot, int flags) {
+    void* addr = ::mmap(nullptr, bytes, prot, flags, fd, 0);
+    int map_errno = errno;
+    ::close(fd);
+    errno = map_errno;
+    return addr;
+}
+
+#endif // INTERNAL_UTIL_H
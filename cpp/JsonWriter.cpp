@@ -0,0 +1,251 @@
+/**
+ * JSON Writer Implementation
+ */
+
+#include "JsonWriter.h"
+#include "AutoFibIndicator.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+const int JsonWriter::MAX_DEPTH;
+
+JsonWriter::JsonWriter(size_t initialCapacity)
+    : buffer(new char[initialCapacity > 0 ? initialCapacity : 1]), length(0),
+      capacity(initialCapacity > 0 ? initialCapacity : 1), depth(0), after_key(false) {
+    first[0] = true;
+}
+
+void JsonWriter::clear() {
+    length = 0;
+    depth = 0;
+    first[0] = true;
+    after_key = false;
+}
+
+void JsonWriter::grow(size_t needed) {
+    size_t grown = std::max(needed, capacity * 2);
+    std::unique_ptr<char[]> larger(new char[grown]);
+    std::memcpy(larger.get(), buffer.get(), length);
+    buffer = std::move(larger);
+    capacity = grown;
+}
+
+void JsonWriter::separator() {
+    if (after_key) {
+        after_key = false;
+        return;
+    }
+    if (!first[depth]) {
+        put(',');
+    }
+    first[depth] = false;
+}
+
+void JsonWriter::appendEscaped(const char* text, size_t count) {
+    static const char HEX[] = "0123456789abcdef";
+
+    // Worst case every byte becomes \u00XX
+    char* out = reserve(count * 6 + 2);
+    char* start = out;
+    *out++ = '"';
+    for (size_t i = 0; i < count; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            *out++ = static_cast<char>(c);
+            continue;
+        }
+
+        *out++ = '\\';
+        switch (c) {
+            case '"': *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '\n': *out++ = 'n'; break;
+            case '\r': *out++ = 'r'; break;
+            case '\t': *out++ = 't'; break;
+            default:
+                *out++ = 'u';
+                *out++ = '0';
+                *out++ = '0';
+                *out++ = HEX[c >> 4];
+                *out++ = HEX[c & 0xF];
+        }
+    }
+    *out++ = '"';
+    length += out - start;
+}
+
+void JsonWriter::beginObject() {
+    separator();
+    put('{');
+    if (depth + 1 < MAX_DEPTH) {
+        ++depth;
+    }
+    first[depth] = true;
+}
+
+void JsonWriter::endObject() {
+    put('}');
+    if (depth > 0) {
+        --depth;
+    }
+}
+
+void JsonWriter::beginArray() {
+    separator();
+    put('[');
+    if (depth + 1 < MAX_DEPTH) {
+        ++depth;
+    }
+    first[depth] = true;
+}
+
+void JsonWriter::endArray() {
+    put(']');
+    if (depth > 0) {
+        --depth;
+    }
+}
+
+void JsonWriter::key(const char* name) {
+    separator();
+    appendEscaped(name, std::strlen(name));
+    put(':');
+    after_key = true;
+}
+
+void JsonWriter::value(const char* text) {
+    separator();
+    appendEscaped(text, std::strlen(text));
+}
+
+void JsonWriter::value(const std::string& text) {
+    separator();
+    appendEscaped(text.data(), text.size());
+}
+
+void JsonWriter::value(double number) {
+    separator();
+    if (!std::isfinite(number)) {
+        append("null", 4);
+        return;
+    }
+
+    char* out = reserve(32);
+
+    // Prices have few decimals: print them from a scaled integer when that
+    // round-trips exactly (below 1e7 at most one 8-decimal string maps to a double)
+    double magnitude = std::fabs(number);
+    if (magnitude < 1e7 && (magnitude >= 1e-3 || magnitude == 0)) {
+        long long scaled = static_cast<long long>(magnitude * 1e8 + 0.5);
+        if (static_cast<double>(scaled) / 1e8 == magnitude) {
+            if (std::signbit(number)) {
+                *out++ = '-';
+            }
+            out = std::to_chars(out, out + 24, scaled / 100000000).ptr;
+
+            long long fraction = scaled % 100000000;
+            if (fraction != 0) {
+                *out++ = '.';
+                for (int digit = 7; digit >= 0; --digit) {
+                    out[digit] = static_cast<char>('0' + fraction % 10);
+                    fraction /= 10;
+                }
+                out += 8;
+                while (out[-1] == '0') {
+                    --out;
+                }
+            }
+            length = out - buffer.get();
+            return;
+        }
+    }
+
+    // Shortest round-trip form is at most 24 characters
+    length = std::to_chars(out, out + 32, number).ptr - buffer.get();
+}
+
+void JsonWriter::value(long long number) {
+    separator();
+    char* out = reserve(24);
+    length = std::to_chars(out, out + 24, number).ptr - buffer.get();
+}
+
+void JsonWriter::value(bool flag) {
+    separator();
+    if (flag) {
+        append("true", 4);
+    } else {
+        append("false", 5);
+    }
+}
+
+void JsonWriter::null() {
+    separator();
+    append("null", 4);
+}
+
+void writeResultsJSON(JsonWriter& json, const std::string& symbol, const FibonacciResults& results,
+                      const char* signal) {
+    json.beginObject();
+    if (!symbol.empty()) {
+        json.key("symbol");
+        json.value(symbol);
+    }
+
+    if (!results.error.empty()) {
+        json.key("error");
+        json.value(results.error);
+        json.key("signal");
+        json.value(signal);
+        json.endObject();
+        return;
+    }
+
+    json.key("timestamp");
+    json.value(results.timestamp);
+    json.key("trend");
+    json.value(results.trend);
+    json.key("high_value");
+    json.value(results.high_value);
+    json.key("low_value");
+    json.value(results.low_value);
+    json.key("high_time");
+    json.value(results.high_time);
+    json.key("low_time");
+    json.value(results.low_time);
+    json.key("high_bar_index");
+    json.value(results.high_bar_index);
+    json.key("low_bar_index");
+    json.value(results.low_bar_index);
+    json.key("fibo_range");
+    json.value(results.fibo_range);
+
+    json.key("fibo_levels");
+    json.beginObject();
+    for (const auto& level : results.fibo_levels) {
+        json.key(level.first.c_str());
+        json.value(level.second);
+    }
+    json.endObject();
+
+    json.key("golden_zone");
+    json.beginObject();
+    json.key("low");
+    json.value(results.golden_zone_low);
+    json.key("high");
+    json.value(results.golden_zone_high);
+    json.endObject();
+
+    json.key("current_price");
+    json.value(results.current_price);
+    json.key("price_in_golden_zone");
+    json.value(results.price_in_golden_zone);
+    json.key("atr");
+    json.value(results.atr);
+    json.key("range_below_atr");
+    json.value(results.range_below_atr);
+    json.key("signal");
+    json.value(signal);
+    json.endObject();
+}
@@ -0,0 +1,99 @@
+/**
+ * JSON Writer
+ * Streaming JSON serializer writing into a reusable byte buffer
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+
+struct FibonacciResults;
+
+/**
+ * JSON Writer
+ * Output is compact JSON. Doubles use the shortest text that parses back to
+ * the same value (std::to_chars, independent of the C locale), -0 included;
+ * NaN and infinities are written as null. clear() keeps the buffer, so a writer that
+ * is reused does not allocate once it has grown to the largest document.
+ * Nesting is limited to MAX_DEPTH levels.
+ */
+class JsonWriter {
+public:
+    static const int MAX_DEPTH = 16;
+
+private:
+    std::unique_ptr<char[]> buffer;
+    size_t length;
+    size_t capacity;
+    bool first[MAX_DEPTH];      // No member written yet at this nesting level
+    int depth;
+    bool after_key;             // A key was written and awaits its value
+
+    void grow(size_t needed);
+
+    // Room for `count` more bytes; returns where they go
+    char* reserve(size_t count) {
+        if (length + count > capacity) {
+            grow(length + count);
+        }
+        return buffer.get() + length;
+    }
+
+    void put(char c) { *reserve(1) = c; ++length; }
+    void append(const char* text, size_t count) {
+        std::memcpy(reserve(count), text, count);
+        length += count;
+    }
+
+    void separator();
+    void appendEscaped(const char* text, size_t count);
+
+public:
+    explicit JsonWriter(size_t initialCapacity = 4096);
+
+    /**
+     * Discard the document, keeping the buffer's capacity
+     */
+    void clear();
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /**
+     * Write an object key; the next call writes its value
+     */
+    void key(const char* name);
+
+    void value(const char* text);
+    void value(const std::string& text);
+    void value(double number);
+    void value(long long number);
+    void value(int number) { value(static_cast<long long>(number)); }
+    void value(bool flag);
+    void null();
+
+    /**
+     * The document so far (not NUL-terminated)
+     */
+    const char* data() const { return buffer.get(); }
+    size_t size() const { return length; }
+    std::string str() const { return std::string(buffer.get(), length); }
+};
+
+/**
+ * Write a results object with every FibonacciResults field
+ * @param json Writer positioned where a value is expected
+ * @param symbol Symbol name, omitted if empty
+ * @param results Indicator results
+ * @param signal Trading signal ("BUY", "SELL", "HOLD" or "NO_DATA")
+ */
+void writeResultsJSON(JsonWriter& json, const std::string& symbol, const FibonacciResults& results,
+                      const char* signal);
+
+#endif // JSON_WRITER_H
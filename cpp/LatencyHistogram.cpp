@@ -0,0 +1,189 @@
+/**
+ * Latency Histogram Implementation
+ */
+
+#include "LatencyHistogram.h"
+#include <cmath>
+#include <cstdio>
+
+const int LatencyHistogram::SUB_BUCKET_BITS;
+const size_t LatencyHistogram::SUB_BUCKETS;
+const size_t LatencyHistogram::BUCKET_COUNT;
+
+namespace {
+
+void addRelaxed(std::atomic<uint64_t>& target, uint64_t value) {
+    target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // namespace
+
+const char* latencyStageName(int stage) {
+    switch (stage) {
+        case LATENCY_DECODE: return "decode";
+        case LATENCY_CALLBACK: return "callback";
+        case LATENCY_INDICATOR: return "indicator";
+        case LATENCY_PUBLISH: return "publish";
+        case LATENCY_END_TO_END: return "end-to-end";
+        default: return "unknown";
+    }
+}
+
+LatencyHistogram::LatencyHistogram() {
+    clear();
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < 2 * SUB_BUCKETS) {
+        return index;
+    }
+    size_t shift = index / SUB_BUCKETS - 1;
+    uint64_t lower = static_cast<uint64_t>(index - shift * SUB_BUCKETS) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::add(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        uint64_t count = other.counts[i].load(std::memory_order_relaxed);
+        if (count > 0) {
+            addRelaxed(counts[i], count);
+        }
+    }
+    addRelaxed(total, other.total.load(std::memory_order_relaxed));
+    addRelaxed(sum_ns, other.sum_ns.load(std::memory_order_relaxed));
+    uint64_t other_max = other.max_ns.load(std::memory_order_relaxed);
+    if (other_max > max_ns.load(std::memory_order_relaxed)) {
+        max_ns.store(other_max, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::clear() {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sum_ns.store(0, std::memory_order_relaxed);
+    max_ns.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return n > 0 ? static_cast<double>(sum_ns.load(std::memory_order_relaxed)) / static_cast<double>(n) : 0.0;
+}
+
+int64_t LatencyHistogram::percentile(double fraction) const {
+    // Buckets are summed rather than trusting total, which a concurrent record may be ahead of
+    uint64_t n = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        n += counts[i].load(std::memory_order_relaxed);
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(n)));
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // The bucket bound may overshoot the largest value actually seen
+            int64_t bound = static_cast<int64_t>(bucketUpperBound(i));
+            return bound < max() ? bound : max();
+        }
+    }
+    return max();
+}
+
+LatencyRecorder::LatencyRecorder()
+    : active(false) {
+}
+
+void LatencyRecorder::markBatch() {
+    if (enabled()) {
+        threads.local().mark_ns = now();
+    }
+}
+
+int64_t LatencyRecorder::beginCallback() {
+    if (!enabled()) {
+        return -1;
+    }
+
+    ThreadLatency& thread = threads.local();
+    int64_t start = now();
+    if (thread.mark_ns >= 0) {
+        thread.stages[LATENCY_DECODE].record(start - thread.mark_ns);
+        thread.message_ns = thread.mark_ns;
+    } else {
+        thread.message_ns = start;
+    }
+    return start;
+}
+
+void LatencyRecorder::endCallback(int64_t start) {
+    if (start < 0) {
+        return;
+    }
+
+    ThreadLatency& thread = threads.local();
+    int64_t end = now();
+    thread.stages[LATENCY_CALLBACK].record(end - start);
+
+    // Decoding of the next message in the batch starts here
+    thread.mark_ns = end;
+    thread.message_ns = -1;
+}
+
+void LatencyRecorder::recordSince(int stage, int64_t start) {
+    if (start >= 0 && stage >= 0 && stage < LATENCY_STAGE_COUNT) {
+        threads.local().stages[stage].record(now() - start);
+    }
+}
+
+void LatencyRecorder::recordPublished() {
+    if (!enabled()) {
+        return;
+    }
+
+    ThreadLatency& thread = threads.local();
+    if (thread.message_ns >= 0) {
+        thread.stages[LATENCY_END_TO_END].record(now() - thread.message_ns);
+    }
+}
+
+void LatencyRecorder::snapshot(int stage, LatencyHistogram& out) const {
+    out.clear();
+    if (stage < 0 || stage >= LATENCY_STAGE_COUNT) {
+        return;
+    }
+
+    threads.forEach([&](const ThreadLatency& thread) {
+        out.add(thread.stages[stage]);
+    });
+}
+
+std::string LatencyRecorder::report() const {
+    std::unique_ptr<LatencyHistogram> merged = std::make_unique<LatencyHistogram>();
+    char line[160];
+
+    std::snprintf(line, sizeof(line), "%-12s %12s %10s %10s %10s %10s %10s\n",
+                  "stage (us)", "count", "mean", "p50", "p99", "p99.9", "max");
+    std::string text = line;
+
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; ++stage) {
+        snapshot(stage, *merged);
+        std::snprintf(line, sizeof(line), "%-12s %12llu %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+                      latencyStageName(stage),
+                      static_cast<unsigned long long>(merged->count()),
+                      merged->mean() / 1000.0,
+                      merged->percentile(0.5) / 1000.0,
+                      merged->percentile(0.99) / 1000.0,
+                      merged->percentile(0.999) / 1000.0,
+                      merged->max() / 1000.0);
+        text += line;
+    }
+    return text;
+}
@@ -0,0 +1,193 @@
+/**
+ * Latency Histogram
+ * Per-thread, lock-free latency recording of the message-processing stages
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include "ThreadSlots.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * Stages of a message, from the reader's queue to the published signal
+ */
+enum LatencyStage {
+    LATENCY_DECODE = 0,         // Batch start (or previous callback end) to callback entry
+    LATENCY_CALLBACK = 1,       // Callback entry to exit, including the stages below
+    LATENCY_INDICATOR = 2,      // Indicator calculate()/updatePrice()
+    LATENCY_PUBLISH = 3,        // Shared-memory slot and signal event
+    LATENCY_END_TO_END = 4,     // Decode start to publish end, for messages that publish
+    LATENCY_STAGE_COUNT = 5
+};
+
+const char* latencyStageName(int stage);
+
+/**
+ * Latency Histogram
+ * Log-linear buckets in the style of HdrHistogram: every power of two is
+ * split into 64 linear sub-buckets, so any value from 1 ns up is kept with
+ * under 1.6% relative error in a fixed 30 KB. One thread records; any thread
+ * may read concurrently (counts are relaxed atomics, so a reader may see a
+ * value a few records out of date but never a torn one).
+ */
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 6;
+    static const size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static const size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;     // Up to 2^64 - 1
+
+private:
+    std::atomic<uint64_t> counts[BUCKET_COUNT];
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> sum_ns;
+    std::atomic<uint64_t> max_ns;
+
+public:
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        // value >> shift keeps the top SUB_BUCKET_BITS + 1 bits: 64..127
+        int shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+        return static_cast<size_t>(shift) * SUB_BUCKETS + static_cast<size_t>(value >> shift);
+    }
+
+    // Largest value that falls into a bucket
+    static uint64_t bucketUpperBound(size_t index);
+
+    /**
+     * Record one latency (single writer; negative values count as 0)
+     */
+    void record(int64_t ns) {
+        uint64_t value = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+        std::atomic<uint64_t>& count = counts[bucketIndex(value)];
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sum_ns.store(sum_ns.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        if (value > max_ns.load(std::memory_order_relaxed)) {
+            max_ns.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Add the counts of another histogram (the merging thread must be the only writer of this one)
+     */
+    void add(const LatencyHistogram& other);
+    void clear();
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    int64_t max() const { return static_cast<int64_t>(max_ns.load(std::memory_order_relaxed)); }
+    double mean() const;
+
+    /**
+     * Smallest recorded bucket bound below which the given fraction of values lie
+     * @param fraction 0.5 = p50, 0.999 = p99.9
+     */
+    int64_t percentile(double fraction) const;
+};
+
+/**
+ * Latency Recorder
+ * Every thread that records gets its own set of stage histograms on first
+ * use (one mutex acquisition per thread); after that recording is a
+ * thread-local lookup, a clock read and a few relaxed stores. Reports merge
+ * the per-thread histograms on demand. Disabled recorders cost one relaxed
+ * load per call.
+ */
+class LatencyRecorder {
+private:
+    struct ThreadLatency {
+        LatencyHistogram stages[LATENCY_STAGE_COUNT];
+        int64_t mark_ns;            // Where decoding of the next message started
+        int64_t message_ns;         // Decode start of the message in its callback, -1 outside
+
+        ThreadLatency() : mark_ns(-1), message_ns(-1) {}
+    };
+
+    std::atomic<bool> active;
+    ThreadSlots<ThreadLatency> threads;
+
+public:
+    LatencyRecorder();
+
+    LatencyRecorder(const LatencyRecorder&) = delete;
+    LatencyRecorder& operator=(const LatencyRecorder&) = delete;
+
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void setEnabled(bool enabled) { active.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * Start time for recordSince(), or -1 when disabled
+     */
+    int64_t begin() const { return enabled() ? now() : -1; }
+
+    /**
+     * Messages are about to be decoded on this thread
+     */
+    void markBatch();
+
+    /**
+     * A callback was entered: records the decode stage
+     * @return Entry time, or -1 when disabled
+     */
+    int64_t beginCallback();
+
+    /**
+     * The callback entered at start returns: records the callback stage
+     */
+    void endCallback(int64_t start);
+
+    /**
+     * Record the time since start (from now()) for a stage; start < 0 is ignored
+     */
+    void recordSince(int stage, int64_t start);
+
+    /**
+     * Results of the current message were published: records the end-to-end stage
+     */
+    void recordPublished();
+
+    /**
+     * Merge one stage of every thread
+     */
+    void snapshot(int stage, LatencyHistogram& out) const;
+
+    /**
+     * Table of count, p50, p99, p99.9 and max per stage, in microseconds
+     */
+    std::string report() const;
+};
+
+/**
+ * Times one EWrapper callback
+ */
+class LatencyScope {
+private:
+    LatencyRecorder& recorder;
+    int64_t start;
+
+public:
+    explicit LatencyScope(LatencyRecorder& latency) : recorder(latency), start(latency.beginCallback()) {}
+    ~LatencyScope() { recorder.endCallback(start); }
+
+    LatencyScope(const LatencyScope&) = delete;
+    LatencyScope& operator=(const LatencyScope&) = delete;
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,133 @@
+/**
+ * Market Depth Engine Implementation
+ */
+
+#include "MarketDepthEngine.h"
+#include <algorithm>
+
+void DepthSignals::clear() {
+    bid_clusters.clear();
+    ask_clusters.clear();
+    velocity = 0;
+    velocity_alert = false;
+    liquidation_spike = false;
+    imbalance_range = 0;
+    imbalance = DepthImbalance();
+    bid_icebergs.clear();
+    ask_icebergs.clear();
+    ml_score = 0;
+    ml_prediction = PREDICTION_NEUTRAL;
+}
+
+MarketDepthEngine::MarketDepthEngine(const DepthConfig& depthConfig)
+    : config(depthConfig), iceberg_events(1024), scorer(depthConfig.scorer) {
+}
+
+int MarketDepthEngine::addSymbol(const std::string& symbol) {
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        if (symbols[i] == symbol) {
+            return static_cast<int>(i);
+        }
+    }
+
+    books.push_back(std::make_unique<OrderBook>());
+    symbols.push_back(symbol);
+    slot_signals.push_back(DepthSignals());
+    flows.push_back(OrderFlowDetector(config.flow));
+    icebergs.push_back(IcebergDetector(config.icebergs));
+    scorer.addSlot();
+    slot_atr.push_back(0);
+    dirty.push_back(0);
+    last_analysis_ms.push_back(-1);
+    return static_cast<int>(books.size()) - 1;
+}
+
+bool MarketDepthEngine::onDepth(int slot, int position, int operation, int side, double price, double size) {
+    if (!hasSymbol(slot)) {
+        return false;
+    }
+    if (!books[slot]->apply(position, operation, side, price, size)) {
+        return false;
+    }
+
+    dirty[slot] = 1;
+    return true;
+}
+
+int MarketDepthEngine::runAnalytics(int64_t nowMs) {
+    int analysed = 0;
+    for (int slot = 0; slot < size(); ++slot) {
+        if (!dirty[slot]) {
+            continue;
+        }
+        if (last_analysis_ms[slot] >= 0 && nowMs - last_analysis_ms[slot] < config.update_interval_ms) {
+            continue;
+        }
+
+        analyze(slot, nowMs);
+        dirty[slot] = 0;
+        last_analysis_ms[slot] = nowMs;
+        ++analysed;
+    }
+
+    if (analysed > 0) {
+        scoreAll();
+    }
+    return analysed;
+}
+
+void MarketDepthEngine::reset(int slot) {
+    if (hasSymbol(slot)) {
+        books[slot]->clear();
+        flows[slot].reset();
+        icebergs[slot].reset();
+        scorer.clear(slot);
+        slot_signals[slot].clear();
+        dirty[slot] = 0;
+    }
+}
+
+void MarketDepthEngine::setAtr(int slot, double atr) {
+    if (hasSymbol(slot)) {
+        slot_atr[slot] = atr;
+    }
+}
+
+void MarketDepthEngine::scoreAll() {
+    scorer.scoreAll();
+    for (int slot = 0; slot < size(); ++slot) {
+        slot_signals[slot].ml_score = scorer.score(slot);
+        slot_signals[slot].ml_prediction = scorer.prediction(slot);
+    }
+}
+
+void MarketDepthEngine::setScorerWeights(const ScorerWeights& weights) {
+    config.scorer = weights;
+    scorer.setWeights(weights);
+}
+
+void MarketDepthEngine::analyze(int slot, int64_t timestampMs) {
+    const OrderBook& book = *books[slot];
+    DepthSignals& signals = slot_signals[slot];
+
+    // Cluster vectors keep their capacity, so this does not allocate once warm
+    detectClusters(book, BOOK_SIDE_BID, config.clusters, signals.bid_clusters);
+    detectClusters(book, BOOK_SIDE_ASK, config.clusters, signals.ask_clusters);
+
+    // GetDynamicRange(): half the ATR, never narrower than min_range
+    double range = std::max(slot_atr[slot] * config.imbalance.atr_factor, config.imbalance.min_range);
+    signals.imbalance_range = range;
+    computeImbalance(book, range, config.imbalance, signals.imbalance);
+
+    OrderFlowDetector& flow = flows[slot];
+    flow.onSnapshot(book.totalSize(BOOK_SIDE_BID) + book.totalSize(BOOK_SIDE_ASK), timestampMs);
+    signals.velocity = flow.velocity();
+    signals.velocity_alert = flow.velocityAlert();
+    signals.liquidation_spike = flow.liquidationSpike();
+
+    // Scored later with the other symbols in scoreAll()
+    scorer.setFeatures(slot, book, range, signals.imbalance, signals.velocity);
+
+    icebergs[slot].update(book, timestampMs, slot, signals.bid_icebergs, signals.ask_icebergs,
+                          iceberg_events);
+}
@@ -0,0 +1,134 @@
+/**
+ * Market Depth Engine
+ * Per-symbol Level-2 order books fed by IBKR market depth callbacks
+ */
+
+#ifndef MARKET_DEPTH_ENGINE_H
+#define MARKET_DEPTH_ENGINE_H
+
+#include "OrderBook.h"
+#include "DepthClusters.h"
+#include "DepthImbalance.h"
+#include "OrderFlowDetector.h"
+#include "IcebergDetector.h"
+#include "DepthScorer.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Depth analytics parameters (inputs of MarketDepthIndicator_Fixed.mq5)
+ */
+struct DepthConfig {
+    ClusterConfig clusters;
+    OrderFlowConfig flow;
+    ImbalanceConfig imbalance;
+    IcebergConfig icebergs;
+    ScorerWeights scorer;
+    int64_t update_interval_ms;     // Minimum spacing of a symbol's analytics (MQL5 UpdateInterval)
+
+    DepthConfig() : update_interval_ms(1000) {}
+};
+
+/**
+ * Depth analytics of one symbol, refreshed by runAnalytics() after its book changed
+ */
+struct DepthSignals {
+    std::vector<double> bid_clusters;   // Cluster prices, best first
+    std::vector<double> ask_clusters;
+    double velocity;                    // Smoothed change of total book size (size/sec)
+    bool velocity_alert;
+    bool liquidation_spike;
+    double imbalance_range;             // Window around the midpoint used for imbalance
+    DepthImbalance imbalance;           // Volume imbalance and depth scores
+    std::vector<double> bid_icebergs;   // Large levels whose size held at the same price
+    std::vector<double> ask_icebergs;
+    double ml_score;                    // Linear score, all symbols scored in one batch
+    int ml_prediction;                  // DepthPrediction of ml_score
+
+    DepthSignals() : velocity(0), velocity_alert(false), liquidation_spike(false), imbalance_range(0),
+                     ml_score(0), ml_prediction(PREDICTION_NEUTRAL) {}
+
+    /**
+     * Back to the initial state, keeping the capacity of the price vectors
+     */
+    void clear();
+};
+
+/**
+ * Market Depth Engine
+ * One book per depth slot; books are allocated once when a symbol is added
+ */
+class MarketDepthEngine {
+private:
+    DepthConfig config;
+    std::vector<std::string> symbols;
+    std::vector<std::unique_ptr<OrderBook>> books;   // Over-aligned; new honours alignof
+    std::vector<DepthSignals> slot_signals;
+    std::vector<OrderFlowDetector> flows;
+    std::vector<IcebergDetector> icebergs;
+    std::vector<double> slot_atr;                   // 0 until an ATR is known
+    std::vector<unsigned char> dirty;               // Book changed since the last analysis
+    std::vector<int64_t> last_analysis_ms;          // -1 before the first analysis
+    TickRingBuffer<IcebergEvent> iceberg_events;    // Refills of all symbols
+    DepthScorer scorer;
+
+    void analyze(int slot, int64_t timestampMs);
+    void scoreAll();
+
+public:
+    explicit MarketDepthEngine(const DepthConfig& depthConfig = DepthConfig());
+
+    /**
+     * Add a symbol
+     * @return Depth slot of the symbol (existing slot if already added)
+     */
+    int addSymbol(const std::string& symbol);
+
+    bool hasSymbol(int slot) const {
+        return slot >= 0 && slot < static_cast<int>(books.size());
+    }
+
+    /**
+     * Apply a depth operation to the book of a slot
+     * The book is always exact; analytics only see the net result of all
+     * operations since the slot was last analysed.
+     * @return false if the operation was rejected by the book
+     */
+    bool onDepth(int slot, int position, int operation, int side, double price, double size);
+
+    /**
+     * Analyse every changed book whose last analysis is at least
+     * update_interval_ms old, then rescore all symbols in one batch
+     * Call once per message-processing cycle.
+     * @param nowMs Monotonic time in milliseconds
+     * @return Number of books analysed
+     */
+    int runAnalytics(int64_t nowMs);
+
+    /**
+     * Clear the book of a slot (TWS resets depth after error 317)
+     */
+    void reset(int slot);
+
+    /**
+     * Set the ATR of a slot's bar series; sizes the imbalance window from the next update
+     */
+    void setAtr(int slot, double atr);
+
+    void setScorerWeights(const ScorerWeights& weights);
+    const ScorerWeights& scorerWeights() const { return config.scorer; }
+
+    int size() const { return static_cast<int>(books.size()); }
+    const std::string& symbol(int slot) const { return symbols[slot]; }
+    const OrderBook& book(int slot) const { return *books[slot]; }
+    const DepthSignals& signals(int slot) const { return slot_signals[slot]; }
+
+    /**
+     * Recent iceberg refills of all symbols (oldest first)
+     */
+    const TickRingBuffer<IcebergEvent>& icebergEvents() const { return iceberg_events; }
+};
+
+#endif // MARKET_DEPTH_ENGINE_H
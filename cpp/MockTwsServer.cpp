@@ -0,0 +1,710 @@
+/**
+ * Mock TWS Server Implementation
+ */
+
+#include "MockTwsServer.h"
+#include "InternalUtil.h"
+#include "BarTime.h"
+#include "WireLog.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <random>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const int MIN_CLIENT_VERSION = 100;
+const size_t MAX_HISTORICAL_BARS = 100000;     // Keeps a response below the client's 16 MB message limit
+const int MAX_CATCH_UP = 1024;                  // Messages sent per stream before reads are serviced again
+const int REALTIME_BAR_SECONDS = 5;
+
+// Client -> server message ids
+enum {
+    IN_REQ_IDS = 8,
+    IN_REQ_MKT_DEPTH = 10,
+    IN_CANCEL_MKT_DEPTH = 11,
+    IN_REQ_HISTORICAL_DATA = 20,
+    IN_CANCEL_HISTORICAL_DATA = 25,
+    IN_REQ_CURRENT_TIME = 49,
+    IN_REQ_REAL_TIME_BARS = 50,
+    IN_CANCEL_REAL_TIME_BARS = 51,
+    IN_START_API = 71,
+    IN_REQ_TICK_BY_TICK = 97,
+    IN_CANCEL_TICK_BY_TICK = 98
+};
+
+// Server -> client message ids
+enum {
+    OUT_ERROR = 4,
+    OUT_NEXT_VALID_ID = 9,
+    OUT_MARKET_DEPTH = 12,
+    OUT_MARKET_DEPTH_L2 = 13,
+    OUT_MANAGED_ACCOUNTS = 15,
+    OUT_HISTORICAL_DATA = 17,
+    OUT_CURRENT_TIME = 49,
+    OUT_REAL_TIME_BARS = 50,
+    OUT_TICK_BY_TICK = 99
+};
+
+enum StreamKind {
+    STREAM_REALTIME_BARS,
+    STREAM_TICK_BY_TICK,
+    STREAM_MARKET_DEPTH
+};
+
+// Tick-by-tick types as encoded on the wire
+enum {
+    TICK_LAST = 1,
+    TICK_ALL_LAST = 2,
+    TICK_BID_ASK = 3,
+    TICK_MIDPOINT = 4
+};
+
+/**
+ * Outgoing message: 4-byte big-endian length, then NUL-terminated fields
+ */
+class Message {
+private:
+    std::string bytes;
+
+public:
+    Message() : bytes(4, '\0') {}
+
+    Message& add(const char* field) {
+        bytes += field;
+        bytes += '\0';
+        return *this;
+    }
+    Message& add(const std::string& field) { return add(field.c_str()); }
+    Message& add(long long number) {
+        char text[24];
+        std::snprintf(text, sizeof(text), "%lld", number);
+        return add(text);
+    }
+    Message& add(int number) { return add(static_cast<long long>(number)); }
+    Message& add(double number) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.10g", number);
+        return add(text);
+    }
+
+    // Frame with its length prefix filled in
+    const std::string& frame() {
+        uint32_t length = htonl(static_cast<uint32_t>(bytes.size() - 4));
+        std::memcpy(&bytes[0], &length, 4);
+        return bytes;
+    }
+};
+
+struct Stream {
+    int kind;                   // StreamKind
+    int req_id;
+    std::string symbol;
+    int tick_type;              // Tick-by-tick only
+    int rows;                   // Market depth only
+    bool smart_depth;
+    int64_t next_ns;            // Steady time the next message is due
+    int64_t interval_ns;        // 0 = as fast as possible
+    int64_t sent;
+    long bar_time;              // Real-time bars only
+};
+
+/**
+ * One client connection, from the handshake until it disconnects
+ */
+class Session {
+private:
+    const MockTwsConfig& config;
+    int fd;
+    int server_version;
+    std::mt19937 rng;
+    std::normal_distribution<double> noise;
+    std::map<std::string, double> prices;
+    std::vector<Stream> streams;
+    std::string input;
+    int next_order_id;
+
+    WireLogWriter* recorder;
+    int64_t record_epoch_ns;
+
+    WireLogReader* replay;
+    bool replay_started;
+    bool replay_pending;        // replay_message is read but not sent yet
+    WireMessage replay_message;
+    int64_t replay_start_ns;
+    int64_t replay_base_ns;     // Recorded time of the first replayed message, -1 before it
+
+    bool send(Message& message);
+    bool sendRaw(const char* data, size_t size);
+    bool readExactly(char* data, size_t size);
+
+    double& priceOf(const std::string& symbol);
+    double step(const std::string& symbol, double volatility);
+
+    bool handle(const std::vector<const char*>& fields);
+    bool sendHistoricalData(int reqId, const std::string& symbol, const std::string& barSize,
+                            const std::string& duration, bool useRTH);
+    void addStream(int kind, int reqId, const std::string& symbol, double perSecond);
+    void cancelStream(int kind, int reqId);
+    bool emit(Stream& stream);
+    bool startDepth(Stream& stream);
+    bool sendDepth(const Stream& stream, int position, int operation, int side, double price, int size);
+    bool pumpReplay(int64_t now, int64_t& wakeNs);
+
+public:
+    MockTwsServer::Stats counts;
+
+    Session(const MockTwsConfig& serverConfig, int socket, WireLogWriter* wireRecorder, WireLogReader* wireReplay)
+        : config(serverConfig), fd(socket), server_version(serverConfig.server_version), rng(serverConfig.seed),
+          noise(0.0, 1.0), next_order_id(1), recorder(wireRecorder), record_epoch_ns(steadyNowNs()),
+          replay(wireReplay), replay_started(false), replay_pending(false), replay_start_ns(0),
+          replay_base_ns(-1) {
+        if (replay) {
+            server_version = replay->serverVersion();
+            replay->rewind();
+        }
+    }
+
+    bool handshake();
+    void run(const std::atomic<bool>& running);
+};
+
+bool Session::readExactly(char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::recv(fd, data, size, 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool Session::sendRaw(const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool Session::send(Message& message) {
+    const std::string& frame = message.frame();
+    if (recorder) {
+        recorder->append(steadyNowNs() - record_epoch_ns, frame.data() + 4, static_cast<uint32_t>(frame.size() - 4));
+    }
+    ++counts.messages;
+    counts.bytes += frame.size();
+    return sendRaw(frame.data(), frame.size());
+}
+
+bool Session::handshake() {
+    char prefix[4];
+    if (!readExactly(prefix, sizeof(prefix)) || std::memcmp(prefix, "API", 4) != 0) {
+        return false;
+    }
+
+    // "v<min>..<max>" optionally followed by connect options
+    uint32_t length;
+    if (!readExactly(reinterpret_cast<char*>(&length), sizeof(length))) {
+        return false;
+    }
+    length = ntohl(length);
+    if (length == 0 || length > 4096) {
+        return false;
+    }
+    std::string versions(length, '\0');
+    if (!readExactly(&versions[0], length) || versions[0] != 'v') {
+        return false;
+    }
+
+    char* end = nullptr;
+    long min_version = std::strtol(versions.c_str() + 1, &end, 10);
+    long max_version = min_version;
+    if (end && std::strncmp(end, "..", 2) == 0) {
+        max_version = std::strtol(end + 2, nullptr, 10);
+    }
+    if (min_version < MIN_CLIENT_VERSION || server_version < min_version) {
+        std::fprintf(stderr, "Client versions %s not supported\n", versions.c_str());
+        return false;
+    }
+    server_version = static_cast<int>(std::min<long>(server_version, max_version));
+
+    // The handshake reply is not recorded: replays perform their own
+    char connection_time[64];
+    std::time_t now = std::time(nullptr);
+    std::tm utc;
+    gmtime_r(&now, &utc);
+    std::strftime(connection_time, sizeof(connection_time), "%Y%m%d %H:%M:%S UTC", &utc);
+
+    Message reply;
+    const std::string& frame = reply.add(server_version).add(connection_time).frame();
+    return sendRaw(frame.data(), frame.size());
+}
+
+double& Session::priceOf(const std::string& symbol) {
+    auto it = prices.find(symbol);
+    if (it == prices.end()) {
+        it = prices.emplace(symbol, config.start_price).first;
+    }
+    return it->second;
+}
+
+double Session::step(const std::string& symbol, double volatility) {
+    double& price = priceOf(symbol);
+    price = std::max(0.01, std::round(price * (1.0 + volatility * noise(rng)) * 100.0) / 100.0);
+    return price;
+}
+
+bool Session::sendHistoricalData(int reqId, const std::string& symbol, const std::string& barSize,
+                                 const std::string& duration, bool useRTH) {
+    int bar_seconds = barSizeToSeconds(barSize);
+    if (bar_seconds <= 0) {
+        Message error;
+        error.add(OUT_ERROR).add(2).add(reqId).add(321).add("Invalid bar size: " + barSize).add("");
+        return send(error);
+    }
+
+    size_t count = std::min(std::max<size_t>(expectedBarCount(duration, barSize, useRTH), 1), MAX_HISTORICAL_BARS);
+    long end_time = wallClockNow() / bar_seconds * bar_seconds;
+    long start_time = end_time - static_cast<long>(count - 1) * bar_seconds;
+
+    Message message;
+    message.add(OUT_HISTORICAL_DATA).add(reqId)
+           .add(formatWallClock(start_time)).add(formatWallClock(end_time))
+           .add(static_cast<long long>(count));
+    std::uniform_int_distribution<int> volume(100, 10000);
+    for (size_t i = 0; i < count; ++i) {
+        double open = priceOf(symbol);
+        double close = step(symbol, 0.002);
+        double high = std::round(std::max(open, close) * (1.0 + 0.001 * std::fabs(noise(rng))) * 100.0) / 100.0;
+        double low = std::round(std::min(open, close) * (1.0 - 0.001 * std::fabs(noise(rng))) * 100.0) / 100.0;
+        message.add(formatWallClock(start_time + static_cast<long>(i) * bar_seconds))
+               .add(open).add(high).add(low).add(close)
+               .add(volume(rng))
+               .add(std::round((high + low + close) / 3.0 * 100.0) / 100.0)
+               .add(volume(rng) / 10);
+    }
+    return send(message);
+}
+
+void Session::addStream(int kind, int reqId, const std::string& symbol, double perSecond) {
+    Stream stream;
+    stream.kind = kind;
+    stream.req_id = reqId;
+    stream.symbol = symbol;
+    stream.tick_type = TICK_ALL_LAST;
+    stream.rows = 10;
+    stream.smart_depth = false;
+    stream.next_ns = steadyNowNs();
+    stream.interval_ns = config.speed > 0 ? static_cast<int64_t>(1e9 / (perSecond * config.speed)) : 0;
+    stream.sent = 0;
+    stream.bar_time = std::time(nullptr) / REALTIME_BAR_SECONDS * REALTIME_BAR_SECONDS;
+    streams.push_back(stream);
+}
+
+void Session::cancelStream(int kind, int reqId) {
+    streams.erase(std::remove_if(streams.begin(), streams.end(), [kind, reqId](const Stream& stream) {
+        return stream.kind == kind && stream.req_id == reqId;
+    }), streams.end());
+}
+
+bool Session::sendDepth(const Stream& stream, int position, int operation, int side, double price, int size) {
+    Message message;
+    if (stream.smart_depth) {
+        message.add(OUT_MARKET_DEPTH_L2).add(1).add(stream.req_id).add(position).add("NSDQ")
+               .add(operation).add(side).add(price).add(size).add(1);
+    } else {
+        message.add(OUT_MARKET_DEPTH).add(1).add(stream.req_id).add(position)
+               .add(operation).add(side).add(price).add(size);
+    }
+    return send(message);
+}
+
+bool Session::startDepth(Stream& stream) {
+    // Insert a full book once; the stream then updates its levels
+    double mid = priceOf(stream.symbol);
+    std::uniform_int_distribution<int> size(1, 10);
+    for (int side = 0; side < 2; ++side) {
+        for (int position = 0; position < stream.rows; ++position) {
+            double offset = 0.01 * (position + 1);
+            double price = side == 1 ? mid - offset : mid + offset;
+            if (!sendDepth(stream, position, 0, side, price, size(rng) * 100)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool Session::emit(Stream& stream) {
+    Message message;
+    double price;
+
+    switch (stream.kind) {
+    case STREAM_REALTIME_BARS: {
+        double open = priceOf(stream.symbol);
+        double close = step(stream.symbol, 0.0005);
+        double high = std::max(open, close) + 0.01;
+        double low = std::min(open, close) - 0.01;
+        message.add(OUT_REAL_TIME_BARS).add(3).add(stream.req_id).add(static_cast<long long>(stream.bar_time))
+               .add(open).add(high).add(low).add(close).add(1000)
+               .add(std::round((high + low + close) / 3.0 * 100.0) / 100.0).add(25);
+        stream.bar_time += REALTIME_BAR_SECONDS;
+        break;
+    }
+    case STREAM_TICK_BY_TICK:
+        price = step(stream.symbol, 0.0002);
+        message.add(OUT_TICK_BY_TICK).add(stream.req_id).add(stream.tick_type)
+               .add(static_cast<long long>(std::time(nullptr)));
+        if (stream.tick_type == TICK_BID_ASK) {
+            message.add(price - 0.01).add(price + 0.01).add(300).add(200).add(0);
+        } else if (stream.tick_type == TICK_MIDPOINT) {
+            message.add(price);
+        } else {
+            message.add(price).add(100).add(0).add("NASDAQ").add("");
+        }
+        break;
+    case STREAM_MARKET_DEPTH: {
+        std::uniform_int_distribution<int> position(0, stream.rows - 1);
+        std::uniform_int_distribution<int> size(1, 10);
+        int side = static_cast<int>(rng() & 1);
+        int level = position(rng);
+        double mid = step(stream.symbol, 0.0001);
+        double offset = 0.01 * (level + 1);
+        ++stream.sent;
+        return sendDepth(stream, level, 1, side, side == 1 ? mid - offset : mid + offset, size(rng) * 100);
+    }
+    }
+
+    ++stream.sent;
+    return send(message);
+}
+
+bool Session::handle(const std::vector<const char*>& fields) {
+    ++counts.requests;
+    int id = std::atoi(fields[0]);
+
+    // Fields are positional; a request shorter than expected is ignored
+    auto field = [&fields](size_t i) -> const char* {
+        return i < fields.size() ? fields[i] : "";
+    };
+
+    switch (id) {
+    case IN_START_API: {
+        Message valid_id, accounts, farm;
+        valid_id.add(OUT_NEXT_VALID_ID).add(1).add(next_order_id);
+        accounts.add(OUT_MANAGED_ACCOUNTS).add(1).add("DU0000000");
+        farm.add(OUT_ERROR).add(2).add(-1).add(2104).add("Market data farm connection is OK:usfarm").add("");
+        return send(valid_id) && send(accounts) && send(farm);
+    }
+    case IN_REQ_IDS: {
+        Message valid_id;
+        valid_id.add(OUT_NEXT_VALID_ID).add(1).add(++next_order_id);
+        return send(valid_id);
+    }
+    case IN_REQ_CURRENT_TIME: {
+        Message now;
+        now.add(OUT_CURRENT_TIME).add(1).add(static_cast<long long>(std::time(nullptr)));
+        return send(now);
+    }
+    default:
+        break;
+    }
+
+    if (replay) {
+        // The recorded responses carry the request ids of the recorded session
+        if (!replay_started && id != IN_CANCEL_HISTORICAL_DATA && id != IN_CANCEL_REAL_TIME_BARS &&
+            id != IN_CANCEL_TICK_BY_TICK && id != IN_CANCEL_MKT_DEPTH) {
+            replay_started = true;
+            replay_start_ns = steadyNowNs();
+        }
+        return true;
+    }
+
+    switch (id) {
+    case IN_REQ_HISTORICAL_DATA:
+        // reqId, conId, symbol, ..., tradingClass, includeExpired, endDateTime, barSize, duration, useRTH
+        return sendHistoricalData(std::atoi(field(1)), field(3), field(16), field(17), std::atoi(field(18)) != 0);
+    case IN_REQ_REAL_TIME_BARS:
+        addStream(STREAM_REALTIME_BARS, std::atoi(field(2)), field(4), 1.0 / REALTIME_BAR_SECONDS);
+        return true;
+    case IN_CANCEL_REAL_TIME_BARS:
+        cancelStream(STREAM_REALTIME_BARS, std::atoi(field(2)));
+        return true;
+    case IN_REQ_TICK_BY_TICK: {
+        addStream(STREAM_TICK_BY_TICK, std::atoi(field(1)), field(3), config.ticks_per_second);
+        std::string type = field(14);
+        streams.back().tick_type = type == "Last" ? TICK_LAST : type == "BidAsk" ? TICK_BID_ASK :
+                                   type == "MidPoint" ? TICK_MIDPOINT : TICK_ALL_LAST;
+        return true;
+    }
+    case IN_CANCEL_TICK_BY_TICK:
+        cancelStream(STREAM_TICK_BY_TICK, std::atoi(field(1)));
+        return true;
+    case IN_REQ_MKT_DEPTH: {
+        addStream(STREAM_MARKET_DEPTH, std::atoi(field(2)), field(4), config.depth_updates_per_second);
+        Stream& stream = streams.back();
+        stream.rows = std::max(1, std::min(std::atoi(field(15)), 50));
+        stream.smart_depth = std::atoi(field(16)) != 0;
+        return startDepth(stream);
+    }
+    case IN_CANCEL_MKT_DEPTH:
+        cancelStream(STREAM_MARKET_DEPTH, std::atoi(field(2)));
+        return true;
+    default:
+        return true;
+    }
+}
+
+bool Session::pumpReplay(int64_t now, int64_t& wakeNs) {
+    for (int sent = 0; sent < MAX_CATCH_UP; ++sent) {
+        if (!replay_pending) {
+            if (!replay->next(replay_message)) {
+                return true;
+            }
+            replay_pending = true;
+            if (replay_base_ns < 0) {
+                replay_base_ns = replay_message.time_ns;
+            }
+        }
+
+        if (config.speed > 0) {
+            int64_t due = replay_start_ns + static_cast<int64_t>((replay_message.time_ns - replay_base_ns) / config.speed);
+            if (due > now) {
+                wakeNs = std::min(wakeNs, due);
+                return true;
+            }
+        }
+
+        uint32_t length = htonl(replay_message.size);
+        if (!sendRaw(reinterpret_cast<const char*>(&length), sizeof(length)) ||
+            !sendRaw(replay_message.data, replay_message.size)) {
+            return false;
+        }
+        if (recorder) {
+            recorder->append(steadyNowNs() - record_epoch_ns, replay_message.data, replay_message.size);
+        }
+        ++counts.messages;
+        counts.bytes += sizeof(length) + replay_message.size;
+        replay_pending = false;
+    }
+
+    wakeNs = now;
+    return true;
+}
+
+void Session::run(const std::atomic<bool>& running) {
+    std::vector<const char*> fields;
+    char chunk[64 * 1024];
+
+    while (running.load()) {
+        int64_t now = steadyNowNs();
+        int64_t wake_ns = INT64_MAX;
+
+        for (size_t i = 0; i < streams.size(); ++i) {
+            Stream& stream = streams[i];
+            for (int sent = 0; sent < MAX_CATCH_UP; ++sent) {
+                if (config.stream_limit > 0 && stream.sent >= config.stream_limit) {
+                    break;
+                }
+                if (stream.next_ns > now) {
+                    wake_ns = std::min(wake_ns, stream.next_ns);
+                    break;
+                }
+                if (!emit(stream)) {
+                    return;
+                }
+                stream.next_ns += stream.interval_ns;
+                if (stream.interval_ns == 0) {
+                    // Unpaced: one message per stream per pass, then service reads
+                    wake_ns = now;
+                    break;
+                }
+            }
+        }
+
+        if (replay && replay_started && !pumpReplay(now, wake_ns)) {
+            return;
+        }
+
+        int timeout_ms = -1;
+        if (wake_ns != INT64_MAX) {
+            int64_t wait_ns = std::max<int64_t>(0, wake_ns - steadyNowNs());
+            timeout_ms = static_cast<int>(std::min<int64_t>((wait_ns + 999999) / 1000000, 1000));
+        }
+
+        pollfd poll_fd;
+        poll_fd.fd = fd;
+        poll_fd.events = POLLIN;
+        poll_fd.revents = 0;
+        int ready = ::poll(&poll_fd, 1, timeout_ms);
+        if (ready < 0 && errno != EINTR) {
+            return;
+        }
+        if (ready <= 0) {
+            continue;
+        }
+
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            return;
+        }
+        input.append(chunk, static_cast<size_t>(n));
+
+        // Handle every complete message received so far
+        size_t offset = 0;
+        while (input.size() - offset >= 4) {
+            uint32_t length;
+            std::memcpy(&length, input.data() + offset, 4);
+            length = ntohl(length);
+            if (input.size() - offset - 4 < length) {
+                break;
+            }
+
+            fields.clear();
+            const char* field = input.data() + offset + 4;
+            const char* end = field + length;
+            while (field < end) {
+                fields.push_back(field);
+                field += std::strlen(field) + 1;
+            }
+            offset += 4 + length;
+
+            if (!fields.empty() && !handle(fields)) {
+                return;
+            }
+        }
+        input.erase(0, offset);
+    }
+}
+
+} // namespace
+
+MockTwsServer::MockTwsServer(const MockTwsConfig& serverConfig)
+    : config(serverConfig), listen_fd(-1), bound_port(0), running(false), client_fd(-1) {
+}
+
+MockTwsServer::~MockTwsServer() {
+    stop();
+}
+
+bool MockTwsServer::start(std::string* error) {
+    if (running) {
+        return true;
+    }
+
+    listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        if (error) *error = std::string("Cannot create socket: ") + std::strerror(errno);
+        return false;
+    }
+
+    int reuse = 1;
+    ::setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(config.port));
+
+    socklen_t address_size = sizeof(address);
+    if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listen_fd, 4) != 0 ||
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_size) != 0) {
+        if (error) *error = "Cannot listen on port " + std::to_string(config.port) + ": " + std::strerror(errno);
+        ::close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    bound_port = ntohs(address.sin_port);
+    running = true;
+    thread = std::thread(&MockTwsServer::run, this);
+    return true;
+}
+
+void MockTwsServer::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    // Wake accept() and the session's poll()
+    ::shutdown(listen_fd, SHUT_RDWR);
+    int fd = client_fd.load();
+    if (fd >= 0) {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+    thread.join();
+
+    ::close(listen_fd);
+    listen_fd = -1;
+}
+
+MockTwsServer::Stats MockTwsServer::getStats() {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return stats;
+}
+
+void MockTwsServer::run() {
+    WireLogReader replay;
+    WireLogWriter recorder;
+    std::string error;
+
+    if (!config.replay_path.empty() && !replay.open(config.replay_path, &error)) {
+        std::fprintf(stderr, "Replay disabled: %s\n", error.c_str());
+    }
+    if (!config.record_path.empty() && !recorder.open(config.record_path, config.server_version, &error)) {
+        std::fprintf(stderr, "Recording disabled: %s\n", error.c_str());
+    }
+
+    while (running.load()) {
+        int fd = ::accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        int no_delay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        client_fd = fd;
+        if (!running.load()) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+
+        Session session(config, fd, recorder.isOpen() ? &recorder : nullptr, replay.isOpen() ? &replay : nullptr);
+        if (session.handshake()) {
+            session.run(running);
+        }
+        recorder.flush();
+
+        client_fd = -1;
+        ::close(fd);
+
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        ++stats.connections;
+        stats.requests += session.counts.requests;
+        stats.messages += session.counts.messages;
+        stats.bytes += session.counts.bytes;
+    }
+}
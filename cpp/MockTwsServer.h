@@ -0,0 +1,94 @@
+/**
+ * Mock TWS Server
+ * Local stand-in for TWS/IB Gateway for offline tests and benchmarks
+ */
+
+#ifndef MOCK_TWS_SERVER_H
+#define MOCK_TWS_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Server behaviour
+ */
+struct MockTwsConfig {
+    int port;                       // 0 picks a free port (see MockTwsServer::port())
+    int server_version;             // Highest version offered in the handshake
+    double speed;                   // Time scale of streams and replays; <= 0 sends as fast as possible
+    std::string replay_path;        // Wire log replayed instead of synthetic data (empty = synthetic)
+    std::string record_path;        // Wire log receiving every message sent (empty = off)
+    int64_t stream_limit;           // Messages per synthetic stream (0 = unlimited)
+    double ticks_per_second;        // Synthetic tick-by-tick rate at speed 1
+    double depth_updates_per_second;// Synthetic depth update rate at speed 1
+    double start_price;
+    unsigned seed;                  // Synthetic data is reproducible for a given seed
+
+    MockTwsConfig() : port(7497), server_version(176), speed(1.0), stream_limit(0),
+                      ticks_per_second(10), depth_updates_per_second(20), start_price(100.0), seed(42) {}
+};
+
+/**
+ * Mock TWS Server
+ * Speaks the TWS socket protocol (handshake, startApi, nextValidId) and
+ * answers historical data, real-time bar, tick-by-tick and market depth
+ * requests. Data is either a seeded random walk generated per request or a
+ * recorded wire log, whose messages are sent verbatim, paced by their
+ * recorded times, once the client makes its first data request. Clients are
+ * served one at a time on a background thread.
+ */
+class MockTwsServer {
+public:
+    struct Stats {
+        uint64_t connections;
+        uint64_t requests;          // Messages received after the handshake
+        uint64_t messages;          // Messages sent after the handshake
+        uint64_t bytes;
+
+        Stats() : connections(0), requests(0), messages(0), bytes(0) {}
+    };
+
+private:
+    MockTwsConfig config;
+    int listen_fd;
+    int bound_port;
+    std::atomic<bool> running;
+    std::atomic<int> client_fd;     // Shut down by stop() to end the session
+    std::thread thread;
+
+    std::mutex stats_mutex;
+    Stats stats;
+
+    void run();
+    void serve(int fd);
+
+public:
+    explicit MockTwsServer(const MockTwsConfig& serverConfig = MockTwsConfig());
+    ~MockTwsServer();
+
+    MockTwsServer(const MockTwsServer&) = delete;
+    MockTwsServer& operator=(const MockTwsServer&) = delete;
+
+    /**
+     * Listen on 127.0.0.1 and start serving
+     * @param error Receives the reason on failure (optional)
+     */
+    bool start(std::string* error = nullptr);
+
+    /**
+     * Disconnect the client and stop listening
+     */
+    void stop();
+
+    int port() const { return bound_port; }
+
+    /**
+     * Totals of all finished connections
+     */
+    Stats getStats();
+};
+
+#endif // MOCK_TWS_SERVER_H
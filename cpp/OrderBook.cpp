@@ -0,0 +1,125 @@
+/**
+ * Order Book Implementation
+ */
+
+#include "OrderBook.h"
+#include <cstring>
+
+const int OrderBook::MAX_LEVELS;
+
+OrderBook::OrderBook() {
+    clear();
+}
+
+void OrderBook::clear() {
+    std::memset(sides, 0, sizeof(sides));
+}
+
+void OrderBook::accumulateFrom(Levels& book, int position) {
+    double running = position > 0 ? book.cumulative[position - 1] : 0;
+    for (int i = position; i < book.count; ++i) {
+        running += book.size[i];
+        book.cumulative[i] = running;
+    }
+}
+
+bool OrderBook::apply(int position, int operation, int side, double price, double size) {
+    if ((side != BOOK_SIDE_ASK && side != BOOK_SIDE_BID) || position < 0 || position >= MAX_LEVELS) {
+        return false;
+    }
+
+    Levels& book = sides[side];
+
+    // TWS may update the level just past the end; that adds a level
+    if (operation == BOOK_OP_UPDATE && position == book.count) {
+        operation = BOOK_OP_INSERT;
+    }
+
+    switch (operation) {
+        case BOOK_OP_INSERT: {
+            if (position > book.count) {
+                return false;
+            }
+
+            // A full book drops its worst level
+            if (book.count == MAX_LEVELS) {
+                --book.count;
+            }
+
+            int tail = book.count - position;
+            std::memmove(&book.price[position + 1], &book.price[position], tail * sizeof(double));
+            std::memmove(&book.size[position + 1], &book.size[position], tail * sizeof(double));
+            book.price[position] = price;
+            book.size[position] = size;
+            ++book.count;
+            break;
+        }
+
+        case BOOK_OP_UPDATE: {
+            if (position >= book.count) {
+                return false;
+            }
+            book.price[position] = price;
+            book.size[position] = size;
+            break;
+        }
+
+        case BOOK_OP_DELETE: {
+            if (position >= book.count) {
+                return false;
+            }
+
+            int tail = book.count - position - 1;
+            std::memmove(&book.price[position], &book.price[position + 1], tail * sizeof(double));
+            std::memmove(&book.size[position], &book.size[position + 1], tail * sizeof(double));
+            --book.count;
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    accumulateFrom(book, position);
+    return true;
+}
+
+double OrderBook::spread() const {
+    if (sides[BOOK_SIDE_BID].count == 0 || sides[BOOK_SIDE_ASK].count == 0) {
+        return 0;
+    }
+    return sides[BOOK_SIDE_ASK].price[0] - sides[BOOK_SIDE_BID].price[0];
+}
+
+double OrderBook::midpoint() const {
+    if (sides[BOOK_SIDE_BID].count == 0 || sides[BOOK_SIDE_ASK].count == 0) {
+        return 0;
+    }
+    return (sides[BOOK_SIDE_ASK].price[0] + sides[BOOK_SIDE_BID].price[0]) / 2;
+}
+
+double OrderBook::cumulativeSize(int side, int levels) const {
+    const Levels& book = sides[side];
+    if (levels > book.count) {
+        levels = book.count;
+    }
+    return levels > 0 ? book.cumulative[levels - 1] : 0;
+}
+
+int OrderBook::levelsWithin(int side, double limitPrice) const {
+    const Levels& book = sides[side];
+
+    // Levels get worse with position: bids fall, asks rise
+    int lo = 0, hi = book.count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        bool within = side == BOOK_SIDE_BID ? book.price[mid] >= limitPrice
+                                            : book.price[mid] <= limitPrice;
+        if (within) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
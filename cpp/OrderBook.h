@@ -0,0 +1,112 @@
+/**
+ * Order Book
+ * Level-2 book maintained from IBKR market depth operations
+ */
+
+#ifndef ORDER_BOOK_H
+#define ORDER_BOOK_H
+
+// IBKR market depth side / operation codes (updateMktDepth / updateMktDepthL2)
+enum BookSide {
+    BOOK_SIDE_ASK = 0,
+    BOOK_SIDE_BID = 1
+};
+
+enum BookOperation {
+    BOOK_OP_INSERT = 0,
+    BOOK_OP_UPDATE = 1,
+    BOOK_OP_DELETE = 2
+};
+
+/**
+ * Order Book
+ * Levels are kept by position (0 = best) in fixed-capacity, cache-line aligned
+ * arrays, so applying an operation never allocates. Copying a book is a plain
+ * memory copy.
+ *
+ * Each side also keeps prefix sums of its sizes, refreshed from the changed
+ * position onwards, so depth within a price limit is a binary search plus a
+ * lookup rather than a pass over the book.
+ */
+class OrderBook {
+public:
+    static const int MAX_LEVELS = 64;
+
+private:
+    struct alignas(64) Levels {
+        double price[MAX_LEVELS];
+        double size[MAX_LEVELS];
+        double cumulative[MAX_LEVELS];  // cumulative[i] = size[0] + ... + size[i]
+        int count;
+    };
+
+    Levels sides[2];
+
+    static void accumulateFrom(Levels& book, int position);
+
+public:
+    OrderBook();
+
+    /**
+     * Apply one IBKR depth operation
+     * @param position Level position (0 = best)
+     * @param operation BOOK_OP_INSERT, BOOK_OP_UPDATE or BOOK_OP_DELETE
+     * @param side BOOK_SIDE_ASK or BOOK_SIDE_BID
+     * @return false if the operation does not fit the book (position out of range)
+     */
+    bool apply(int position, int operation, int side, double price, double size);
+
+    /**
+     * Remove all levels (e.g. after the subscription is reset)
+     */
+    void clear();
+
+    int levels(int side) const { return sides[side].count; }
+    double price(int side, int position) const { return sides[side].price[position]; }
+    double size(int side, int position) const { return sides[side].size[position]; }
+
+    // Price / size columns of a side (best first), for batch consumers
+    const double* prices(int side) const { return sides[side].price; }
+    const double* sizes(int side) const { return sides[side].size; }
+
+    double bestBid() const { return sides[BOOK_SIDE_BID].count > 0 ? sides[BOOK_SIDE_BID].price[0] : 0; }
+    double bestAsk() const { return sides[BOOK_SIDE_ASK].count > 0 ? sides[BOOK_SIDE_ASK].price[0] : 0; }
+
+    /**
+     * Best ask - best bid, or 0 if either side is empty
+     */
+    double spread() const;
+
+    /**
+     * Midpoint of best bid and best ask, or 0 if either side is empty
+     */
+    double midpoint() const;
+
+    /**
+     * Total size resting on a side
+     */
+    double totalSize(int side) const {
+        return sides[side].count > 0 ? sides[side].cumulative[sides[side].count - 1] : 0;
+    }
+
+    /**
+     * Cumulative size of the best levels of a side
+     * @param levels Number of levels from the top (clamped to the book depth)
+     */
+    double cumulativeSize(int side, int levels) const;
+
+    /**
+     * Number of levels from the best price up to a price limit
+     * (bids priced >= limitPrice, asks priced <= limitPrice); O(log n)
+     */
+    int levelsWithin(int side, double limitPrice) const;
+
+    /**
+     * Size resting from the best price up to a price limit; O(log n)
+     */
+    double sizeWithin(int side, double limitPrice) const {
+        return cumulativeSize(side, levelsWithin(side, limitPrice));
+    }
+};
+
+#endif // ORDER_BOOK_H
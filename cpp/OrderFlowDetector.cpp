@@ -0,0 +1,73 @@
+/**
+ * Order Flow Detector Implementation
+ */
+
+#include "OrderFlowDetector.h"
+#include <cmath>
+
+const int OrderFlowDetector::MAX_HISTORY;
+
+OrderFlowDetector::OrderFlowDetector(const OrderFlowConfig& flowConfig)
+    : config(flowConfig) {
+    if (config.history_size < 2) {
+        config.history_size = 2;
+    } else if (config.history_size > MAX_HISTORY) {
+        config.history_size = MAX_HISTORY;
+    }
+    reset();
+}
+
+void OrderFlowDetector::reset() {
+    for (int i = 0; i < MAX_HISTORY; ++i) {
+        history[i] = 0;
+    }
+    history_sum = 0;
+    snapshots = 0;
+    filtered_velocity = 0;
+    last_volume = 0;
+    last_velocity_ms = -1;
+    alert_active = false;
+    spike = false;
+}
+
+void OrderFlowDetector::onSnapshot(double totalVolume, int64_t timestampMs) {
+    // Replace the oldest snapshot and keep the ring sum current
+    int index = static_cast<int>(snapshots % config.history_size);
+    history_sum += totalVolume - history[index];
+    history[index] = totalVolume;
+    ++snapshots;
+
+    // Re-add from scratch once per lap so fractional sizes cannot drift the sum
+    if (index == config.history_size - 1) {
+        history_sum = 0;
+        for (int i = 0; i < config.history_size; ++i) {
+            history_sum += history[i];
+        }
+    }
+
+    if (last_velocity_ms < 0) {
+        last_volume = totalVolume;
+        last_velocity_ms = timestampMs;
+    } else if (timestampMs - last_velocity_ms >= config.velocity_interval_ms) {
+        double velocity = (totalVolume - last_volume) / ((timestampMs - last_velocity_ms) / 1000.0);
+        filtered_velocity = config.smoothing_factor * velocity +
+                            (1 - config.smoothing_factor) * filtered_velocity;
+        last_volume = totalVolume;
+        last_velocity_ms = timestampMs;
+
+        // Alert with hysteresis so it does not flap around the threshold
+        double magnitude = std::fabs(filtered_velocity);
+        if (magnitude > config.velocity_threshold) {
+            alert_active = true;
+        } else if (alert_active && magnitude < config.velocity_threshold * config.hysteresis_ratio) {
+            alert_active = false;
+        }
+    }
+
+    // Spikes are judged once the ring has been filled
+    spike = false;
+    if (snapshots >= config.history_size) {
+        double avg_volume = history_sum / config.history_size;
+        spike = totalVolume > avg_volume * config.spike_multiplier;
+    }
+}
@@ -0,0 +1,76 @@
+/**
+ * Order Flow Detector
+ * Streaming order-flow velocity and liquidation-spike detection
+ * (port of the velocity / spike logic of MarketDepthIndicator_Fixed.mq5)
+ */
+
+#ifndef ORDER_FLOW_DETECTOR_H
+#define ORDER_FLOW_DETECTOR_H
+
+#include <cstdint>
+
+/**
+ * Order flow parameters (MQL5 "Velocity & Spikes" inputs)
+ */
+struct OrderFlowConfig {
+    int history_size;               // Book volume snapshots averaged for spikes (2-100)
+    double smoothing_factor;        // EMA factor of the velocity (0-1)
+    double velocity_threshold;      // |velocity| raising the alert (size/sec)
+    double hysteresis_ratio;        // Alert clears below threshold * ratio
+    double spike_multiplier;        // Spike when volume > average * multiplier
+    int64_t velocity_interval_ms;   // Minimum spacing of velocity updates
+
+    OrderFlowConfig() : history_size(30), smoothing_factor(0.2), velocity_threshold(5000.0),
+                        hysteresis_ratio(0.8), spike_multiplier(3.0), velocity_interval_ms(500) {}
+};
+
+/**
+ * Order Flow Detector
+ * Keeps a running sum over a fixed ring of book volume snapshots, so every
+ * update is O(1) and allocation-free.
+ */
+class OrderFlowDetector {
+public:
+    static const int MAX_HISTORY = 100;
+
+private:
+    OrderFlowConfig config;
+    double history[MAX_HISTORY];
+    double history_sum;
+    int64_t snapshots;              // Total snapshots recorded
+
+    double filtered_velocity;
+    double last_volume;             // Volume at the previous velocity update
+    int64_t last_velocity_ms;       // -1 before the first snapshot
+    bool alert_active;
+    bool spike;
+
+public:
+    explicit OrderFlowDetector(const OrderFlowConfig& flowConfig = OrderFlowConfig());
+
+    /**
+     * Record the total resting volume of the book
+     * @param totalVolume Bid + ask size
+     * @param timestampMs Monotonic time in milliseconds
+     */
+    void onSnapshot(double totalVolume, int64_t timestampMs);
+
+    /**
+     * Smoothed velocity (size/sec) of the total book volume
+     */
+    double velocity() const { return filtered_velocity; }
+
+    /**
+     * Velocity alert state, with hysteresis
+     */
+    bool velocityAlert() const { return alert_active; }
+
+    /**
+     * Whether the latest snapshot is a liquidation spike
+     */
+    bool liquidationSpike() const { return spike; }
+
+    void reset();
+};
+
+#endif // ORDER_FLOW_DETECTOR_H
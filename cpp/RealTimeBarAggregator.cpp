@@ -0,0 +1,159 @@
+/**
+ * Real-Time Bar Aggregator Implementation
+ */
+
+#include "RealTimeBarAggregator.h"
+#include "BarTime.h"
+#include "Decimal.h"
+
+const int RealTimeBarAggregator::SOURCE_BAR_SECONDS;
+
+namespace {
+
+// Fold a late 5-second bar into the completed bar it belongs to; the ATR keeps
+// the bar as it was when completed
+void mergeLateBar(Bar& bar, double high, double low, double close, double volume, double wap, int count) {
+    double bar_volume = DecimalFunctions::decimalToDouble(bar.volume);
+    double notional = DecimalFunctions::decimalToDouble(bar.wap) * bar_volume + wap * volume;
+
+    if (high > bar.high) bar.high = high;
+    if (low < bar.low) bar.low = low;
+    bar.close = close;
+    bar.volume = DecimalFunctions::doubleToDecimal(bar_volume + volume);
+    if (bar_volume + volume > 0) {
+        bar.wap = DecimalFunctions::doubleToDecimal(notional / (bar_volume + volume));
+    }
+    bar.count += count;
+}
+
+} // namespace
+
+RealTimeBarAggregator::RealTimeBarAggregator(size_t windowSize, int atrPeriod)
+    : window_size(windowSize), atr_period(atrPeriod) {
+}
+
+int RealTimeBarAggregator::addSymbol(const std::string& symbol, int barSeconds) {
+    RealTimeBarState state;
+    state.symbol = symbol;
+    state.bar_seconds = barSeconds < SOURCE_BAR_SECONDS ? SOURCE_BAR_SECONDS : barSeconds;
+    state.window.reserve(window_size + 1);
+    state.atr = AverageTrueRange(atr_period);
+
+    states.push_back(std::move(state));
+    return static_cast<int>(states.size()) - 1;
+}
+
+void RealTimeBarAggregator::closeBar(RealTimeBarState& state) {
+    Bar bar;
+    bar.time = formatBarTime(state.bucket_start);
+    bar.open = state.open;
+    bar.high = state.high;
+    bar.low = state.low;
+    bar.close = state.close;
+    bar.volume = DecimalFunctions::doubleToDecimal(state.volume);
+    bar.wap = DecimalFunctions::doubleToDecimal(
+        state.volume > 0 ? state.wap_notional / state.volume : state.close);
+    bar.count = state.count;
+
+    state.atr.update(state.high, state.low, state.close);
+    state.window.push_back(std::move(bar));
+    if (state.window.size() > window_size) {
+        state.window.erase(state.window.begin());
+    }
+
+    state.last_closed = state.bucket_start;
+    state.bucket_start = -1;
+}
+
+void RealTimeBarAggregator::openBar(RealTimeBarState& state, long bucket, double open, double high, double low) {
+    state.bucket_start = bucket;
+    state.open = open;
+    state.high = high;
+    state.low = low;
+    state.volume = 0;
+    state.wap_notional = 0;
+    state.count = 0;
+}
+
+bool RealTimeBarAggregator::onRealTimeBar(int slot, long time, double open, double high, double low,
+                                          double close, double volume, double wap, int count) {
+    RealTimeBarState& state = states[slot];
+    long bucket = time - time % state.bar_seconds;
+    bool closed = false;
+    state.has_bar_feed = true;
+
+    // Ticks run ahead of the 5-second feed: a tick of the next bucket may have
+    // completed this bar already
+    if (bucket <= state.last_closed) {
+        if (bucket == state.last_closed && !state.window.empty()) {
+            mergeLateBar(state.window.back(), high, low, close, volume, wap, count);
+        }
+        return false;
+    }
+
+    if (state.bucket_start >= 0) {
+        // A bar from a later bucket completes the pending one (covers gaps in the feed)
+        if (bucket > state.bucket_start) {
+            closeBar(state);
+            closed = true;
+        } else if (bucket < state.bucket_start) {
+            // Older than a bar ticks opened after a gap; reopening it would
+            // complete the newer bar early
+            return false;
+        }
+    }
+
+    if (state.bucket_start < 0) {
+        openBar(state, bucket, open, high, low);
+    } else {
+        if (high > state.high) state.high = high;
+        if (low < state.low) state.low = low;
+    }
+
+    state.close = close;
+    state.volume += volume;
+    state.wap_notional += wap * volume;
+    state.count += count;
+
+    // Close as soon as the last 5-second slice of the bucket arrives
+    if (time + SOURCE_BAR_SECONDS >= bucket + state.bar_seconds) {
+        closeBar(state);
+        closed = true;
+    }
+
+    return closed;
+}
+
+bool RealTimeBarAggregator::onTick(int slot, long time, double price, double size) {
+    RealTimeBarState& state = states[slot];
+    long bucket = time - time % state.bar_seconds;
+    bool closed = false;
+
+    // Late ticks for a bar the 5-second feed already completed
+    if (bucket <= state.last_closed) {
+        return false;
+    }
+
+    if (state.bucket_start >= 0 && bucket > state.bucket_start) {
+        closeBar(state);
+        closed = true;
+    }
+
+    if (state.bucket_start < 0) {
+        openBar(state, bucket, price, price, price);
+    } else {
+        if (price > state.high) state.high = price;
+        if (price < state.low) state.low = price;
+    }
+
+    state.close = price;
+
+    // 5-second bars carry authoritative volume; only tick-only feeds accumulate it here
+    if (!state.has_bar_feed) {
+        state.volume += size;
+        state.wap_notional += price * size;
+        state.count += 1;
+    }
+
+    return closed;
+}
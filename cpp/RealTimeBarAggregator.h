@@ -0,0 +1,107 @@
+/**
+ * Real-Time Bar Aggregator
+ * Rolls IBKR 5-second real-time bars up into the configured bar size
+ */
+
+#ifndef REALTIME_BAR_AGGREGATOR_H
+#define REALTIME_BAR_AGGREGATOR_H
+
+#include "bar.h"
+#include "AverageTrueRange.h"
+#include <string>
+#include <vector>
+
+/**
+ * Aggregation state for one real-time subscription
+ * All subscriptions live in one contiguous vector indexed by slot
+ */
+struct RealTimeBarState {
+    std::string symbol;
+    int bar_seconds;
+    long bucket_start;          // Start of the in-progress bar, -1 if none
+    long last_closed;           // Start of the most recently completed bar, -1 if none
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+    double wap_notional;        // Sum of wap * volume over the in-progress bar
+    int count;
+    bool has_bar_feed;          // 5-second bars seen; ticks then no longer add volume
+    std::vector<Bar> window;    // Most recent completed bars (oldest first)
+    AverageTrueRange atr;       // ATR of all completed bars
+
+    RealTimeBarState() : bar_seconds(0), bucket_start(-1), last_closed(-1), open(0), high(0),
+                         low(0), close(0), volume(0), wap_notional(0), count(0),
+                         has_bar_feed(false) {}
+};
+
+/**
+ * Real-Time Bar Aggregator
+ * Keeps a fixed-length window of completed bars per subscription
+ */
+class RealTimeBarAggregator {
+private:
+    size_t window_size;
+    int atr_period;
+    std::vector<RealTimeBarState> states;
+
+    void closeBar(RealTimeBarState& state);
+    void openBar(RealTimeBarState& state, long bucket, double open, double high, double low);
+
+public:
+    /**
+     * IBKR only delivers real-time bars of this length
+     */
+    static const int SOURCE_BAR_SECONDS = 5;
+
+    /**
+     * Constructor
+     * @param windowSize Number of completed bars kept per subscription
+     * @param atrPeriod ATR period of each subscription
+     */
+    explicit RealTimeBarAggregator(size_t windowSize = 20, int atrPeriod = 14);
+
+    /**
+     * Register a subscription
+     * @param symbol Symbol name
+     * @param barSeconds Target bar length in seconds
+     * @return Slot index used by onRealTimeBar()
+     */
+    int addSymbol(const std::string& symbol, int barSeconds);
+
+    /**
+     * Fold one 5-second bar into its subscription
+     * A late bar of the most recently completed bar is merged into it; older
+     * late bars are dropped
+     * @return true if at least one target bar was completed
+     */
+    bool onRealTimeBar(int slot, long time, double open, double high, double low,
+                       double close, double volume, double wap, int count);
+
+    /**
+     * Fold a single trade (or midpoint) into the in-progress bar
+     * Ticks move high/low/close at tick granularity; a tick in a later bucket
+     * completes the pending bar
+     * @return true if a target bar was completed
+     */
+    bool onTick(int slot, long time, double price, double size);
+
+    /**
+     * The 5-second feed of a subscription was cancelled: ticks count volume,
+     * trades and WAP again until the next 5-second bar arrives
+     */
+    void endBarFeed(int slot) { states[slot].has_bar_feed = false; }
+
+    /**
+     * Number of registered subscriptions
+     */
+    size_t size() const { return states.size(); }
+
+    /**
+     * Get the aggregation state of a subscription
+     */
+    const RealTimeBarState& state(int slot) const { return states[slot]; }
+};
+
+#endif // REALTIME_BAR_AGGREGATOR_H
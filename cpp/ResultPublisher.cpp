@@ -0,0 +1,249 @@
+/**
+ * Result Publisher Implementation
+ */
+
+#include "ResultPublisher.h"
+#include "InternalUtil.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char SHARED_RESULTS_MAGIC[8] = {'A', 'F', 'S', 'H', 'M', '\0', '\0', '\0'};
+const uint32_t SHARED_RESULTS_BYTE_ORDER = 0x01020304;
+
+static_assert(sizeof(SharedResultsHeader) == 64, "SharedResultsHeader must stay 64 bytes");
+static_assert(sizeof(SharedResultSlot) % 64 == 0, "Slots must not share cache lines");
+
+void unmapper(void* addr, size_t bytes) {
+    ::munmap(addr, bytes);
+}
+
+} // namespace
+
+const uint32_t ResultPublisher::FORMAT_VERSION;
+const int ResultSubscriber::RETRY_LIMIT;
+
+ResultPublisher::ResultPublisher() : header(nullptr), slots(nullptr) {
+}
+
+bool ResultPublisher::open(const std::string& name, int slotCount, std::string* error) {
+    close();
+    if (slotCount <= 0) {
+        setError(error, "Slot count must be positive");
+        return false;
+    }
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        setError(error, "Cannot create shared memory " + name + ": " + std::strerror(errno));
+        return false;
+    }
+
+    size_t bytes = sizeof(SharedResultsHeader) + static_cast<size_t>(slotCount) * sizeof(SharedResultSlot);
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        int truncate_errno = errno;
+        ::close(fd);
+        setError(error, "Cannot size shared memory " + name + ": " + std::strerror(truncate_errno));
+        return false;
+    }
+
+    void* addr = mapAndClose(fd, bytes, PROT_READ | PROT_WRITE, MAP_SHARED);
+    if (addr == MAP_FAILED) {
+        setError(error, "Cannot map shared memory " + name + ": " + std::strerror(errno));
+        return false;
+    }
+
+    // The magic is written last, so readers never accept a half-initialized header
+    header = static_cast<SharedResultsHeader*>(addr);
+    std::memset(header->magic, 0, sizeof(header->magic));
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memset(static_cast<char*>(addr) + sizeof(SharedResultsHeader), 0, bytes - sizeof(SharedResultsHeader));
+    header->version = FORMAT_VERSION;
+    header->byte_order = SHARED_RESULTS_BYTE_ORDER;
+    header->header_size = sizeof(SharedResultsHeader);
+    header->slot_size = sizeof(SharedResultSlot);
+    header->slot_count = static_cast<uint32_t>(slotCount);
+    header->record_size = sizeof(ResultRecord);
+    header->used_slots.store(0, std::memory_order_relaxed);
+    std::memset(header->reserved, 0, sizeof(header->reserved));
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, SHARED_RESULTS_MAGIC, sizeof(SHARED_RESULTS_MAGIC));
+
+    slots = reinterpret_cast<SharedResultSlot*>(static_cast<char*>(addr) + sizeof(SharedResultsHeader));
+    mapping = std::shared_ptr<void>(addr, [bytes](void* p) { unmapper(p, bytes); });
+    segment_name = name;
+    return true;
+}
+
+void ResultPublisher::close() {
+    mapping.reset();
+    header = nullptr;
+    slots = nullptr;
+    segment_name.clear();
+    symbol_slots.clear();
+}
+
+bool ResultPublisher::unlink(const std::string& name) {
+    return ::shm_unlink(name.c_str()) == 0;
+}
+
+int ResultPublisher::slotFor(const std::string& symbol) {
+    if (!header) {
+        return -1;
+    }
+
+    auto it = symbol_slots.find(symbol);
+    if (it != symbol_slots.end()) {
+        return it->second;
+    }
+
+    uint32_t used = header->used_slots.load(std::memory_order_relaxed);
+    if (used >= header->slot_count) {
+        return -1;
+    }
+
+    // The symbol is written before the slot becomes visible through used_slots
+    int slot = static_cast<int>(used);
+    SharedResultSlot& target = slots[slot];
+    std::strncpy(target.record.symbol, symbol.c_str(), sizeof(target.record.symbol) - 1);
+    target.record.symbol_id = used;
+    header->used_slots.store(used + 1, std::memory_order_release);
+
+    symbol_slots[symbol] = slot;
+    return slot;
+}
+
+bool ResultPublisher::publish(const std::string& symbol, int64_t timeSeconds, const FibonacciResults& results) {
+    int slot = slotFor(symbol);
+    if (slot < 0) {
+        return false;
+    }
+
+    ResultRecord record;
+    toResultRecord(static_cast<uint32_t>(slot), symbol, timeSeconds, results, record);
+    publish(slot, record);
+    return true;
+}
+
+void ResultPublisher::publish(int slot, const ResultRecord& record) {
+    SharedResultSlot& target = slots[slot];
+    uint64_t sequence = target.sequence.load(std::memory_order_relaxed);
+
+    target.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&target.record, &record, sizeof(record));
+    target.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+ResultSubscriber::ResultSubscriber() : header(nullptr), slots(nullptr) {
+}
+
+bool ResultSubscriber::open(const std::string& name, std::string* error) {
+    mapping.reset();
+    header = nullptr;
+    slots = nullptr;
+
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        setError(error, "Cannot open shared memory " + name + ": " + std::strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SharedResultsHeader)) {
+        ::close(fd);
+        setError(error, "Not a result segment: " + name);
+        return false;
+    }
+
+    size_t bytes = static_cast<size_t>(st.st_size);
+    void* addr = mapAndClose(fd, bytes, PROT_READ, MAP_SHARED);
+    if (addr == MAP_FAILED) {
+        setError(error, "Cannot map shared memory " + name);
+        return false;
+    }
+
+    std::shared_ptr<const void> view(addr, [bytes](const void* p) { unmapper(const_cast<void*>(p), bytes); });
+
+    const SharedResultsHeader* shared = static_cast<const SharedResultsHeader*>(addr);
+    if (std::memcmp(shared->magic, SHARED_RESULTS_MAGIC, sizeof(SHARED_RESULTS_MAGIC)) != 0) {
+        setError(error, "Not a result segment (or not initialized yet): " + name);
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (shared->byte_order != SHARED_RESULTS_BYTE_ORDER) {
+        setError(error, "Result segment has foreign byte order");
+        return false;
+    }
+    // The slot layout is shared with the publisher, so only an identical one is usable
+    if (shared->version != ResultPublisher::FORMAT_VERSION || shared->header_size != sizeof(SharedResultsHeader) ||
+        shared->slot_size != sizeof(SharedResultSlot) || shared->record_size != sizeof(ResultRecord)) {
+        setError(error, "Unsupported result segment version " + std::to_string(shared->version));
+        return false;
+    }
+    if (bytes < sizeof(SharedResultsHeader) + static_cast<size_t>(shared->slot_count) * sizeof(SharedResultSlot)) {
+        setError(error, "Result segment is truncated: " + name);
+        return false;
+    }
+
+    header = shared;
+    slots = reinterpret_cast<const SharedResultSlot*>(static_cast<const char*>(addr) + sizeof(SharedResultsHeader));
+    mapping = std::move(view);
+    return true;
+}
+
+int ResultSubscriber::size() const {
+    if (!header) {
+        return 0;
+    }
+    uint32_t used = header->used_slots.load(std::memory_order_acquire);
+    return static_cast<int>(used < header->slot_count ? used : header->slot_count);
+}
+
+int ResultSubscriber::find(const std::string& symbol) const {
+    // Records keep the first 15 characters of a name (option and futures
+    // local symbols are longer), so compare that much and require the stored
+    // name to end there
+    const size_t length = std::min(symbol.size(), sizeof(ResultRecord::symbol) - 1);
+
+    // Symbols are written once before used_slots makes the slot visible
+    int count = size();
+    for (int slot = 0; slot < count; ++slot) {
+        const char* name = slots[slot].record.symbol;
+        if (std::strncmp(name, symbol.c_str(), length) == 0 && name[length] == '\0') {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+bool ResultSubscriber::read(int slot, ResultRecord& record, uint64_t* sequence) const {
+    if (slot < 0 || slot >= size()) {
+        return false;
+    }
+
+    const SharedResultSlot& source = slots[slot];
+    for (int attempt = 0; attempt < RETRY_LIMIT; ++attempt) {
+        uint64_t before = source.sequence.load(std::memory_order_acquire);
+        if (before == 0) {
+            return false;
+        }
+        if (before & 1) {
+            continue;
+        }
+
+        std::memcpy(&record, &source.record, sizeof(record));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (source.sequence.load(std::memory_order_relaxed) == before) {
+            if (sequence) *sequence = before;
+            return true;
+        }
+    }
+    return false;
+}
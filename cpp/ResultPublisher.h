@@ -0,0 +1,162 @@
+/**
+ * Result Publisher
+ * Latest results per symbol in a POSIX shared-memory segment for co-located readers
+ *
+ * Segment layout:
+ *
+ *   SharedResultsHeader           64 bytes
+ *   slot[0]                       header.slot_size bytes each (cache-line aligned)
+ *   slot[1]
+ *   ...
+ *
+ * Each slot holds a ResultRecord guarded by a sequence lock: the publisher
+ * makes the sequence odd, rewrites the record and makes it even again.
+ * Readers copy the record and retry if the sequence was odd or changed, so
+ * neither side ever blocks the other. Slots are assigned to symbols in the
+ * order they are first published and keep their symbol for the segment's
+ * lifetime; used_slots only grows.
+ */
+
+#ifndef RESULT_PUBLISHER_H
+#define RESULT_PUBLISHER_H
+
+#include "ResultRecord.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "Shared-memory sequence locks need address-free atomics");
+
+/**
+ * Header at the start of the shared segment
+ */
+struct SharedResultsHeader {
+    char magic[8];                      // "AFSHM\0\0\0"
+    uint32_t version;                   // ResultPublisher::FORMAT_VERSION
+    uint32_t byte_order;                // 0x01020304 as written by the publisher
+    uint32_t header_size;               // Slots start here
+    uint32_t slot_size;                 // Bytes per slot
+    uint32_t slot_count;                // Slots in the segment
+    uint32_t record_size;               // sizeof(ResultRecord) of the publisher
+    std::atomic<uint32_t> used_slots;   // Slots assigned to a symbol so far
+    uint8_t reserved[28];
+};
+
+/**
+ * One symbol's latest result
+ */
+struct alignas(64) SharedResultSlot {
+    std::atomic<uint64_t> sequence;     // Odd while being written, 0 before the first publish
+    ResultRecord record;
+};
+
+/**
+ * Result Publisher
+ * Writer side; publish() may be called from several threads, but each slot
+ * must only be written by one at a time (the client serializes them).
+ */
+class ResultPublisher {
+private:
+    std::shared_ptr<void> mapping;
+    SharedResultsHeader* header;
+    SharedResultSlot* slots;
+    std::string segment_name;
+    std::map<std::string, int> symbol_slots;
+
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+
+    ResultPublisher();
+
+    ResultPublisher(const ResultPublisher&) = delete;
+    ResultPublisher& operator=(const ResultPublisher&) = delete;
+
+    /**
+     * Create (or take over and reinitialize) a shared-memory segment
+     * Readers attached to a previous segment of the same name must reopen it.
+     * @param name POSIX shared-memory name, e.g. "/autofib_results"
+     * @param slotCount Maximum number of symbols
+     * @param error Receives the reason on failure (optional)
+     */
+    bool open(const std::string& name, int slotCount, std::string* error = nullptr);
+
+    /**
+     * Unmap the segment; it stays available to readers until unlink()
+     */
+    void close();
+
+    /**
+     * Remove a segment name from the system
+     */
+    static bool unlink(const std::string& name);
+
+    bool isOpen() const { return header != nullptr; }
+    const std::string& name() const { return segment_name; }
+
+    /**
+     * Slot of a symbol, assigned on first use
+     * @return Slot index, -1 if the segment is full or not open
+     */
+    int slotFor(const std::string& symbol);
+
+    /**
+     * Publish the latest results of a symbol
+     * @return false if the symbol has no slot (segment full or not open)
+     */
+    bool publish(const std::string& symbol, int64_t timeSeconds, const FibonacciResults& results);
+
+    /**
+     * Publish a prepared record into a slot
+     */
+    void publish(int slot, const ResultRecord& record);
+};
+
+/**
+ * Result Subscriber
+ * Read-only view of a publisher's segment; safe to use from any process.
+ */
+class ResultSubscriber {
+private:
+    std::shared_ptr<const void> mapping;
+    const SharedResultsHeader* header;
+    const SharedResultSlot* slots;
+
+public:
+    static const int RETRY_LIMIT = 1 << 16;    // Attempts before a slot is reported busy
+
+    ResultSubscriber();
+
+    /**
+     * Map a segment created by ResultPublisher
+     * @param error Receives the reason on failure (optional)
+     */
+    bool open(const std::string& name, std::string* error = nullptr);
+
+    bool isOpen() const { return header != nullptr; }
+
+    /**
+     * Number of slots assigned to symbols so far
+     */
+    int size() const;
+
+    /**
+     * Slot of a symbol, -1 if it has not been published yet
+     * Scans the assigned slots; cache the result. Names are matched on their
+     * first 15 characters, as stored in the record, so symbols that share
+     * those find the first of them.
+     */
+    int find(const std::string& symbol) const;
+
+    /**
+     * Copy a consistent snapshot of a slot
+     * @param sequence Receives the slot's sequence; unchanged sequences mean unchanged records (optional)
+     * @return false if the slot was never published or stayed mid-write for RETRY_LIMIT attempts
+     */
+    bool read(int slot, ResultRecord& record, uint64_t* sequence = nullptr) const;
+};
+
+#endif // RESULT_PUBLISHER_H
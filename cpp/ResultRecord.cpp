@@ -0,0 +1,182 @@
+/**
+ * Result Record Implementation
+ */
+
+#include "ResultRecord.h"
+#include "InternalUtil.h"
+#include "AutoFibIndicator.h"
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const char RESULT_FILE_MAGIC[8] = {'A', 'F', 'R', 'S', 'L', 'T', '\0', '\0'};
+const uint32_t RESULT_FILE_BYTE_ORDER = 0x01020304;
+
+// Files are written in host byte order; a big-endian port must byte-swap on write
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Result files are little-endian");
+static_assert(sizeof(ResultFileHeader) == 64, "ResultFileHeader must stay 64 bytes");
+static_assert(sizeof(ResultLevelInfo) == 32, "ResultLevelInfo must stay 32 bytes");
+static_assert(sizeof(ResultRecord) == 168, "Version 1 records are 168 bytes; add fields at the end");
+
+} // namespace
+
+const int ResultRecord::MAX_LEVELS;
+const uint32_t ResultFile::FORMAT_VERSION;
+
+void toResultRecord(uint32_t symbolId, const std::string& symbol, int64_t timeSeconds,
+                    const FibonacciResults& results, ResultRecord& record) {
+    std::memset(&record, 0, sizeof(record));
+    record.time = timeSeconds;
+    record.symbol_id = symbolId;
+    record.signal = static_cast<uint8_t>(resultSignalCode(AutoFibIndicator::signalFor(results)));
+    std::strncpy(record.symbol, symbol.c_str(), sizeof(record.symbol) - 1);
+
+    for (int i = 0; i < ResultRecord::MAX_LEVELS; ++i) {
+        record.levels[i] = std::numeric_limits<double>::quiet_NaN();
+    }
+    if (!results.error.empty()) {
+        record.flags = RESULT_FLAG_ERROR;
+        return;
+    }
+
+    record.flags = (results.trend == "BULLISH" ? RESULT_FLAG_BULLISH : 0) |
+                   (results.price_in_golden_zone ? RESULT_FLAG_IN_GOLDEN_ZONE : 0) |
+                   (results.range_below_atr ? RESULT_FLAG_RANGE_BELOW_ATR : 0);
+    record.high = results.high_value;
+    record.low = results.low_value;
+    record.current_price = results.current_price;
+    record.golden_zone_low = results.golden_zone_low;
+    record.golden_zone_high = results.golden_zone_high;
+    record.atr = results.atr;
+    record.high_bar_index = results.high_bar_index;
+    record.low_bar_index = results.low_bar_index;
+
+    int i = 0;
+    for (const auto& level : results.fibo_levels) {
+        if (i == ResultRecord::MAX_LEVELS) {
+            break;
+        }
+        record.levels[i++] = level.second;
+    }
+}
+
+std::string resultFileHeader(const std::map<std::string, double>& levels) {
+    // Records hold level prices in key order, so the table follows the same order
+    std::vector<ResultLevelInfo> table;
+    for (const auto& level : levels) {
+        if (table.size() == static_cast<size_t>(ResultRecord::MAX_LEVELS)) {
+            break;
+        }
+        ResultLevelInfo info;
+        std::memset(&info, 0, sizeof(info));
+        info.ratio = level.second;
+        std::strncpy(info.name, level.first.c_str(), sizeof(info.name) - 1);
+        table.push_back(info);
+    }
+
+    ResultFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, RESULT_FILE_MAGIC, sizeof(RESULT_FILE_MAGIC));
+    header.version = ResultFile::FORMAT_VERSION;
+    header.byte_order = RESULT_FILE_BYTE_ORDER;
+    header.header_size = static_cast<uint32_t>(sizeof(ResultFileHeader) + table.size() * sizeof(ResultLevelInfo));
+    header.record_size = sizeof(ResultRecord);
+    header.level_count = static_cast<uint32_t>(table.size());
+
+    std::string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+    bytes.append(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(ResultLevelInfo));
+    return bytes;
+}
+
+int resultSignalCode(const char* signal) {
+    if (std::strcmp(signal, "BUY") == 0) return RESULT_SIGNAL_BUY;
+    if (std::strcmp(signal, "SELL") == 0) return RESULT_SIGNAL_SELL;
+    if (std::strcmp(signal, "HOLD") == 0) return RESULT_SIGNAL_HOLD;
+    return RESULT_SIGNAL_NO_DATA;
+}
+
+const char* resultSignalName(int signal) {
+    switch (signal) {
+        case RESULT_SIGNAL_BUY: return "BUY";
+        case RESULT_SIGNAL_SELL: return "SELL";
+        case RESULT_SIGNAL_HOLD: return "HOLD";
+        default: return "NO_DATA";
+    }
+}
+
+ResultFile::ResultFile()
+    : records(nullptr), record_size(0), record_count(0), level_info(nullptr), level_count(0) {
+}
+
+ResultFile ResultFile::map(const std::string& path, std::string* error) {
+    ResultFile file;
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        setError(error, "Cannot open " + path);
+        return file;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ResultFileHeader)) {
+        ::close(fd);
+        setError(error, "Not a result file: " + path);
+        return file;
+    }
+
+    size_t bytes = static_cast<size_t>(st.st_size);
+    void* addr = mapAndClose(fd, bytes, PROT_READ, MAP_SHARED);
+    if (addr == MAP_FAILED) {
+        setError(error, "Cannot map " + path);
+        return file;
+    }
+
+    std::shared_ptr<const void> mapping(addr, [bytes](const void* p) {
+        ::munmap(const_cast<void*>(p), bytes);
+    });
+
+    const ResultFileHeader* header = static_cast<const ResultFileHeader*>(addr);
+    if (std::memcmp(header->magic, RESULT_FILE_MAGIC, sizeof(RESULT_FILE_MAGIC)) != 0) {
+        setError(error, "Not a result file: " + path);
+        return file;
+    }
+    if (header->byte_order != RESULT_FILE_BYTE_ORDER) {
+        setError(error, "Result file has foreign byte order");
+        return file;
+    }
+    if (header->version < 1) {
+        setError(error, "Unsupported result file version " + std::to_string(header->version));
+        return file;
+    }
+    // Newer versions only append fields, so a larger record is still readable
+    if (header->header_size < sizeof(ResultFileHeader) || header->header_size > bytes ||
+        header->record_size < sizeof(ResultRecord) || header->record_size % alignof(ResultRecord) != 0 ||
+        header->header_size % alignof(ResultRecord) != 0) {
+        setError(error, "Corrupt result file header");
+        return file;
+    }
+
+    // Version 1 files carry no level table
+    if (header->version >= 2) {
+        if (header->level_count > static_cast<uint32_t>(ResultRecord::MAX_LEVELS) ||
+            header->header_size < sizeof(ResultFileHeader) + header->level_count * sizeof(ResultLevelInfo)) {
+            setError(error, "Corrupt result file level table");
+            return file;
+        }
+        file.level_info = reinterpret_cast<const ResultLevelInfo*>(
+            static_cast<const char*>(addr) + sizeof(ResultFileHeader));
+        file.level_count = header->level_count;
+    }
+
+    file.records = static_cast<const char*>(addr) + header->header_size;
+    file.record_size = header->record_size;
+    file.record_count = (bytes - header->header_size) / header->record_size;
+    file.storage = std::move(mapping);
+    return file;
+}
@@ -0,0 +1,160 @@
+/**
+ * Result Record
+ * Fixed-layout binary form of FibonacciResults and a memory-mapped reader
+ *
+ * Result file layout (little-endian):
+ *
+ *   ResultFileHeader              64 bytes
+ *   ResultLevelInfo[level_count]  32 bytes each (version 2; absent in version 1)
+ *   record[0]                     header.record_size bytes each, from header.header_size
+ *   record[1]
+ *   ...
+ *
+ * Records are appended, so the file size is header_size + n * record_size
+ * (a trailing partial record is a write in progress and is ignored). New
+ * fields are only ever added at the end of ResultRecord: readers use
+ * header.record_size as the stride and keep working on newer files.
+ */
+
+#ifndef RESULT_RECORD_H
+#define RESULT_RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+struct FibonacciResults;
+
+enum ResultSignal {
+    RESULT_SIGNAL_NO_DATA = 0,
+    RESULT_SIGNAL_HOLD = 1,
+    RESULT_SIGNAL_BUY = 2,
+    RESULT_SIGNAL_SELL = 3
+};
+
+enum ResultFlags {
+    RESULT_FLAG_BULLISH = 1,                // Trend is BULLISH (else BEARISH)
+    RESULT_FLAG_IN_GOLDEN_ZONE = 2,
+    RESULT_FLAG_RANGE_BELOW_ATR = 4,
+    RESULT_FLAG_ERROR = 8                   // Calculation failed; prices are 0
+};
+
+/**
+ * On-disk header of a result file
+ */
+struct ResultFileHeader {
+    char magic[8];              // "AFRSLT\0\0"
+    uint32_t version;           // ResultFile::FORMAT_VERSION of the producer
+    uint32_t byte_order;        // 0x01020304 as written by the producer
+    uint32_t header_size;       // Header and level table; records start here
+    uint32_t record_size;       // Bytes per record (grows when fields are added)
+    uint32_t level_count;       // Entries used in ResultRecord::levels
+    uint8_t reserved[36];
+};
+
+/**
+ * Name and ratio of ResultRecord::levels[i] (version 2 level table)
+ */
+struct ResultLevelInfo {
+    double ratio;               // Fraction of the swing range, e.g. 0.618
+    char name[24];              // fibo_levels key, NUL-padded, truncated to 23 characters
+};
+
+/**
+ * One result (version 1 layout, 168 bytes)
+ */
+struct ResultRecord {
+    int64_t time;               // Epoch seconds of the calculation
+    uint32_t symbol_id;         // Producer-assigned id
+    uint8_t signal;             // ResultSignal
+    uint8_t flags;              // ResultFlags
+    uint16_t reserved;
+    char symbol[16];            // NUL-padded, truncated to 15 characters
+    double high;
+    double low;
+    double current_price;
+    double golden_zone_low;
+    double golden_zone_high;
+    double atr;
+    int32_t high_bar_index;
+    int32_t low_bar_index;
+    double levels[10];          // Level prices in fibo_levels key order (see ResultFile::level()), NaN if unused
+
+    static const int MAX_LEVELS = 10;
+};
+
+/**
+ * Fill a record from indicator results
+ * @param symbolId Id of the symbol in the producer's symbol list
+ * @param symbol Symbol name
+ * @param timeSeconds Epoch seconds of the calculation
+ */
+void toResultRecord(uint32_t symbolId, const std::string& symbol, int64_t timeSeconds,
+                    const FibonacciResults& results, ResultRecord& record);
+
+/**
+ * Bytes of the header and level table written at the start of every result file
+ * (ResultWriterConfig::segment_header for binary segments)
+ * @param levels Level ratios of the indicator (AutoFibIndicator::getFibonacciLevels()),
+ *               so readers can name ResultRecord::levels[i]
+ */
+std::string resultFileHeader(const std::map<std::string, double>& levels);
+
+/**
+ * ResultSignal of a signal name as returned by AutoFibIndicator::getSignal()
+ */
+int resultSignalCode(const char* signal);
+
+/**
+ * Display name of a signal: "BUY", "SELL", "HOLD" or "NO_DATA"
+ */
+const char* resultSignalName(int signal);
+
+/**
+ * Result File
+ * Read-only view of a memory-mapped result file; records are used in place.
+ * The view covers the file as it was when mapped; map again to see records
+ * appended since.
+ */
+class ResultFile {
+private:
+    std::shared_ptr<const void> storage;
+    const char* records;
+    size_t record_size;
+    size_t record_count;
+    const ResultLevelInfo* level_info;
+    size_t level_count;
+
+public:
+    static const uint32_t FORMAT_VERSION = 2;
+
+    ResultFile();
+
+    /**
+     * Map a result file
+     * @param error Receives the reason on failure (optional)
+     * @return File, empty on failure
+     */
+    static ResultFile map(const std::string& path, std::string* error = nullptr);
+
+    size_t size() const { return record_count; }
+    bool empty() const { return record_count == 0; }
+
+    const ResultRecord& operator[](size_t i) const {
+        return *reinterpret_cast<const ResultRecord*>(records + i * record_size);
+    }
+
+    /**
+     * Levels described by the file; 0 for version 1 files, which carry no level table
+     */
+    size_t levelCount() const { return level_count; }
+
+    /**
+     * Name and ratio of ResultRecord::levels[i]
+     */
+    const ResultLevelInfo& level(size_t i) const { return level_info[i]; }
+};
+
+#endif // RESULT_RECORD_H
@@ -0,0 +1,263 @@
+/**
+ * Result Writer Implementation
+ */
+
+#include "ResultWriter.h"
+#include "JsonWriter.h"
+#include "ResultRecord.h"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ResultWriter::ResultWriter(const ResultWriterConfig& writerConfig)
+    : config(writerConfig), pending_records(0), retained_bytes(0), running(false), flush_requested(false),
+      writing_records(0), segment(nullptr), segment_size(0), segment_sequence(0) {
+    pending.reserve(config.flush_bytes * 2);
+    writing.reserve(config.flush_bytes * 2);
+}
+
+ResultWriter::~ResultWriter() {
+    stop();
+}
+
+bool ResultWriter::start(std::string* error) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) {
+            return true;
+        }
+    }
+
+    // Open the first segment here so configuration errors surface to the caller
+    bool ok = true;
+    if (::mkdir(config.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        int mkdir_errno = errno;
+        std::lock_guard<std::mutex> lock(mutex);
+        last_error = "Cannot create " + config.directory + ": " + std::strerror(mkdir_errno);
+        ok = false;
+    } else if (!segment) {
+        ok = openSegment();
+    }
+    if (!ok) {
+        if (error) *error = lastError();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    running = true;
+    thread = std::thread(&ResultWriter::run, this);
+    return true;
+}
+
+void ResultWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+bool ResultWriter::append(const char* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (retained_bytes + pending.size() + size > config.max_pending_bytes) {
+        ++stats.dropped;
+        return false;
+    }
+
+    pending.append(data, size);
+    ++pending_records;
+    ++stats.records;
+    if (pending.size() >= config.flush_bytes) {
+        wake.notify_one();
+    }
+    return true;
+}
+
+bool ResultWriter::appendResults(const std::string& symbol, const FibonacciResults& results, const char* signal) {
+    // One serialization buffer per producer thread, reused across records
+    thread_local JsonWriter json;
+    json.clear();
+    writeResultsJSON(json, symbol, results, signal);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (retained_bytes + pending.size() + json.size() + 1 > config.max_pending_bytes) {
+        ++stats.dropped;
+        return false;
+    }
+
+    pending.append(json.data(), json.size());
+    pending += '\n';
+    ++pending_records;
+    ++stats.records;
+    if (pending.size() >= config.flush_bytes) {
+        wake.notify_one();
+    }
+    return true;
+}
+
+bool ResultWriter::appendRecord(uint32_t symbolId, const std::string& symbol, int64_t timeSeconds,
+                                const FibonacciResults& results) {
+    ResultRecord record;
+    toResultRecord(symbolId, symbol, timeSeconds, results, record);
+    return append(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+void ResultWriter::flush() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        flush_requested = true;
+    }
+    wake.notify_one();
+}
+
+ResultWriter::Stats ResultWriter::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+std::string ResultWriter::lastError() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return last_error;
+}
+
+std::string ResultWriter::currentSegment() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return segment_path;
+}
+
+void ResultWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait_for(lock, std::chrono::milliseconds(std::max(1, config.flush_interval_ms)), [this] {
+            return !running || flush_requested || pending.size() >= config.flush_bytes;
+        });
+        bool stopping = !running;
+        flush_requested = false;
+
+        if (!pending.empty() || !writing.empty()) {
+            // Producers keep appending into the other buffer while this one is
+            // written; records held back by a failed commit stay in front
+            if (writing.empty()) {
+                writing.swap(pending);
+            } else {
+                writing.append(pending);
+                pending.clear();
+            }
+            writing_records += pending_records;
+            pending_records = 0;
+            retained_bytes = writing.size();
+            lock.unlock();
+            commit();
+            lock.lock();
+        }
+
+        if (stopping && pending.empty()) {
+            break;
+        }
+    }
+
+    lock.unlock();
+    closeSegment();
+}
+
+void ResultWriter::commit() {
+    bool opened = true;
+    if (!segment || segment_size >= config.segment_bytes) {
+        closeSegment();
+        opened = openSegment();
+    }
+
+    bool ok = opened && std::fwrite(writing.data(), 1, writing.size(), segment) == writing.size() &&
+              std::fflush(segment) == 0;
+    if (ok && config.sync) {
+        ok = ::fdatasync(::fileno(segment)) == 0;
+    }
+    int write_errno = errno;
+    if (opened && !ok) {
+        // Part of the buffer may be in the segment and the rest still in
+        // stdio's buffer; cut the segment back to its last complete record
+        // (a reader ignores a partial tail if that fails too) and start the
+        // next commit in a new segment with its own header
+        closeSegment();
+        ::truncate(segment_path.c_str(), static_cast<off_t>(segment_size));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!opened) {
+        // Nothing was written: keep the records for the next commit
+        ++stats.write_errors;
+        return;
+    }
+
+    if (ok) {
+        segment_size += writing.size();
+        stats.bytes_written += writing.size();
+        ++stats.commits;
+    } else {
+        // Records that did reach the disk were cut off again; retrying could duplicate some
+        ++stats.write_errors;
+        stats.dropped += writing_records;
+        last_error = "Write to " + segment_path + " failed: " + std::strerror(write_errno);
+    }
+    writing.clear();
+    writing_records = 0;
+    retained_bytes = 0;
+}
+
+bool ResultWriter::openSegment() {
+    // Segment names are formatted once per segment, not per record
+    std::time_t now = std::time(nullptr);
+    std::tm local;
+    localtime_r(&now, &local);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &local);
+
+    std::string path = config.directory + "/" + config.prefix + "_" + stamp + "_" +
+                       std::to_string(segment_sequence) + config.extension;
+    segment = std::fopen(path.c_str(), "ab");
+    bool ok = segment && std::fseek(segment, 0, SEEK_END) == 0;
+    bool wrote_header = false;
+    if (ok && !config.segment_header.empty() && std::ftell(segment) == 0) {
+        const std::string& header = config.segment_header;
+        wrote_header = true;
+        ok = std::fwrite(header.data(), 1, header.size(), segment) == header.size() &&
+             std::fflush(segment) == 0;
+    }
+    int open_errno = errno;
+    if (!ok && segment) {
+        std::fclose(segment);
+        segment = nullptr;
+        if (wrote_header) {
+            // Never reopen a torn header: drop the file and move on to the next name
+            std::remove(path.c_str());
+            ++segment_sequence;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!segment) {
+        last_error = "Cannot open " + path + ": " + std::strerror(open_errno);
+        return false;
+    }
+
+    ++segment_sequence;
+    segment_path = path;
+    segment_size = static_cast<size_t>(std::ftell(segment));
+    ++stats.segments;
+    return true;
+}
+
+void ResultWriter::closeSegment() {
+    if (segment) {
+        std::fclose(segment);
+        segment = nullptr;
+    }
+}
@@ -0,0 +1,141 @@
+/**
+ * Result Writer
+ * Appends indicator results to rolling segment files from a background thread
+ */
+
+#ifndef RESULT_WRITER_H
+#define RESULT_WRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct FibonacciResults;
+
+/**
+ * Segment and flush policy
+ */
+struct ResultWriterConfig {
+    std::string directory;          // Created if missing
+    std::string prefix;             // Segments are <prefix>_<yyyymmdd_HHMMSS>_<n><extension>
+    std::string extension;
+    std::string segment_header;     // Bytes written at the start of every segment (e.g. a file header)
+    size_t segment_bytes;           // Start a new segment once this size is reached
+    size_t flush_bytes;             // Commit as soon as this much is pending
+    int flush_interval_ms;          // Commit at least this often while data is pending
+    bool sync;                      // fdatasync() every commit (durable, slower)
+    size_t max_pending_bytes;       // Records are dropped, not waited for, beyond this
+
+    ResultWriterConfig() : directory("results"), prefix("autofib"), extension(".ndjson"),
+                           segment_bytes(64 << 20), flush_bytes(1 << 20), flush_interval_ms(200),
+                           sync(false), max_pending_bytes(64 << 20) {}
+};
+
+/**
+ * Result Writer
+ * Producers copy whole records into a pending buffer under a short lock; the
+ * writer thread swaps it out and commits it with one write (group commit).
+ * Segments roll only between records, so every segment holds complete ones.
+ * If no segment can be opened the records are kept (and count against
+ * max_pending_bytes) and the next commit tries again. A failed write drops
+ * its records, cuts the segment back to its last complete record and closes
+ * it, so the next commit starts a new segment with a fresh header.
+ */
+class ResultWriter {
+public:
+    struct Stats {
+        uint64_t records;           // Records accepted
+        uint64_t dropped;           // Records refused at max_pending_bytes or lost by a failed write
+        uint64_t commits;
+        uint64_t bytes_written;
+        uint64_t segments;
+        uint64_t write_errors;      // Failed commits (records are kept if no segment could be opened)
+
+        Stats() : records(0), dropped(0), commits(0), bytes_written(0), segments(0), write_errors(0) {}
+    };
+
+private:
+    ResultWriterConfig config;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::string pending;            // Records waiting for the writer thread
+    uint64_t pending_records;
+    size_t retained_bytes;          // Size of `writing` held back after a failed commit
+    bool running;
+    bool flush_requested;
+    Stats stats;
+    std::string last_error;
+    std::string segment_path;
+
+    // Writer thread only (start() before the thread runs)
+    std::string writing;            // Kept across commits while no segment can be opened
+    uint64_t writing_records;
+    std::FILE* segment;
+    size_t segment_size;
+    int segment_sequence;
+    std::thread thread;
+
+    void run();
+    void commit();
+    bool openSegment();
+    void closeSegment();
+
+public:
+    explicit ResultWriter(const ResultWriterConfig& writerConfig = ResultWriterConfig());
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    /**
+     * Create the directory and start the writer thread
+     * @param error Receives the reason on failure (optional)
+     */
+    bool start(std::string* error = nullptr);
+
+    /**
+     * Commit everything pending and stop the writer thread
+     * Records appended while stopped, or not committed because no segment
+     * could be opened, are kept for the next start()
+     */
+    void stop();
+
+    /**
+     * Queue one record; never waits for the disk
+     * @param data Complete record (a JSON line must end with '\n')
+     * @return false if the record was dropped
+     */
+    bool append(const char* data, size_t size);
+
+    /**
+     * Queue a results object as one NDJSON line
+     */
+    bool appendResults(const std::string& symbol, const FibonacciResults& results, const char* signal);
+
+    /**
+     * Queue results as one binary ResultRecord
+     * (use with segment_header = resultFileHeader(levels))
+     */
+    bool appendRecord(uint32_t symbolId, const std::string& symbol, int64_t timeSeconds,
+                      const FibonacciResults& results);
+
+    /**
+     * Ask the writer thread to commit now instead of waiting for the interval
+     */
+    void flush();
+
+    Stats getStats();
+    std::string lastError();
+
+    /**
+     * Path of the segment being written, empty if none is open yet
+     */
+    std::string currentSegment();
+};
+
+#endif // RESULT_WRITER_H
@@ -0,0 +1,411 @@
+/**
+ * Runtime Metrics Implementation
+ */
+
+#include "RuntimeMetrics.h"
+#include "InternalUtil.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+const size_t MetricsRegistry::ERROR_SLOTS;
+
+namespace {
+
+// A scrape (request read and response sent) gets this long in total, so a
+// slow or idle client cannot hold up the stats file for more than a moment
+const int64_t SCRAPE_TIMEOUT_NS = 1000000000;
+
+struct CounterInfo {
+    const char* name;
+    const char* type;           // Value of the "type" label, or nullptr
+    const char* help;
+};
+
+// Indexed by MetricCounter; entries of one family are adjacent
+const CounterInfo COUNTERS[METRIC_COUNTER_COUNT] = {
+    {"messages_total", "historical_data", "Messages received, by callback type"},
+    {"messages_total", "historical_data_end", nullptr},
+    {"messages_total", "realtime_bar", nullptr},
+    {"messages_total", "tick_last", nullptr},
+    {"messages_total", "tick_bid_ask", nullptr},
+    {"messages_total", "tick_midpoint", nullptr},
+    {"messages_total", "market_depth", nullptr},
+    {"messages_total", "error", nullptr},
+    {"bars_ingested_total", nullptr, "Historical bars stored for pending requests"},
+    {"calculations_total", nullptr, "Indicator calculations"},
+    {"results_published_total", nullptr, "Results published to the shared-memory segment and signal bus"},
+    {"signal_events_total", nullptr, "Signal transitions broadcast"},
+    {"historical_requests_total", nullptr, "Historical data requests sent"},
+    {"pacing_waits_total", nullptr, "Request pumps that left queued requests waiting for pacing"},
+    {"pacing_violations_total", nullptr, "Pacing violations reported by TWS"},
+    {"request_timeouts_total", nullptr, "Historical requests that timed out"},
+};
+
+void appendHeader(std::string& text, const std::string& name, const char* help, const char* type) {
+    text += "# HELP autofib_" + name + " " + help + "\n";
+    text += "# TYPE autofib_" + name + " " + type + "\n";
+}
+
+void appendValue(std::string& text, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+void appendValue(std::string& text, const char* format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    text += line;
+}
+
+} // namespace
+
+MetricsRegistry::ThreadMetrics::ThreadMetrics() {
+    for (int i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+        counters[i].store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < ERROR_SLOTS; ++i) {
+        errors[i].code.store(0, std::memory_order_relaxed);
+        errors[i].count.store(0, std::memory_order_relaxed);
+    }
+    other_errors.store(0, std::memory_order_relaxed);
+}
+
+MetricsRegistry::MetricsRegistry()
+    : start_ns(steadyNowNs()) {
+}
+
+void MetricsRegistry::countError(int code) {
+    ThreadMetrics& thread = threads.local();
+
+    // Open addressing; only this thread inserts, so a slot is claimed without a CAS
+    size_t start = static_cast<size_t>(static_cast<unsigned>(code)) % ERROR_SLOTS;
+    for (size_t probe = 0; probe < ERROR_SLOTS; ++probe) {
+        ErrorSlot& slot = thread.errors[(start + probe) % ERROR_SLOTS];
+        int slot_code = slot.code.load(std::memory_order_relaxed);
+        if (slot_code == code && code != 0) {
+            slot.count.store(slot.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+        if (slot_code == 0 && code != 0) {
+            slot.count.store(1, std::memory_order_relaxed);
+            slot.code.store(code, std::memory_order_release);
+            return;
+        }
+    }
+    thread.other_errors.store(thread.other_errors.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::addGauge(const std::string& name, const std::string& help, std::function<double()> read) {
+    std::lock_guard<std::mutex> lock(gauges_mutex);
+    Gauge gauge;
+    gauge.name = name;
+    gauge.help = help;
+    gauge.read = std::move(read);
+    gauges.push_back(std::move(gauge));
+}
+
+uint64_t MetricsRegistry::total(int counter) const {
+    if (counter < 0 || counter >= METRIC_COUNTER_COUNT) {
+        return 0;
+    }
+
+    uint64_t sum = 0;
+    threads.forEach([&](const ThreadMetrics& thread) {
+        sum += thread.counters[counter].load(std::memory_order_relaxed);
+    });
+    return sum;
+}
+
+void MetricsRegistry::totals(std::vector<uint64_t>& out) const {
+    out.assign(METRIC_COUNTER_COUNT, 0);
+
+    threads.forEach([&](const ThreadMetrics& thread) {
+        for (int i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+            out[i] += thread.counters[i].load(std::memory_order_relaxed);
+        }
+    });
+}
+
+std::map<int, uint64_t> MetricsRegistry::errorCounts() const {
+    std::map<int, uint64_t> counts;
+
+    threads.forEach([&](const ThreadMetrics& thread) {
+        for (size_t i = 0; i < ERROR_SLOTS; ++i) {
+            int code = thread.errors[i].code.load(std::memory_order_acquire);
+            if (code != 0) {
+                counts[code] += thread.errors[i].count.load(std::memory_order_relaxed);
+            }
+        }
+        uint64_t other = thread.other_errors.load(std::memory_order_relaxed);
+        if (other > 0) {
+            counts[0] += other;
+        }
+    });
+    return counts;
+}
+
+double MetricsRegistry::uptimeSeconds() const {
+    return static_cast<double>(steadyNowNs() - start_ns) / 1e9;
+}
+
+std::string MetricsRegistry::format(const std::vector<uint64_t>* previous, double seconds) const {
+    std::vector<uint64_t> current;
+    totals(current);
+
+    std::string text;
+    text.reserve(4096);
+
+    for (int i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+        const CounterInfo& info = COUNTERS[i];
+        if (info.help) {
+            appendHeader(text, info.name, info.help, "counter");
+        }
+        if (info.type) {
+            appendValue(text, "autofib_%s{type=\"%s\"} %llu\n", info.name, info.type,
+                        static_cast<unsigned long long>(current[i]));
+        } else {
+            appendValue(text, "autofib_%s %llu\n", info.name, static_cast<unsigned long long>(current[i]));
+        }
+    }
+
+    // Code 0 collects the codes that did not fit a thread's table
+    appendHeader(text, "errors_total", "Errors reported by TWS, by code", "counter");
+    for (const auto& entry : errorCounts()) {
+        if (entry.first == 0) {
+            appendValue(text, "autofib_errors_total{code=\"other\"} %llu\n",
+                        static_cast<unsigned long long>(entry.second));
+        } else {
+            appendValue(text, "autofib_errors_total{code=\"%d\"} %llu\n", entry.first,
+                        static_cast<unsigned long long>(entry.second));
+        }
+    }
+
+    if (previous && previous->size() == current.size() && seconds > 0) {
+        appendHeader(text, "messages_per_second", "Message rate over the last interval, by callback type", "gauge");
+        for (int i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+            if (COUNTERS[i].type) {
+                appendValue(text, "autofib_messages_per_second{type=\"%s\"} %.2f\n", COUNTERS[i].type,
+                            static_cast<double>(current[i] - (*previous)[i]) / seconds);
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(gauges_mutex);
+        for (const Gauge& gauge : gauges) {
+            appendHeader(text, gauge.name, gauge.help.c_str(), "gauge");
+            appendValue(text, "autofib_%s %.17g\n", gauge.name.c_str(), gauge.read());
+        }
+    }
+
+    appendHeader(text, "uptime_seconds", "Seconds since the registry was created", "gauge");
+    appendValue(text, "autofib_uptime_seconds %.3f\n", uptimeSeconds());
+    return text;
+}
+
+MetricsExporter::MetricsExporter()
+    : registry(nullptr), listen_fd(-1), bound_port(0), interval_ms(10000), running(false) {
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start(const MetricsRegistry* source, int httpPort, const std::string& statsFile,
+                            int intervalMs, std::string* error) {
+    if (running) {
+        return true;
+    }
+    if (httpPort < 0 && statsFile.empty()) {
+        if (error) *error = "Neither a port nor a stats file was given";
+        return false;
+    }
+
+    if (httpPort >= 0) {
+        listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd < 0) {
+            if (error) *error = std::string("Cannot create socket: ") + std::strerror(errno);
+            return false;
+        }
+
+        int reuse = 1;
+        ::setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(httpPort));
+
+        socklen_t address_size = sizeof(address);
+        if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(listen_fd, 4) != 0 ||
+            ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_size) != 0) {
+            if (error) *error = "Cannot listen on port " + std::to_string(httpPort) + ": " + std::strerror(errno);
+            ::close(listen_fd);
+            listen_fd = -1;
+            return false;
+        }
+        bound_port = ntohs(address.sin_port);
+    }
+
+    registry = source;
+    file_path = statsFile;
+    interval_ms = intervalMs < 100 ? 100 : intervalMs;
+    running = true;
+    thread = std::thread(&MetricsExporter::run, this);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    // Wake poll()
+    if (listen_fd >= 0) {
+        ::shutdown(listen_fd, SHUT_RDWR);
+    }
+    thread.join();
+
+    if (listen_fd >= 0) {
+        ::close(listen_fd);
+        listen_fd = -1;
+    }
+}
+
+void MetricsExporter::run() {
+    const int64_t interval_ns = static_cast<int64_t>(interval_ms) * 1000000;
+    std::vector<uint64_t> previous;
+    int64_t previous_ns = steadyNowNs();
+    int64_t next_write_ns = previous_ns;
+    bool file_failed = false;
+    registry->totals(previous);
+
+    while (running.load()) {
+        int64_t now = steadyNowNs();
+
+        if (!file_path.empty() && now >= next_write_ns) {
+            std::vector<uint64_t> current;
+            registry->totals(current);
+            double seconds = static_cast<double>(now - previous_ns) / 1e9;
+            bool ok = writeFile(registry->format(&previous, seconds));
+            if (!ok && !file_failed) {
+                std::fprintf(stderr, "Cannot write stats file %s\n", file_path.c_str());
+            }
+            file_failed = !ok;
+            previous.swap(current);
+            previous_ns = now;
+            next_write_ns = now + interval_ns;
+        }
+
+        // Wake at least every 200 ms to notice stop() without a socket
+        int timeout_ms = 200;
+        if (!file_path.empty()) {
+            int64_t due_ms = (next_write_ns - now) / 1000000;
+            if (due_ms < timeout_ms) timeout_ms = due_ms > 0 ? static_cast<int>(due_ms) : 0;
+        }
+
+        if (listen_fd < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+            continue;
+        }
+
+        pollfd listener;
+        listener.fd = listen_fd;
+        listener.events = POLLIN;
+        listener.revents = 0;
+        if (::poll(&listener, 1, timeout_ms) <= 0 || !running.load()) {
+            continue;
+        }
+
+        int fd = ::accept(listen_fd, nullptr, nullptr);
+        if (fd >= 0) {
+            serve(fd);
+            ::close(fd);
+        }
+    }
+}
+
+void MetricsExporter::serve(int fd) {
+    const int64_t deadline_ns = steadyNowNs() + SCRAPE_TIMEOUT_NS;
+
+    // Read the request head; scrapers send a few hundred bytes at most
+    char request[4096];
+    size_t size = 0;
+    while (size < sizeof(request) - 1) {
+        int64_t left_ns = deadline_ns - steadyNowNs();
+        if (left_ns <= 0) {
+            return;
+        }
+        pollfd client;
+        client.fd = fd;
+        client.events = POLLIN;
+        client.revents = 0;
+        if (::poll(&client, 1, static_cast<int>((left_ns + 999999) / 1000000)) <= 0) {
+            return;
+        }
+        ssize_t n = ::recv(fd, request + size, sizeof(request) - 1 - size, 0);
+        if (n <= 0) {
+            return;
+        }
+        size += static_cast<size_t>(n);
+        request[size] = '\0';
+        if (std::strstr(request, "\r\n\r\n") || std::strstr(request, "\n\n")) {
+            break;
+        }
+    }
+    request[size] = '\0';
+
+    std::string body;
+    std::string status;
+    if (std::strncmp(request, "GET /metrics ", 13) == 0 || std::strncmp(request, "GET / ", 6) == 0) {
+        status = "200 OK";
+        body = registry->format();
+    } else {
+        status = "404 Not Found";
+        body = "Not found\n";
+    }
+
+    std::string response = "HTTP/1.1 " + status + "\r\n"
+        "Content-Type: text/plain; version=0.0.4\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "Connection: close\r\n\r\n" + body;
+
+    // The response gets whatever is left of the deadline
+    int64_t left_ns = deadline_ns - steadyNowNs();
+    if (left_ns <= 0) {
+        return;
+    }
+    timeval send_timeout;
+    send_timeout.tv_sec = static_cast<time_t>(left_ns / 1000000000);
+    send_timeout.tv_usec = static_cast<suseconds_t>(left_ns % 1000000000 / 1000);
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+    sendAll(fd, response.data(), response.size());
+}
+
+bool MetricsExporter::writeFile(const std::string& text) {
+    // Write to a temporary file and rename, so readers never see a partial file
+    std::string tmp_path = file_path + ".tmp";
+    std::FILE* out = std::fopen(tmp_path.c_str(), "w");
+    if (!out) {
+        return false;
+    }
+
+    bool ok = std::fwrite(text.data(), 1, text.size(), out) == text.size();
+    ok = std::fclose(out) == 0 && ok;
+    if (!ok || std::rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
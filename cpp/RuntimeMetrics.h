@@ -0,0 +1,160 @@
+/**
+ * Runtime Metrics
+ * Lock-free per-thread counters, sampled gauges and a local scrape endpoint
+ */
+
+#ifndef RUNTIME_METRICS_H
+#define RUNTIME_METRICS_H
+
+#include "ThreadSlots.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Counters; the METRIC_MSG_* entries count messages by callback type
+ */
+enum MetricCounter {
+    METRIC_MSG_HISTORICAL_DATA = 0,
+    METRIC_MSG_HISTORICAL_DATA_END,
+    METRIC_MSG_REALTIME_BAR,
+    METRIC_MSG_TICK_LAST,
+    METRIC_MSG_TICK_BID_ASK,
+    METRIC_MSG_TICK_MIDPOINT,
+    METRIC_MSG_MARKET_DEPTH,
+    METRIC_MSG_ERROR,
+    METRIC_BARS_INGESTED,           // Historical bars stored for a pending request
+    METRIC_CALCULATIONS,            // Indicator calculate() calls
+    METRIC_RESULTS_PUBLISHED,
+    METRIC_SIGNAL_EVENTS,
+    METRIC_HISTORICAL_REQUESTS,     // Requests sent to TWS
+    METRIC_PACING_WAITS,            // Pumps that left queued requests waiting for pacing
+    METRIC_PACING_VIOLATIONS,
+    METRIC_REQUEST_TIMEOUTS,
+    METRIC_COUNTER_COUNT
+};
+
+/**
+ * Metrics Registry
+ * Every thread that counts gets its own block of counters on first use (one
+ * mutex acquisition per thread); after that a count is a thread-local lookup
+ * and a relaxed load and store with no sharing between threads. Totals are
+ * only summed when read. Gauges are functions sampled at read time, so
+ * whatever they inspect is only touched by the reading thread.
+ */
+class MetricsRegistry {
+public:
+    static const size_t ERROR_SLOTS = 64;   // Distinct error codes per thread; more go to "other"
+
+private:
+    struct ErrorSlot {
+        std::atomic<int> code;              // 0 = free; set after count by the owning thread
+        std::atomic<uint64_t> count;
+    };
+
+    struct ThreadMetrics {
+        std::atomic<uint64_t> counters[METRIC_COUNTER_COUNT];
+        ErrorSlot errors[ERROR_SLOTS];
+        std::atomic<uint64_t> other_errors;
+
+        ThreadMetrics();
+    };
+
+    struct Gauge {
+        std::string name;
+        std::string help;
+        std::function<double()> read;
+    };
+
+    const int64_t start_ns;
+    ThreadSlots<ThreadMetrics> threads;
+    mutable std::mutex gauges_mutex;
+    std::vector<Gauge> gauges;
+
+public:
+    MetricsRegistry();
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    void increment(int counter, uint64_t count = 1) {
+        std::atomic<uint64_t>& value = threads.local().counters[counter];
+        value.store(value.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
+
+    /**
+     * Count an error code reported through EWrapper::error()
+     */
+    void countError(int code);
+
+    /**
+     * Sample a value whenever metrics are read (queue depths, open requests, ...)
+     * @param name Metric name without the "autofib_" prefix
+     * @param read Called on the reading thread; must be thread-safe
+     */
+    void addGauge(const std::string& name, const std::string& help, std::function<double()> read);
+
+    uint64_t total(int counter) const;
+    void totals(std::vector<uint64_t>& out) const;
+    std::map<int, uint64_t> errorCounts() const;
+    double uptimeSeconds() const;
+
+    /**
+     * Prometheus text exposition of every counter, error code and gauge
+     * @param previous Totals of an earlier totals() call; adds per-second message rates
+     * @param seconds Time since previous was taken
+     */
+    std::string format(const std::vector<uint64_t>* previous = nullptr, double seconds = 0) const;
+};
+
+/**
+ * Metrics Exporter
+ * One background thread serves "GET /metrics" on a loopback port and/or
+ * rewrites a stats file at a fixed interval (written to a temporary file and
+ * renamed, so readers never see a partial file). The stats file also carries
+ * message rates over the last interval. Scrapes are served one at a time and
+ * each gets one second in total, so a stalled client delays the next scrape
+ * or file write by at most that long.
+ */
+class MetricsExporter {
+private:
+    const MetricsRegistry* registry;
+    int listen_fd;
+    int bound_port;
+    std::string file_path;
+    int interval_ms;
+    std::atomic<bool> running;
+    std::thread thread;
+
+    void run();
+    void serve(int fd);
+    bool writeFile(const std::string& text);
+
+public:
+    MetricsExporter();
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /**
+     * Start exporting
+     * @param httpPort Loopback port for the scrape endpoint (0 = any free port, < 0 = none)
+     * @param statsFile File rewritten every intervalMs (empty = none)
+     * @param error Receives the reason on failure (optional)
+     */
+    bool start(const MetricsRegistry* source, int httpPort, const std::string& statsFile,
+               int intervalMs = 10000, std::string* error = nullptr);
+    void stop();
+
+    int port() const { return bound_port; }
+};
+
+#endif // RUNTIME_METRICS_H
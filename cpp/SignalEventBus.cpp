@@ -0,0 +1,99 @@
+/**
+ * Signal Event Bus Implementation
+ */
+
+#include "SignalEventBus.h"
+#include <cstring>
+#include <thread>
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "The event bus needs lock-free 64-bit atomics");
+
+SignalEventBus::SignalEventBus(size_t capacity) : head(0) {
+    size_t cap = 1;
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+    slots.reset(new Slot[cap]);
+    mask = cap - 1;
+    for (size_t i = 0; i < cap; ++i) {
+        slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+void SignalEventBus::publish(const SignalEvent& event) {
+    uint64_t n = head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[n & mask];
+    uint64_t writing = 2 * n + 1;
+
+    // Take the slot only from an older, finished event. A producer that was
+    // preempted for a whole ring finds a newer event there: its own event
+    // counts as overwritten, so it is dropped instead of tearing the newer one.
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    for (;;) {
+        if (sequence >= writing) {
+            return;
+        }
+        if (sequence & 1) {
+            // The previous lap's producer is still copying its event
+            std::this_thread::yield();
+            sequence = slot.sequence.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (slot.sequence.compare_exchange_weak(sequence, writing, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot.event, &event, sizeof(event));
+    slot.sequence.store(2 * n + 2, std::memory_order_release);
+}
+
+SignalSubscription SignalEventBus::subscribe() {
+    return SignalSubscription(*this, head.load(std::memory_order_acquire));
+}
+
+bool SignalSubscription::poll(SignalEvent& event) {
+    if (!bus) {
+        return false;
+    }
+
+    for (;;) {
+        const SignalEventBus::Slot& slot = bus->slots[cursor & bus->mask];
+        uint64_t published = 2 * cursor + 2;
+
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before < published) {
+            // Not written yet (or still being written by a slower producer)
+            return false;
+        }
+        if (before == published) {
+            std::memcpy(&event, &slot.event, sizeof(event));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == published) {
+                ++cursor;
+                return true;
+            }
+        }
+
+        // Overwritten by a producer a whole ring ahead: skip to the oldest
+        // event that can still be read
+        uint64_t head = bus->head.load(std::memory_order_acquire);
+        uint64_t oldest = head > bus->capacity() ? head - bus->capacity() : 0;
+        uint64_t resume = oldest > cursor + 1 ? oldest : cursor + 1;
+        missed += resume - cursor;
+        cursor = resume;
+    }
+}
+
+SignalEvent makeSignalEvent(uint32_t symbolId, const std::string& symbol, int oldSignal, int newSignal,
+                            double price, int64_t timeNs) {
+    SignalEvent event;
+    std::memset(&event, 0, sizeof(event));
+    event.time_ns = timeNs;
+    event.price = price;
+    event.symbol_id = symbolId;
+    event.old_signal = static_cast<uint8_t>(oldSignal);
+    event.new_signal = static_cast<uint8_t>(newSignal);
+    std::strncpy(event.symbol, symbol.c_str(), sizeof(event.symbol) - 1);
+    return event;
+}
@@ -0,0 +1,117 @@
+/**
+ * Signal Event Bus
+ * Broadcasts signal transitions (HOLD -> BUY, ...) to in-process subscribers
+ */
+
+#ifndef SIGNAL_EVENT_BUS_H
+#define SIGNAL_EVENT_BUS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * One signal transition of a symbol
+ */
+struct SignalEvent {
+    int64_t time_ns;            // Wall clock (epoch nanoseconds) of the transition
+    double price;               // Current price when the signal changed
+    uint32_t symbol_id;         // Producer-assigned id, stable for the process lifetime
+    uint8_t old_signal;         // ResultSignal
+    uint8_t new_signal;         // ResultSignal
+    uint16_t reserved;
+    char symbol[16];            // NUL-padded, truncated to 15 characters
+};
+
+class SignalSubscription;
+
+/**
+ * Signal Event Bus
+ * Fixed ring of events written by any number of producers and read by any
+ * number of subscribers, each with its own cursor. Neither side takes a lock:
+ * a producer claims a sequence number with one atomic increment, takes the
+ * slot with a compare-and-swap on its sequence and publishes the event through
+ * it. Sequences only move forward, so a producer a whole ring late drops its
+ * event rather than tear a newer one. Producers never wait for subscribers
+ * (only, briefly, for a producer still copying into the same slot a ring
+ * earlier); a subscriber that falls a whole ring behind skips ahead and counts
+ * the events it missed.
+ */
+class SignalEventBus {
+private:
+    friend class SignalSubscription;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence;     // 2n+1 while event n is written, 2n+2 once published
+        SignalEvent event;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    alignas(64) std::atomic<uint64_t> head;     // Sequence numbers claimed so far
+
+public:
+    /**
+     * Constructor
+     * @param capacity Events retained for slow subscribers (rounded up to a power of two)
+     */
+    explicit SignalEventBus(size_t capacity = 4096);
+
+    SignalEventBus(const SignalEventBus&) = delete;
+    SignalEventBus& operator=(const SignalEventBus&) = delete;
+
+    /**
+     * Publish an event; safe from any thread, never waits for subscribers
+     */
+    void publish(const SignalEvent& event);
+
+    /**
+     * Start receiving events published from now on
+     */
+    SignalSubscription subscribe();
+
+    size_t capacity() const { return mask + 1; }
+
+    /**
+     * Total number of events published
+     */
+    uint64_t total() const { return head.load(std::memory_order_acquire); }
+};
+
+/**
+ * Read cursor of one subscriber
+ * A subscription is used by one thread at a time and must not outlive its bus.
+ */
+class SignalSubscription {
+private:
+    const SignalEventBus* bus;
+    uint64_t cursor;            // Sequence number of the next event to read
+    uint64_t missed;
+
+public:
+    SignalSubscription() : bus(nullptr), cursor(0), missed(0) {}
+    SignalSubscription(const SignalEventBus& eventBus, uint64_t start) : bus(&eventBus), cursor(start), missed(0) {}
+
+    /**
+     * Take the next event
+     * @return false if no new event is published yet
+     */
+    bool poll(SignalEvent& event);
+
+    /**
+     * Events overwritten before this subscriber read them
+     */
+    uint64_t lost() const { return missed; }
+};
+
+/**
+ * Build an event
+ * @param symbolId Producer-assigned id
+ * @param oldSignal, newSignal ResultSignal values
+ */
+SignalEvent makeSignalEvent(uint32_t symbolId, const std::string& symbol, int oldSignal, int newSignal,
+                            double price, int64_t timeNs);
+
+#endif // SIGNAL_EVENT_BUS_H
@@ -0,0 +1,88 @@
+/**
+ * Thread Slots
+ * One lazily created slot per thread, for per-thread counters that are only
+ * summed when read
+ */
+
+#ifndef THREAD_SLOTS_H
+#define THREAD_SLOTS_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Thread Slots
+ * A thread's first local() creates its slot under a mutex; after that
+ * local() is a thread-local lookup. Slots live as long as the owner, so
+ * readers may visit slots of threads that have exited. Slot must be default
+ * constructible and initialize itself.
+ */
+template <typename Slot>
+class ThreadSlots {
+private:
+    struct Entry {
+        std::thread::id thread;
+        Slot slot;
+    };
+
+    const uint64_t id;                      // Tells owners apart in the thread-local cache
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Entry>> entries;
+
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> next_id(1);
+        return next_id.fetch_add(1);
+    }
+
+    Slot& attach() {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::thread::id self = std::this_thread::get_id();
+        for (const auto& entry : entries) {
+            if (entry->thread == self) {
+                return entry->slot;
+            }
+        }
+
+        entries.push_back(std::make_unique<Entry>());
+        entries.back()->thread = self;
+        return entries.back()->slot;
+    }
+
+public:
+    ThreadSlots() : id(nextId()) {}
+
+    ThreadSlots(const ThreadSlots&) = delete;
+    ThreadSlots& operator=(const ThreadSlots&) = delete;
+
+    /**
+     * The calling thread's slot
+     */
+    Slot& local() {
+        // One cached owner per thread; switching owners falls back to attach()
+        thread_local uint64_t cached_id = 0;
+        thread_local Slot* cached = nullptr;
+        if (cached_id != id) {
+            cached = &attach();
+            cached_id = id;
+        }
+        return *cached;
+    }
+
+    /**
+     * Call visit(const Slot&) for every slot, holding the mutex
+     */
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& entry : entries) {
+            visit(entry->slot);
+        }
+    }
+};
+
+#endif // THREAD_SLOTS_H
@@ -0,0 +1,57 @@
+/**
+ * Tick Ingestor Implementation
+ */
+
+#include "TickIngestor.h"
+
+TickIngestor::TickIngestor(size_t ringCapacity)
+    : ring_capacity(ringCapacity) {
+}
+
+void TickIngestor::addSymbol(int slot) {
+    if (slot >= static_cast<int>(rings.size())) {
+        rings.resize(slot + 1);
+    }
+    if (rings[slot].capacity() == 0) {
+        rings[slot] = TickRingBuffer<TickRecord>(ring_capacity);
+    }
+}
+
+void TickIngestor::onLast(int slot, int64_t time, double price, double size) {
+    TickRecord tick;
+    tick.time = time;
+    tick.price = price;
+    tick.size = size;
+    tick.bid = 0;
+    tick.ask = 0;
+    tick.bid_size = 0;
+    tick.ask_size = 0;
+    tick.kind = TICK_KIND_LAST;
+    rings[slot].push(tick);
+}
+
+void TickIngestor::onBidAsk(int slot, int64_t time, double bid, double ask, double bidSize, double askSize) {
+    TickRecord tick;
+    tick.time = time;
+    tick.price = (bid + ask) / 2.0;
+    tick.size = 0;
+    tick.bid = bid;
+    tick.ask = ask;
+    tick.bid_size = bidSize;
+    tick.ask_size = askSize;
+    tick.kind = TICK_KIND_BID_ASK;
+    rings[slot].push(tick);
+}
+
+void TickIngestor::onMidPoint(int slot, int64_t time, double midPoint) {
+    TickRecord tick;
+    tick.time = time;
+    tick.price = midPoint;
+    tick.size = 0;
+    tick.bid = 0;
+    tick.ask = 0;
+    tick.bid_size = 0;
+    tick.ask_size = 0;
+    tick.kind = TICK_KIND_MIDPOINT;
+    rings[slot].push(tick);
+}
@@ -0,0 +1,50 @@
+/**
+ * Tick Ingestor
+ * Stores tick-by-tick trades, quotes and midpoints into per-symbol ring buffers
+ */
+
+#ifndef TICK_INGESTOR_H
+#define TICK_INGESTOR_H
+
+#include "TickRingBuffer.h"
+#include <vector>
+
+/**
+ * Tick Ingestor
+ * One ring buffer per live slot; ingestion performs no allocation
+ */
+class TickIngestor {
+private:
+    size_t ring_capacity;
+    std::vector<TickRingBuffer<TickRecord>> rings;
+
+public:
+    /**
+     * Constructor
+     * @param ringCapacity Ticks retained per symbol (rounded up to a power of two)
+     */
+    explicit TickIngestor(size_t ringCapacity = 4096);
+
+    /**
+     * Allocate the ring buffer for a slot (no-op if it already exists)
+     */
+    void addSymbol(int slot);
+
+    /**
+     * Check whether a slot has a ring buffer
+     */
+    bool hasSymbol(int slot) const {
+        return slot >= 0 && slot < static_cast<int>(rings.size()) && rings[slot].capacity() > 0;
+    }
+
+    void onLast(int slot, int64_t time, double price, double size);
+    void onBidAsk(int slot, int64_t time, double bid, double ask, double bidSize, double askSize);
+    void onMidPoint(int slot, int64_t time, double midPoint);
+
+    /**
+     * Get the retained ticks of a slot (oldest first)
+     */
+    const TickRingBuffer<TickRecord>& ticks(int slot) const { return rings[slot]; }
+};
+
+#endif // TICK_INGESTOR_H
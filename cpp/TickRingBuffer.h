@@ -0,0 +1,88 @@
+/**
+ * Tick Ring Buffer
+ * Fixed-capacity circular buffer for tick-by-tick data
+ */
+
+#ifndef TICK_RING_BUFFER_H
+#define TICK_RING_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Kind of tick-by-tick record
+ */
+enum TickKind {
+    TICK_KIND_LAST = 0,
+    TICK_KIND_BID_ASK = 1,
+    TICK_KIND_MIDPOINT = 2
+};
+
+/**
+ * One tick-by-tick record (trade, quote or midpoint)
+ */
+struct TickRecord {
+    int64_t time;
+    double price;       // Trade price or midpoint (bid/ask midpoint for quotes)
+    double size;        // Trade size (0 for quotes and midpoints)
+    double bid;
+    double ask;
+    double bid_size;
+    double ask_size;
+    int kind;           // TickKind
+};
+
+/**
+ * Circular buffer that overwrites its oldest element when full
+ * Storage is allocated once on construction; push() never allocates
+ */
+template <typename T>
+class TickRingBuffer {
+private:
+    std::unique_ptr<T[]> data;
+    size_t mask;
+    uint64_t head;      // Total number of elements ever pushed
+
+public:
+    TickRingBuffer() : mask(0), head(0) {}
+
+    /**
+     * Constructor
+     * @param capacity Requested capacity, rounded up to a power of two
+     */
+    explicit TickRingBuffer(size_t capacity) : head(0) {
+        size_t cap = 1;
+        while (cap < capacity) {
+            cap <<= 1;
+        }
+        data.reset(new T[cap]);
+        mask = cap - 1;
+    }
+
+    void push(const T& value) {
+        data[head & mask] = value;
+        ++head;
+    }
+
+    size_t capacity() const { return data ? mask + 1 : 0; }
+    size_t size() const { return head < capacity() ? static_cast<size_t>(head) : capacity(); }
+    bool empty() const { return head == 0; }
+
+    /**
+     * Total number of elements pushed, including overwritten ones
+     */
+    uint64_t total() const { return head; }
+
+    /**
+     * Access by age
+     * @param i 0 = oldest retained element, size() - 1 = newest
+     */
+    const T& operator[](size_t i) const {
+        return data[(head - size() + i) & mask];
+    }
+
+    const T& back() const { return data[(head - 1) & mask]; }
+};
+
+#endif // TICK_RING_BUFFER_H
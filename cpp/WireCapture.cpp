@@ -0,0 +1,231 @@
+/**
+ * Wire Capture Implementation
+ */
+
+#include "WireCapture.h"
+#include "InternalUtil.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+void setNoDelay(int fd) {
+    int no_delay = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+}
+
+int connectTo(const std::string& host, int port, std::string* error) {
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* addresses = nullptr;
+    int rc = ::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses);
+    if (rc != 0) {
+        if (error) *error = "Cannot resolve " + host + ": " + ::gai_strerror(rc);
+        return -1;
+    }
+
+    int fd = -1;
+    int connect_errno = 0;
+    for (addrinfo* address = addresses; address && fd < 0; address = address->ai_next) {
+        fd = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd >= 0 && ::connect(fd, address->ai_addr, address->ai_addrlen) != 0) {
+            connect_errno = errno;
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ::freeaddrinfo(addresses);
+
+    if (fd < 0 && error) {
+        *error = "Cannot connect to " + host + ":" + std::to_string(port) + ": " + std::strerror(connect_errno);
+    }
+    return fd;
+}
+
+} // namespace
+
+WireCapture::WireCapture()
+    : listen_fd(-1), server_fd(-1), bound_port(0), running(false), client_fd(-1) {
+}
+
+WireCapture::~WireCapture() {
+    stop();
+}
+
+bool WireCapture::start(const std::string& host, int port, const std::string& path, std::string* error) {
+    if (running) {
+        return true;
+    }
+
+    server_fd = connectTo(host, port, error);
+    if (server_fd < 0) {
+        return false;
+    }
+    setNoDelay(server_fd);
+
+    listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+
+    socklen_t address_size = sizeof(address);
+    if (listen_fd < 0 ||
+        ::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listen_fd, 1) != 0 ||
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_size) != 0) {
+        if (error) *error = std::string("Cannot listen for the client: ") + std::strerror(errno);
+        if (listen_fd >= 0) ::close(listen_fd);
+        ::close(server_fd);
+        listen_fd = server_fd = -1;
+        return false;
+    }
+
+    log_path = path;
+    bound_port = ntohs(address.sin_port);
+    running = true;
+    thread = std::thread(&WireCapture::run, this);
+    return true;
+}
+
+void WireCapture::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    // Wake accept() and poll()
+    ::shutdown(listen_fd, SHUT_RDWR);
+    ::shutdown(server_fd, SHUT_RDWR);
+    int fd = client_fd.load();
+    if (fd >= 0) {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+    thread.join();
+
+    ::close(listen_fd);
+    ::close(server_fd);
+    listen_fd = server_fd = -1;
+}
+
+WireCapture::Stats WireCapture::getStats() {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return stats;
+}
+
+void WireCapture::run() {
+    int fd = -1;
+    while (running.load() && fd < 0) {
+        fd = ::accept(listen_fd, nullptr, nullptr);
+        if (fd < 0 && errno != EINTR) {
+            break;
+        }
+    }
+    if (fd >= 0) {
+        setNoDelay(fd);
+        client_fd = fd;
+        if (!running.load()) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+    }
+
+    WireLogWriter log;
+    std::string inbound;            // Received from TWS, not yet split into messages
+    bool handshake_done = false;
+    int64_t epoch_ns = 0;
+    char chunk[64 * 1024];
+
+    pollfd fds[2];
+    fds[0].fd = fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = server_fd;
+    fds[1].events = POLLIN;
+
+    while (fd >= 0) {
+        fds[0].revents = fds[1].revents = 0;
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (fds[0].revents) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0 || !sendAll(server_fd, chunk, static_cast<size_t>(n))) {
+                break;
+            }
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            stats.outbound_bytes += static_cast<uint64_t>(n);
+        }
+
+        if (!fds[1].revents) {
+            continue;
+        }
+
+        ssize_t n = ::recv(server_fd, chunk, sizeof(chunk), 0);
+        int64_t received_ns = steadyNowNs();
+        if (n <= 0 || !sendAll(fd, chunk, static_cast<size_t>(n))) {
+            break;
+        }
+        inbound.append(chunk, static_cast<size_t>(n));
+
+        uint64_t messages = 0;
+        uint64_t errors = 0;
+        size_t offset = 0;
+        while (inbound.size() - offset >= 4) {
+            uint32_t length;
+            std::memcpy(&length, inbound.data() + offset, 4);
+            length = ntohl(length);
+            if (inbound.size() - offset - 4 < length) {
+                break;
+            }
+            const char* payload = inbound.data() + offset + 4;
+            offset += 4 + length;
+
+            if (!handshake_done) {
+                // "<server version>\0<connection time>\0" starts the log
+                handshake_done = true;
+                epoch_ns = received_ns;
+                std::string error;
+                if (!log.open(log_path, std::atoi(std::string(payload, length).c_str()), &error)) {
+                    std::fprintf(stderr, "Wire capture disabled: %s\n", error.c_str());
+                }
+                continue;
+            }
+
+            if (log.isOpen()) {
+                if (log.append(received_ns - epoch_ns, payload, length)) {
+                    ++messages;
+                } else {
+                    ++errors;
+                }
+            }
+        }
+        inbound.erase(0, offset);
+        log.flush();
+
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        stats.messages += messages;
+        stats.inbound_bytes += static_cast<uint64_t>(n);
+        stats.write_errors += errors;
+    }
+
+    // Either side closing ends the relay for both; stop() closes the other sockets
+    if (fd >= 0) {
+        client_fd = -1;
+        ::close(fd);
+    }
+    ::shutdown(server_fd, SHUT_RDWR);
+    log.close();
+}
@@ -0,0 +1,73 @@
+/**
+ * Wire Capture
+ * Loopback relay between the client and TWS that records every inbound message
+ */
+
+#ifndef WIRE_CAPTURE_H
+#define WIRE_CAPTURE_H
+
+#include "WireLog.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Wire Capture
+ * The client connects to 127.0.0.1:port() instead of TWS. Bytes are relayed
+ * unchanged in both directions; messages from TWS are forwarded first and
+ * then appended to a wire log with the time they were received, so the
+ * recording adds no parsing to the client's path. The log header carries the
+ * server version from the handshake reply. One connection per capture.
+ */
+class WireCapture {
+public:
+    struct Stats {
+        uint64_t messages;          // Inbound messages recorded
+        uint64_t inbound_bytes;     // Bytes relayed from TWS
+        uint64_t outbound_bytes;    // Bytes relayed to TWS
+        uint64_t write_errors;
+
+        Stats() : messages(0), inbound_bytes(0), outbound_bytes(0), write_errors(0) {}
+    };
+
+private:
+    std::string log_path;
+    int listen_fd;
+    int server_fd;
+    int bound_port;
+    std::atomic<bool> running;
+    std::atomic<int> client_fd;     // Shut down by stop() to end the relay
+    std::thread thread;
+
+    std::mutex stats_mutex;
+    Stats stats;
+
+    void run();
+
+public:
+    WireCapture();
+    ~WireCapture();
+
+    WireCapture(const WireCapture&) = delete;
+    WireCapture& operator=(const WireCapture&) = delete;
+
+    /**
+     * Connect to TWS and listen for the client on a free loopback port
+     * @param host, port TWS/Gateway address
+     * @param path Wire log to create
+     * @param error Receives the reason on failure (optional)
+     */
+    bool start(const std::string& host, int port, const std::string& path, std::string* error = nullptr);
+
+    /**
+     * Close both connections and the log
+     */
+    void stop();
+
+    int port() const { return bound_port; }
+    Stats getStats();
+};
+
+#endif // WIRE_CAPTURE_H
@@ -0,0 +1,168 @@
+/**
+ * Wire Log Implementation
+ */
+
+#include "WireLog.h"
+#include "InternalUtil.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char WIRE_LOG_MAGIC[8] = {'A', 'F', 'W', 'I', 'R', 'E', '\0', '\0'};
+const uint32_t WIRE_LOG_BYTE_ORDER = 0x01020304;
+
+static_assert(sizeof(WireLogHeader) == 64, "WireLogHeader must stay 64 bytes");
+
+// Entry headers are written field by field so the file has no padding
+const size_t ENTRY_BYTES = sizeof(int64_t) + sizeof(uint32_t);
+
+} // namespace
+
+const uint32_t WireLogReader::FORMAT_VERSION;
+
+WireLogWriter::WireLogWriter() : file(nullptr) {
+}
+
+WireLogWriter::~WireLogWriter() {
+    close();
+}
+
+bool WireLogWriter::open(const std::string& path, int serverVersion, std::string* error) {
+    close();
+
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        setError(error, "Cannot open " + path + ": " + std::strerror(errno));
+        return false;
+    }
+
+    WireLogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, WIRE_LOG_MAGIC, sizeof(WIRE_LOG_MAGIC));
+    header.version = WireLogReader::FORMAT_VERSION;
+    header.byte_order = WIRE_LOG_BYTE_ORDER;
+    header.header_size = sizeof(WireLogHeader);
+    header.server_version = serverVersion;
+    header.start_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        setError(error, "Cannot write " + path + ": " + std::strerror(errno));
+        close();
+        return false;
+    }
+
+    log_path = path;
+    return true;
+}
+
+void WireLogWriter::close() {
+    if (file) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+bool WireLogWriter::append(int64_t timeNs, const char* data, uint32_t size) {
+    if (!file) {
+        return false;
+    }
+
+    char entry[ENTRY_BYTES];
+    std::memcpy(entry, &timeNs, sizeof(timeNs));
+    std::memcpy(entry + sizeof(timeNs), &size, sizeof(size));
+    return std::fwrite(entry, 1, ENTRY_BYTES, file) == ENTRY_BYTES &&
+           std::fwrite(data, 1, size, file) == size;
+}
+
+void WireLogWriter::flush() {
+    if (file) {
+        std::fflush(file);
+    }
+}
+
+WireLogReader::WireLogReader()
+    : begin(nullptr), end(nullptr), cursor(nullptr), server_version(0), start_time_ns(0) {
+}
+
+bool WireLogReader::open(const std::string& path, std::string* error) {
+    storage.reset();
+    begin = end = cursor = nullptr;
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        setError(error, "Cannot open " + path);
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(WireLogHeader)) {
+        ::close(fd);
+        setError(error, "Not a wire log: " + path);
+        return false;
+    }
+
+    size_t bytes = static_cast<size_t>(st.st_size);
+    void* addr = mapAndClose(fd, bytes, PROT_READ, MAP_SHARED);
+    if (addr == MAP_FAILED) {
+        setError(error, "Cannot map " + path);
+        return false;
+    }
+
+    std::shared_ptr<const void> mapping(addr, [bytes](const void* p) {
+        ::munmap(const_cast<void*>(p), bytes);
+    });
+
+    const WireLogHeader* header = static_cast<const WireLogHeader*>(addr);
+    if (std::memcmp(header->magic, WIRE_LOG_MAGIC, sizeof(WIRE_LOG_MAGIC)) != 0) {
+        setError(error, "Not a wire log: " + path);
+        return false;
+    }
+    if (header->byte_order != WIRE_LOG_BYTE_ORDER) {
+        setError(error, "Wire log has foreign byte order");
+        return false;
+    }
+    // The entry layout is fixed per version, so a newer log cannot be read
+    if (header->version < 1 || header->version > FORMAT_VERSION) {
+        setError(error, "Unsupported wire log version " + std::to_string(header->version));
+        return false;
+    }
+    if (header->header_size < sizeof(WireLogHeader) || header->header_size > bytes) {
+        setError(error, "Corrupt wire log header");
+        return false;
+    }
+
+    // Replays are read sequentially once
+    ::madvise(addr, bytes, MADV_SEQUENTIAL);
+
+    begin = cursor = static_cast<const char*>(addr) + header->header_size;
+    end = static_cast<const char*>(addr) + bytes;
+    server_version = header->server_version;
+    start_time_ns = header->start_time_ns;
+    storage = std::move(mapping);
+    return true;
+}
+
+bool WireLogReader::next(WireMessage& message) {
+    if (!cursor || static_cast<size_t>(end - cursor) < ENTRY_BYTES) {
+        return false;
+    }
+
+    uint32_t size;
+    std::memcpy(&message.time_ns, cursor, sizeof(message.time_ns));
+    std::memcpy(&size, cursor + sizeof(message.time_ns), sizeof(size));
+    if (static_cast<size_t>(end - cursor) - ENTRY_BYTES < size) {
+        return false;
+    }
+
+    message.data = cursor + ENTRY_BYTES;
+    message.size = size;
+    cursor += ENTRY_BYTES + size;
+    return true;
+}
@@ -0,0 +1,125 @@
+/**
+ * Wire Log
+ * Compact binary log of raw TWS API messages with their receive times
+ *
+ * File layout (little-endian):
+ *
+ *   WireLogHeader                 64 bytes
+ *   message[0]                    int64 time_ns, uint32 size, size payload bytes
+ *   message[1]
+ *   ...
+ *
+ * time_ns is the receive time in monotonic ns since recording started.
+ * A payload is one message as framed on the socket without its 4-byte length
+ * prefix: NUL-terminated fields, starting with the message id. Entries are
+ * not padded; a trailing partial entry is a write in progress and is ignored.
+ */
+
+#ifndef WIRE_LOG_H
+#define WIRE_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+/**
+ * On-disk header of a wire log
+ */
+struct WireLogHeader {
+    char magic[8];              // "AFWIRE\0\0"
+    uint32_t version;           // WireLogReader::FORMAT_VERSION of the producer
+    uint32_t byte_order;        // 0x01020304 as written by the producer
+    uint32_t header_size;       // Entries start here
+    int32_t server_version;     // TWS server version the messages are encoded for
+    int64_t start_time_ns;      // Wall clock (epoch ns) when recording started
+    uint8_t reserved[32];
+};
+
+/**
+ * One message of a mapped log
+ */
+struct WireMessage {
+    int64_t time_ns;            // Receive time, ns since recording started
+    const char* data;
+    uint32_t size;
+};
+
+/**
+ * Wire Log Writer
+ * Buffered appender; not thread-safe.
+ */
+class WireLogWriter {
+private:
+    std::FILE* file;
+    std::string log_path;
+
+public:
+    WireLogWriter();
+    ~WireLogWriter();
+
+    WireLogWriter(const WireLogWriter&) = delete;
+    WireLogWriter& operator=(const WireLogWriter&) = delete;
+
+    /**
+     * Create (truncate) a log and write its header
+     * @param serverVersion Server version the recorded messages use
+     * @param error Receives the reason on failure (optional)
+     */
+    bool open(const std::string& path, int serverVersion, std::string* error = nullptr);
+
+    void close();
+    bool isOpen() const { return file != nullptr; }
+    const std::string& path() const { return log_path; }
+
+    /**
+     * Append one message
+     * @param timeNs Receive time in ns since recording started
+     */
+    bool append(int64_t timeNs, const char* data, uint32_t size);
+
+    void flush();
+};
+
+/**
+ * Wire Log Reader
+ * Read-only view of a memory-mapped log; payloads are used in place.
+ */
+class WireLogReader {
+private:
+    std::shared_ptr<const void> storage;
+    const char* begin;
+    const char* end;
+    const char* cursor;
+    int server_version;
+    int64_t start_time_ns;
+
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+
+    WireLogReader();
+
+    /**
+     * Map a log
+     * @param error Receives the reason on failure (optional)
+     */
+    bool open(const std::string& path, std::string* error = nullptr);
+
+    bool isOpen() const { return begin != nullptr; }
+    int serverVersion() const { return server_version; }
+    int64_t startTimeNs() const { return start_time_ns; }
+
+    /**
+     * Next message
+     * @return false at the end of the log
+     */
+    bool next(WireMessage& message);
+
+    /**
+     * Start over from the first message
+     */
+    void rewind() { cursor = begin; }
+};
+
+#endif // WIRE_LOG_H
@@ -0,0 +1,102 @@
+/**
+ * Wire Replay Implementation
+ */
+
+#include "WireReplay.h"
+#include "InternalUtil.h"
+#include "EDecoder.h"
+#include <chrono>
+#include <thread>
+
+WireReplay::WireReplay()
+    : speed(0), start_ns(-1), base_ns(0), pending(false), finished(true) {
+}
+
+WireReplay::~WireReplay() {
+}
+
+bool WireReplay::open(const std::string& path, EWrapper* wrapper, double replaySpeed, std::string* error) {
+    if (!log.open(path, error)) {
+        finished = true;
+        return false;
+    }
+
+    decoder = std::make_unique<EDecoder>(log.serverVersion(), wrapper);
+    speed = replaySpeed;
+    start_ns = -1;
+    pending = false;
+    finished = false;
+    stats = Stats();
+    return true;
+}
+
+size_t WireReplay::pump(size_t maxMessages) {
+    if (finished) {
+        return 0;
+    }
+
+    int64_t now = steadyNowNs();
+    size_t decoded = 0;
+    while (decoded < maxMessages) {
+        if (!pending) {
+            if (!log.next(message)) {
+                finished = true;
+                break;
+            }
+            pending = true;
+        }
+
+        if (start_ns < 0) {
+            start_ns = now;
+            base_ns = message.time_ns;
+        }
+        if (speed > 0 && start_ns + static_cast<int64_t>((message.time_ns - base_ns) / speed) > now) {
+            break;
+        }
+
+        // The decoder advances the pointer past the message; 0 means it was rejected
+        const char* begin = message.data;
+        if (decoder->parseAndProcessMsg(begin, message.data + message.size) <= 0) {
+            ++stats.decode_errors;
+        }
+        ++stats.messages;
+        stats.bytes += message.size;
+        pending = false;
+        ++decoded;
+    }
+
+    if (decoded > 0) {
+        stats.elapsed_ns = steadyNowNs() - start_ns;
+    }
+    return decoded;
+}
+
+int WireReplay::nextDueMs() {
+    if (finished) {
+        return -1;
+    }
+    if (!pending) {
+        if (!log.next(message)) {
+            finished = true;
+            return -1;
+        }
+        pending = true;
+    }
+    if (speed <= 0 || start_ns < 0) {
+        return 0;
+    }
+
+    int64_t due = start_ns + static_cast<int64_t>((message.time_ns - base_ns) / speed);
+    int64_t wait_ns = due - steadyNowNs();
+    return wait_ns > 0 ? static_cast<int>((wait_ns + 999999) / 1000000) : 0;
+}
+
+void WireReplay::run() {
+    while (!finished) {
+        pump();
+        int wait_ms = nextDueMs();
+        if (wait_ms > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(wait_ms));
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * Wire Replay
+ * Feeds a recorded wire log through EDecoder into EWrapper callbacks, without a socket
+ */
+
+#ifndef WIRE_REPLAY_H
+#define WIRE_REPLAY_H
+
+#include "WireLog.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class EDecoder;
+class EWrapper;
+
+/**
+ * Wire Replay
+ * Messages are decoded on the calling thread exactly as EReader::processMsgs()
+ * would decode them, in recorded order. With a positive speed a message is
+ * decoded once its recorded time, divided by the speed, has elapsed since the
+ * first pump(); otherwise the log is decoded as fast as possible.
+ */
+class WireReplay {
+public:
+    struct Stats {
+        uint64_t messages;          // Messages decoded
+        uint64_t bytes;
+        uint64_t decode_errors;     // Messages the decoder rejected
+        int64_t elapsed_ns;         // From the first pump() to the last message
+
+        Stats() : messages(0), bytes(0), decode_errors(0), elapsed_ns(0) {}
+    };
+
+private:
+    WireLogReader log;
+    std::unique_ptr<EDecoder> decoder;
+    double speed;
+    int64_t start_ns;               // Steady time of the first pump(), -1 before
+    int64_t base_ns;                // Recorded time of the first message
+    bool pending;                   // message is read but not decoded yet
+    bool finished;
+    WireMessage message;
+    Stats stats;
+
+public:
+    WireReplay();
+    ~WireReplay();
+
+    WireReplay(const WireReplay&) = delete;
+    WireReplay& operator=(const WireReplay&) = delete;
+
+    /**
+     * Map a log and prepare a decoder for its server version
+     * @param wrapper Receives the callbacks
+     * @param replaySpeed Time scale (1 = as recorded, <= 0 = as fast as possible)
+     * @param error Receives the reason on failure (optional)
+     */
+    bool open(const std::string& path, EWrapper* wrapper, double replaySpeed = 0.0, std::string* error = nullptr);
+
+    /**
+     * Decode the messages that are due
+     * @param maxMessages Upper bound for this call
+     * @return Messages decoded
+     */
+    size_t pump(size_t maxMessages = static_cast<size_t>(-1));
+
+    /**
+     * Milliseconds until the next message is due (0 if one is due, -1 at the end)
+     */
+    int nextDueMs();
+
+    /**
+     * Decode the whole log, sleeping between messages when paced
+     */
+    void run();
+
+    bool done() const { return finished; }
+    int serverVersion() const { return log.serverVersion(); }
+    const Stats& getStats() const { return stats; }
+};
+
+#endif // WIRE_REPLAY_H
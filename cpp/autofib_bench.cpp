@@ -0,0 +1,393 @@
+/**
+ * Auto Fibonacci Benchmarks
+ * Google Benchmark suite for the indicator, serialization and ingestion hot paths
+ *
+ * Synthetic series run from 1e3 bars up to AUTOFIB_BENCH_MAX_BARS (default
+ * 1e7; 1e8 needs about 6 GB for numeric records). Series of IBKR Bar objects,
+ * which carry a time string each, stop at 1e6. BM_TickCallback drives the
+ * client itself and creates a shared-memory segment while it runs.
+ *
+ * Machine-readable output:
+ *   ./autofib_bench --benchmark_out=autofib_bench.json --benchmark_out_format=json
+ */
+
+#include "AutoFibIndicator.h"
+#include "BarArena.h"
+#include "BarSeries.h"
+#include "BarTime.h"
+#include "IBKRAutoFibClient.h"
+#include "JsonWriter.h"
+#include "RealTimeBarAggregator.h"
+#include "ResultPublisher.h"
+#include "TickIngestor.h"
+#include "WireLog.h"
+#include "bar.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const int64_t MIN_BARS = 1000;
+const int64_t MAX_OBJECT_BARS = 1000000;
+const long FIRST_BAR_TIME = 1735689600;         // 2025-01-01 00:00:00
+const int BAR_SECONDS = 300;
+
+/**
+ * Random walk of numeric bars, generated once per size and reused
+ */
+const std::vector<BarRecord>& recordSeries(size_t count) {
+    static std::vector<BarRecord> bars;
+    if (bars.size() == count) {
+        return bars;
+    }
+
+    std::mt19937 rng(42);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    bars.clear();
+    bars.shrink_to_fit();
+    bars.resize(count);
+
+    double price = 100.0;
+    for (size_t i = 0; i < count; ++i) {
+        BarRecord& bar = bars[i];
+        bar.time = FIRST_BAR_TIME + static_cast<int64_t>(i) * BAR_SECONDS;
+        bar.open = price;
+        price = std::max(1.0, price * (1.0 + 0.002 * noise(rng)));
+        bar.close = price;
+        bar.high = std::max(bar.open, bar.close) * (1.0 + 0.001 * std::abs(noise(rng)));
+        bar.low = std::min(bar.open, bar.close) * (1.0 - 0.001 * std::abs(noise(rng)));
+        bar.volume = DecimalFunctions::doubleToDecimal(1000.0);
+        bar.wap = DecimalFunctions::doubleToDecimal((bar.high + bar.low + bar.close) / 3.0);
+        bar.count = 10;
+    }
+    return bars;
+}
+
+/**
+ * The same walk as IBKR Bar objects (time strings as received from TWS)
+ */
+const std::vector<Bar>& objectSeries(size_t count) {
+    static std::vector<Bar> bars;
+    if (bars.size() == count) {
+        return bars;
+    }
+
+    const std::vector<BarRecord>& records = recordSeries(count);
+    bars.clear();
+    bars.shrink_to_fit();
+    bars.reserve(count);
+    for (const BarRecord& record : records) {
+        bars.push_back(toBar(record));
+    }
+    return bars;
+}
+
+// Indicator over numeric records; args: bars, lookback
+void BM_CalculateRecords(benchmark::State& state) {
+    const std::vector<BarRecord>& bars = recordSeries(static_cast<size_t>(state.range(0)));
+    AutoFibIndicator indicator(static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        FibonacciResults results = indicator.calculate(bars);
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+// Indicator over IBKR Bar objects; args: bars, lookback
+void BM_CalculateBars(benchmark::State& state) {
+    const std::vector<Bar>& bars = objectSeries(static_cast<size_t>(state.range(0)));
+    AutoFibIndicator indicator(static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        FibonacciResults results = indicator.calculate(bars);
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+// Indicator over a columnar series; args: bars, lookback
+void BM_CalculateColumns(benchmark::State& state) {
+    BarSeries series = BarSeries::fromBars(objectSeries(static_cast<size_t>(state.range(0))));
+    AutoFibIndicator indicator(static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        FibonacciResults results = indicator.calculate(series);
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+// Swing high/low search (findLowestBar/findHighestBar): lookback spans the whole series
+void BM_FindSwing(benchmark::State& state) {
+    const std::vector<BarRecord>& bars = recordSeries(static_cast<size_t>(state.range(0)));
+    AutoFibIndicator indicator(static_cast<int>(bars.size()));
+
+    for (auto _ : state) {
+        FibonacciResults results = indicator.calculate(bars);
+        benchmark::DoNotOptimize(results.high_bar_index);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 2 * static_cast<int64_t>(sizeof(double)));
+}
+
+// Per-bar work of historicalData(): parse the time string and append to the request's arena
+void BM_HistoricalIngest(benchmark::State& state) {
+    const std::vector<Bar>& bars = objectSeries(static_cast<size_t>(state.range(0)));
+    BarChunkPool pool;
+
+    for (auto _ : state) {
+        BarArena arena(&pool);
+        arena.reserve(bars.size());
+        BarRecord record;
+        for (const Bar& bar : bars) {
+            if (toBarRecord(bar, record)) {
+                arena.append(record);
+            }
+        }
+        benchmark::DoNotOptimize(arena.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+struct Tick {
+    int slot;
+    int64_t time;
+    double price;
+    double size;
+};
+
+const size_t TICKS = 1 << 16;
+
+/**
+ * One trade every millisecond, round-robin over the symbols
+ */
+std::vector<Tick> tradeStream(int symbols) {
+    std::mt19937 rng(42);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<double> prices(symbols, 100.0);
+    std::vector<Tick> ticks(TICKS);
+    for (size_t i = 0; i < TICKS; ++i) {
+        Tick& tick = ticks[i];
+        tick.slot = static_cast<int>(i % symbols);
+        tick.time = FIRST_BAR_TIME + static_cast<int64_t>(i / 1000);
+        prices[tick.slot] = std::max(1.0, prices[tick.slot] * (1.0 + 0.0001 * noise(rng)));
+        tick.price = prices[tick.slot];
+        tick.size = 100;
+    }
+    return ticks;
+}
+
+// Per-tick work of tickByTickAllLast() before the indicator: ring buffer and
+// in-progress bar of the tick's symbol; args: symbols
+void BM_TickIngest(benchmark::State& state) {
+    const int symbols = static_cast<int>(state.range(0));
+    const std::vector<Tick> ticks = tradeStream(symbols);
+
+    TickIngestor ingestor;
+    RealTimeBarAggregator aggregator;
+    for (int slot = 0; slot < symbols; ++slot) {
+        ingestor.addSymbol(slot);
+        aggregator.addSymbol("SYM" + std::to_string(slot), 5);
+    }
+
+    // Later passes replay the stream shifted forward in time so bars keep completing
+    int64_t shift = 0;
+    const int64_t span = static_cast<int64_t>(TICKS / 1000) + 1;
+    for (auto _ : state) {
+        int closed = 0;
+        for (const Tick& tick : ticks) {
+            ingestor.onLast(tick.slot, tick.time + shift, tick.price, tick.size);
+            closed += aggregator.onTick(tick.slot, tick.time + shift, tick.price, tick.size);
+        }
+        shift += span;
+        benchmark::DoNotOptimize(closed);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(TICKS));
+}
+
+// The whole tickByTickAllLast() callback with the shared-memory publisher on:
+// ingestion, the indicator's price update, the slot publish and the signal
+// check, under the client's locks; args: symbols
+void BM_TickCallback(benchmark::State& state) {
+    const int symbols = static_cast<int>(state.range(0));
+    const std::vector<Tick> ticks = tradeStream(symbols);
+    const std::string segment = "/autofib_bench_" + std::to_string(::getpid());
+    const std::string log_path = "autofib_bench_" + std::to_string(::getpid()) + ".wire";
+
+    // An empty recorded session stands in for TWS, so subscriptions send nothing
+    WireLogWriter log;
+    if (!log.open(log_path, 176)) {
+        state.SkipWithError("Cannot create the replay log");
+        return;
+    }
+    log.close();
+
+    // Subscription chatter would bury the benchmark table; declared before the
+    // client so it also covers the client's destructor
+    struct QuietStdout {
+        QuietStdout() { std::cout.setstate(std::ios::failbit); }
+        ~QuietStdout() { std::cout.clear(); }
+    } quiet;
+    IBKRAutoFibClient client;
+    bool ready = client.openReplay(log_path) && client.enableResultPublisher(segment, symbols);
+    for (int slot = 0; ready && slot < symbols; ++slot) {
+        ready = client.subscribeTickByTick("SYM" + std::to_string(slot), "STK", "SMART", "USD",
+                                           "AllLast", "5 secs");
+    }
+    std::remove(log_path.c_str());
+    if (!ready) {
+        ResultPublisher::unlink(segment);
+        state.SkipWithError("Cannot set up the client");
+        return;
+    }
+
+    const Decimal size = DecimalFunctions::doubleToDecimal(100);
+    TickAttribLast attrib;
+    int64_t shift = 0;
+    const int64_t span = static_cast<int64_t>(TICKS / 1000) + 1;
+    for (auto _ : state) {
+        for (const Tick& tick : ticks) {
+            client.tickByTickAllLast(static_cast<int>(IBKRAutoFibClient::TICK_REQ_ID_BASE + tick.slot), 1,
+                                     static_cast<time_t>(tick.time + shift), tick.price, size, attrib, "", "");
+        }
+        shift += span;
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(TICKS));
+    ResultPublisher::unlink(segment);
+}
+
+void BM_ToJSON(benchmark::State& state) {
+    AutoFibIndicator indicator;
+    indicator.calculate(recordSeries(MIN_BARS));
+
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::string json = indicator.toJSON();
+        bytes += json.size();
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+// Results serialization into a reused writer (the result writer's path)
+void BM_WriteResultsJSON(benchmark::State& state) {
+    AutoFibIndicator indicator;
+    FibonacciResults results = indicator.calculate(recordSeries(MIN_BARS));
+    const char* signal = AutoFibIndicator::signalFor(results);
+    JsonWriter json;
+
+    size_t bytes = 0;
+    for (auto _ : state) {
+        json.clear();
+        writeResultsJSON(json, "AAPL", results, signal);
+        bytes += json.size();
+        benchmark::DoNotOptimize(json.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+// Decimal fields of bars and ticks (volume, WAP, sizes)
+std::vector<std::string> decimalStrings() {
+    std::vector<std::string> values;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> size(1, 100000);
+    for (int i = 0; i < 1024; ++i) {
+        values.push_back(std::to_string(size(rng)) + (i % 4 == 0 ? ".5" : ""));
+    }
+    return values;
+}
+
+void BM_StringToDecimal(benchmark::State& state) {
+    std::vector<std::string> values = decimalStrings();
+    for (auto _ : state) {
+        for (const std::string& value : values) {
+            benchmark::DoNotOptimize(DecimalFunctions::stringToDecimal(value));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values.size()));
+}
+
+void BM_DecimalToDouble(benchmark::State& state) {
+    std::vector<Decimal> values;
+    for (const std::string& value : decimalStrings()) {
+        values.push_back(DecimalFunctions::stringToDecimal(value));
+    }
+    for (auto _ : state) {
+        double sum = 0;
+        for (Decimal value : values) {
+            sum += DecimalFunctions::decimalToDouble(value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values.size()));
+}
+
+void BM_DecimalToString(benchmark::State& state) {
+    std::vector<Decimal> values;
+    for (const std::string& value : decimalStrings()) {
+        values.push_back(DecimalFunctions::stringToDecimal(value));
+    }
+    for (auto _ : state) {
+        for (Decimal value : values) {
+            benchmark::DoNotOptimize(DecimalFunctions::decimalToString(value));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values.size()));
+}
+
+// Sizes 1e3, 1e4, ... up to the limit; lookbacks 20 (live default), 1000 and the whole series
+void seriesArguments(benchmark::internal::Benchmark* benchmark, int64_t maxBars) {
+    benchmark->ArgNames({"bars", "lookback"});
+    for (int64_t bars = MIN_BARS; bars <= maxBars; bars *= 10) {
+        benchmark->Args({bars, 20});
+        benchmark->Args({bars, MIN_BARS});
+        if (bars > MIN_BARS) {
+            benchmark->Args({bars, bars});
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int64_t max_bars = 10000000;
+    if (const char* limit = std::getenv("AUTOFIB_BENCH_MAX_BARS")) {
+        max_bars = std::max<int64_t>(MIN_BARS, std::atoll(limit));
+    }
+    int64_t max_object_bars = std::min(max_bars, MAX_OBJECT_BARS);
+
+    seriesArguments(benchmark::RegisterBenchmark("BM_CalculateRecords", BM_CalculateRecords), max_bars);
+    seriesArguments(benchmark::RegisterBenchmark("BM_CalculateBars", BM_CalculateBars), max_object_bars);
+    seriesArguments(benchmark::RegisterBenchmark("BM_CalculateColumns", BM_CalculateColumns), max_object_bars);
+    benchmark::RegisterBenchmark("BM_FindSwing", BM_FindSwing)
+        ->ArgName("bars")->RangeMultiplier(10)->Range(MIN_BARS, max_bars);
+    benchmark::RegisterBenchmark("BM_HistoricalIngest", BM_HistoricalIngest)
+        ->ArgName("bars")->RangeMultiplier(10)->Range(MIN_BARS, max_object_bars);
+    benchmark::RegisterBenchmark("BM_TickIngest", BM_TickIngest)
+        ->ArgName("symbols")->Arg(1)->Arg(200);
+    benchmark::RegisterBenchmark("BM_TickCallback", BM_TickCallback)
+        ->ArgName("symbols")->Arg(1)->Arg(200);
+    benchmark::RegisterBenchmark("BM_ToJSON", BM_ToJSON);
+    benchmark::RegisterBenchmark("BM_WriteResultsJSON", BM_WriteResultsJSON);
+    benchmark::RegisterBenchmark("BM_StringToDecimal", BM_StringToDecimal);
+    benchmark::RegisterBenchmark("BM_DecimalToDouble", BM_DecimalToDouble);
+    benchmark::RegisterBenchmark("BM_DecimalToString", BM_DecimalToString);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -8,12 +8,13 @@
  */
 
 #include "IBKRAutoFibClient.h"
+#include "ResultRecord.h"
+#include "ResultWriter.h"
 #include <iostream>
 #include <vector>
 #include <string>
 #include <thread>
 #include <chrono>
-#include <fstream>
 
 void printBanner() {
     std::cout << std::string(60, '=') << std::endl;
@@ -35,20 +36,6 @@ void printUsage() {
     std::cout << "  ./autofib_ibkr 127.0.0.1 7496 1   # Live trading" << std::endl;
 }
 
-void saveToFile(const std::string& symbol, const std::string& json) {
-    std::time_t now = std::time(nullptr);
-    char timestamp[100];
-    std::strftime(timestamp, sizeof(timestamp), "%Y%m%d_%H%M%S", std::localtime(&now));
-
-    std::string filename = "autofib_" + symbol + "_" + timestamp + ".json";
-    std::ofstream outfile(filename);
-    if (outfile.is_open()) {
-        outfile << json;
-        outfile.close();
-        std::cout << "Results saved to: " << filename << std::endl;
-    }
-}
-
 int main(int argc, char* argv[]) {
     printBanner();
 
@@ -70,8 +57,9 @@ int main(int argc, char* argv[]) {
     // Symbols to analyze
     std::vector<std::string> symbols = {"AAPL", "MSFT", "SPY"};
 
-    // Create client
+    // Create client (bars are cached between runs, only the tail is downloaded)
     IBKRAutoFibClient client;
+    client.enableBarCache("bar_cache");
 
     // Connect to TWS/Gateway
     std::cout << "Connecting to TWS/Gateway at " << host << ":" << port << "..." << std::endl;
@@ -94,17 +82,30 @@ int main(int argc, char* argv[]) {
     // Wait for connection to fully establish
     std::this_thread::sleep_for(std::chrono::seconds(2));
 
-    // Run indicator on multiple symbols
-    for (const auto& symbol : symbols) {
+    // Run indicator on multiple symbols (requests are paced by the client)
+    std::vector<FibonacciResults> all_results = client.runIndicators(
+        symbols,
+        "STK",      // secType
+        "SMART",    // exchange
+        "USD",      // currency
+        "1 D",      // duration
+        "5 mins"    // barSize
+    );
+
+    // Results are appended as binary records to rolling files in results/ by a background thread
+    ResultWriterConfig writer_config;
+    writer_config.extension = ".afr";
+    writer_config.segment_header = resultFileHeader(AutoFibIndicator().getFibonacciLevels());  // Levels the client uses
+    ResultWriter result_writer(writer_config);
+    std::string writer_error;
+    if (!result_writer.start(&writer_error)) {
+        std::cout << "Results will not be saved: " << writer_error << std::endl;
+    }
+
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        const std::string& symbol = symbols[i];
         try {
-            FibonacciResults results = client.runIndicator(
-                symbol,
-                "STK",      // secType
-                "SMART",    // exchange
-                "USD",      // currency
-                "1 D",      // duration
-                "5 mins"    // barSize
-            );
+            const FibonacciResults& results = all_results[i];
 
             if (results.error.empty()) {
                 // Print report
@@ -130,45 +131,28 @@ int main(int argc, char* argv[]) {
                 std::cout << "  Price in Golden Zone: " << (results.price_in_golden_zone ? "true" : "false") << std::endl;
 
                 // Determine signal
-                std::string signal = "HOLD";
-                if (results.price_in_golden_zone) {
-                    signal = (results.trend == "BULLISH") ? "BUY" : "SELL";
-                }
+                std::string signal = AutoFibIndicator::signalFor(results);
 
                 std::cout << "\n" << std::string(60, '-') << std::endl;
                 std::cout << "SIGNAL: " << signal << std::endl;
                 std::cout << std::string(60, '=') << "\n" << std::endl;
 
-                // Save to JSON (simplified version)
-                std::ostringstream json;
-                json << "{\n";
-                json << "  \"symbol\": \"" << symbol << "\",\n";
-                json << "  \"timestamp\": \"" << results.timestamp << "\",\n";
-                json << "  \"trend\": \"" << results.trend << "\",\n";
-                json << "  \"high_value\": " << results.high_value << ",\n";
-                json << "  \"low_value\": " << results.low_value << ",\n";
-                json << "  \"fibo_range\": " << results.fibo_range << ",\n";
-                json << "  \"current_price\": " << results.current_price << ",\n";
-                json << "  \"golden_zone_low\": " << results.golden_zone_low << ",\n";
-                json << "  \"golden_zone_high\": " << results.golden_zone_high << ",\n";
-                json << "  \"price_in_golden_zone\": " << (results.price_in_golden_zone ? "true" : "false") << ",\n";
-                json << "  \"signal\": \"" << signal << "\"\n";
-                json << "}";
-
-                saveToFile(symbol, json.str());
+                result_writer.appendRecord(static_cast<uint32_t>(i), symbol, std::time(nullptr), results);
 
             } else {
                 std::cout << "Error analyzing " << symbol << ": " << results.error << "\n" << std::endl;
             }
-
-            // Rate limiting
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-
         } catch (const std::exception& e) {
             std::cout << "Error processing " << symbol << ": " << e.what() << "\n" << std::endl;
         }
     }
 
+    result_writer.stop();
+    ResultWriter::Stats writer_stats = result_writer.getStats();
+    if (writer_stats.bytes_written > 0) {
+        std::cout << "Results saved to: " << result_writer.currentSegment() << std::endl;
+    }
+
     // Disconnect
     std::cout << "Disconnecting..." << std::endl;
     client.disconnect();
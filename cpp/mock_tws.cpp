@@ -0,0 +1,94 @@
+/**
+ * Mock TWS Server
+ * Serves synthetic or recorded market data to IBKRAutoFibClient without TWS
+ *
+ * Usage: mock_tws [--port N] [--replay FILE] [--record FILE] [--speed X]
+ *                 [--limit N] [--seed N] [--version N]
+ */
+
+#include "MockTwsServer.h"
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+volatile std::sig_atomic_t stop_requested = 0;
+
+void onSignal(int) {
+    stop_requested = 1;
+}
+
+void usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --port N       Listen port (default 7497, 0 = any free port)\n"
+              << "  --replay FILE  Replay a wire log instead of synthetic data\n"
+              << "  --record FILE  Record every message sent to a wire log\n"
+              << "  --speed X      Time scale of streams and replays (default 1, 0 = as fast as possible)\n"
+              << "  --limit N      Messages per synthetic stream (default unlimited)\n"
+              << "  --seed N       Seed of the synthetic random walk (default 42)\n"
+              << "  --version N    Highest server version offered (default 176)\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    MockTwsConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (option == "--help" || option == "-h" || !value) {
+            usage(argv[0]);
+            return option == "--help" || option == "-h" ? 0 : 1;
+        }
+        ++i;
+
+        if (option == "--port") {
+            config.port = std::atoi(value);
+        } else if (option == "--replay") {
+            config.replay_path = value;
+        } else if (option == "--record") {
+            config.record_path = value;
+        } else if (option == "--speed") {
+            config.speed = std::atof(value);
+        } else if (option == "--limit") {
+            config.stream_limit = std::atoll(value);
+        } else if (option == "--seed") {
+            config.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        } else if (option == "--version") {
+            config.server_version = std::atoi(value);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    MockTwsServer server(config);
+    std::string error;
+    if (!server.start(&error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    std::cout << "Mock TWS listening on 127.0.0.1:" << server.port()
+              << (config.replay_path.empty() ? " (synthetic data)" : " (replaying " + config.replay_path + ")")
+              << std::endl;
+
+    while (!stop_requested) {
+        ::pause();
+    }
+
+    server.stop();
+    MockTwsServer::Stats stats = server.getStats();
+    std::cout << "Served " << stats.connections << " connections, "
+              << stats.requests << " requests, "
+              << stats.messages << " messages (" << stats.bytes << " bytes)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * Auto Fibonacci Indicator Tests
+ */
+
+#include "AutoFibIndicator.h"
+#include "BarArena.h"
+#include "bar.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+// A rise from 100 to 119 over 20 bars
+std::vector<Bar> risingBars(int count) {
+    std::vector<Bar> bars(count);
+    for (int i = 0; i < count; ++i) {
+        bars[i].time = "20240102 09:30:00";
+        bars[i].open = 100 + i;
+        bars[i].close = 100 + i;
+        bars[i].high = 100.5 + i;
+        bars[i].low = 99.5 + i;
+        bars[i].count = 1;
+    }
+    return bars;
+}
+
+} // namespace
+
+TEST(AutoFibIndicator, NoDataBeforeFirstCalculation) {
+    AutoFibIndicator indicator(20);
+    EXPECT_FALSE(indicator.getResults().error.empty());
+    EXPECT_EQ("NO_DATA", indicator.getSignal());
+
+    // Ticks before the first bar do not invent levels
+    indicator.updatePrice(101);
+    EXPECT_EQ(0, indicator.getResults().current_price);
+    EXPECT_EQ("NO_DATA", indicator.getSignal());
+}
+
+TEST(AutoFibIndicator, NotEnoughBarsIsNoData) {
+    AutoFibIndicator indicator(20);
+    FibonacciResults results = indicator.calculate(risingBars(5));
+    EXPECT_EQ("Not enough bars", results.error);
+    EXPECT_EQ("NO_DATA", indicator.getSignal());
+}
+
+TEST(AutoFibIndicator, CalculationClearsNoDataState) {
+    AutoFibIndicator indicator(20);
+    FibonacciResults results = indicator.calculate(risingBars(20));
+    ASSERT_TRUE(results.error.empty()) << results.error;
+    EXPECT_DOUBLE_EQ(119.5, results.high_value);
+    EXPECT_DOUBLE_EQ(99.5, results.low_value);
+    EXPECT_NE("NO_DATA", indicator.getSignal());
+
+    indicator.updatePrice(110);
+    EXPECT_DOUBLE_EQ(110, indicator.getResults().current_price);
+}
+
+TEST(AutoFibIndicator, ArenaMatchesRecords) {
+    std::vector<BarRecord> records;
+    for (const auto& bar : risingBars(20)) {
+        BarRecord record;
+        ASSERT_TRUE(toBarRecord(bar, record));
+        records.push_back(record);
+    }
+    BarChunkPool pool(8);
+    BarArena arena(&pool);
+    arena.append(records.data(), records.size());
+
+    AutoFibIndicator from_records(20);
+    AutoFibIndicator from_arena(20);
+    FibonacciResults expected = from_records.calculate(records);
+    FibonacciResults results = from_arena.calculate(arena);
+    ASSERT_TRUE(results.error.empty()) << results.error;
+    EXPECT_EQ(expected.high_value, results.high_value);
+    EXPECT_EQ(expected.low_value, results.low_value);
+    EXPECT_EQ(expected.high_time, results.high_time);
+    EXPECT_EQ(expected.fibo_levels, results.fibo_levels);
+}
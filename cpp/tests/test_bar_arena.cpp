@@ -0,0 +1,87 @@
+/**
+ * Bar Arena and Bar Time Tests
+ */
+
+#include "BarArena.h"
+#include "BarTime.h"
+#include <gtest/gtest.h>
+#include <ctime>
+
+namespace {
+
+BarRecord recordAt(int64_t time) {
+    BarRecord record = BarRecord();
+    record.time = time;
+    record.close = static_cast<double>(time);
+    return record;
+}
+
+} // namespace
+
+TEST(BarArena, WithoutPoolUsesOwnPool) {
+    BarArena arena;
+    for (int i = 0; i < 3000; ++i) {
+        arena.append(recordAt(i));
+    }
+    ASSERT_EQ(3000u, arena.size());
+    EXPECT_EQ(2999, arena[2999].time);
+
+    // The pool moves with the chunks; the moved-from arena gets a new one
+    BarArena moved(std::move(arena));
+    EXPECT_EQ(1500, moved[1500].time);
+    EXPECT_TRUE(arena.empty());
+    arena.append(recordAt(7));
+    EXPECT_EQ(7, arena[0].time);
+}
+
+TEST(BarArena, AppendRangeCrossesChunks) {
+    BarChunkPool pool(4);
+    BarArena arena(&pool);
+    arena.append(recordAt(0));
+
+    std::vector<BarRecord> records;
+    for (int i = 1; i <= 10; ++i) {
+        records.push_back(recordAt(i));
+    }
+    arena.append(records.data(), records.size());
+    arena.append(records.data(), 0);
+
+    ASSERT_EQ(11u, arena.size());
+    for (size_t i = 0; i < arena.size(); ++i) {
+        EXPECT_EQ(static_cast<int64_t>(i), arena[i].time);
+    }
+
+    std::vector<BarRecord> out;
+    arena.appendTo(out);
+    EXPECT_EQ(11u, out.size());
+}
+
+TEST(BarTime, FormatWallClockIntoBuffer) {
+    char buf[WALL_CLOCK_CHARS + 1];
+    EXPECT_EQ(WALL_CLOCK_CHARS, formatWallClock(0, buf));
+    EXPECT_STREQ("19700101 00:00:00", buf);
+
+    long t = 0;
+    ASSERT_TRUE(parseBarTime("20240229 23:59:58", t));
+    formatWallClock(t, buf);
+    EXPECT_STREQ("20240229 23:59:58", buf);
+    EXPECT_EQ("20240229 23:59:58", formatWallClock(t));
+
+    ASSERT_TRUE(parseBarTime("19991231 09:05:07", t));
+    EXPECT_EQ("19991231 09:05:07", formatWallClock(t));
+}
+
+TEST(BarTime, EpochTimesUseLocalOffset) {
+    // Consecutive bars of one day, then a day half a year later (other DST side)
+    const long epochs[] = {1704205800, 1704206100, 1704229200, 1719928800, 1704205800};
+    for (long epoch : epochs) {
+        std::time_t t = static_cast<std::time_t>(epoch);
+        std::tm tm_buf;
+        localtime_r(&t, &tm_buf);
+
+        long seconds = 0;
+        ASSERT_TRUE(parseBarTime(std::to_string(epoch), seconds));
+        EXPECT_EQ(epoch + tm_buf.tm_gmtoff, seconds);
+        EXPECT_EQ(formatBarTime(epoch), formatWallClock(seconds));
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ * End-to-End Tests
+ * Drives IBKRAutoFibClient against a MockTwsServer on a free loopback port
+ */
+
+#include "IBKRAutoFibClient.h"
+#include "MockTwsServer.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+namespace {
+
+class ClientMockTwsTest : public ::testing::Test {
+protected:
+    MockTwsServer server;
+    IBKRAutoFibClient client;
+
+    static MockTwsConfig serverConfig() {
+        MockTwsConfig config;
+        config.port = 0;
+        config.speed = 0;           // Streams as fast as the client reads
+        config.stream_limit = 300;
+        return config;
+    }
+
+    ClientMockTwsTest() : server(serverConfig()) {}
+
+    void SetUp() override {
+        std::string error;
+        ASSERT_TRUE(server.start(&error)) << error;
+        ASSERT_NE(0, server.port());
+        ASSERT_TRUE(client.connect("127.0.0.1", server.port(), 7));
+        ASSERT_TRUE(client.isConnected());
+    }
+
+    void TearDown() override {
+        client.disconnect();
+        server.stop();
+    }
+};
+
+void expectValid(const FibonacciResults& results) {
+    ASSERT_TRUE(results.error.empty()) << results.error;
+    EXPECT_GT(results.high_value, 0);
+    EXPECT_GE(results.high_value, results.low_value);
+    EXPECT_FALSE(results.fibo_levels.empty());
+    EXPECT_LE(results.golden_zone_low, results.golden_zone_high);
+}
+
+} // namespace
+
+TEST_F(ClientMockTwsTest, HistoricalIndicator) {
+    FibonacciResults results = client.runIndicator("AAPL", "STK", "SMART", "USD", "1 D", "5 mins");
+    expectValid(results);
+}
+
+TEST_F(ClientMockTwsTest, PipelinedIndicators) {
+    std::vector<std::string> symbols = {"AAPL", "MSFT", "SPY", "QQQ"};
+    std::vector<FibonacciResults> results = client.runIndicators(symbols, "STK", "SMART", "USD", "1 D", "5 mins");
+
+    ASSERT_EQ(symbols.size(), results.size());
+    for (const auto& result : results) {
+        expectValid(result);
+    }
+}
+
+TEST_F(ClientMockTwsTest, RealTimeBarsFeedLiveIndicator) {
+    ASSERT_TRUE(client.subscribeRealTimeBars("AAPL", "STK", "SMART", "USD", "1 min"));
+
+    // 300 five-second bars complete at least 20 one-minute bars
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    FibonacciResults results;
+    do {
+        client.processMessages();
+        results = client.getRealTimeResults("AAPL");
+    } while ((!results.error.empty() || results.fibo_levels.empty()) &&
+             std::chrono::steady_clock::now() < deadline);
+
+    expectValid(results);
+    client.cancelRealTimeBars("AAPL");
+}
+
+TEST_F(ClientMockTwsTest, DepthAnalyticsRunWhileWaitingForHistoricalData) {
+    ASSERT_TRUE(client.subscribeMarketDepth("AAPL"));
+
+    // Only runIndicator() reads messages; processMessages() is never called
+    expectValid(client.runIndicator("MSFT", "STK", "SMART", "USD", "1 D", "5 mins"));
+
+    DepthSignals signals;
+    ASSERT_TRUE(client.getDepthSignals("AAPL", signals));
+    EXPECT_GT(signals.imbalance.bid_depth + signals.imbalance.ask_depth, 0);
+}
@@ -0,0 +1,142 @@
+/**
+ * Historical Bar Cache Tests
+ */
+
+#include "HistoricalBarCache.h"
+#include "BarTime.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <unistd.h>
+
+namespace {
+
+const long MONDAY = 1704067200;             // 2024-01-01 00:00:00 (wall clock)
+const long DAY = 86400;
+const long OPEN = 9 * 3600 + 30 * 60;
+const long CLOSE = 16 * 3600;
+const long BAR = 300;
+
+BarRecord barAt(long time) {
+    BarRecord bar = BarRecord();
+    bar.time = time;
+    bar.open = bar.high = bar.low = bar.close = 100.0 + (time % 1000) / 100.0;
+    bar.count = 1;
+    return bar;
+}
+
+// 5-minute regular-hours bars of some days, the last one cut off at lastTime
+std::vector<BarRecord> sessions(const std::vector<long>& days, long lastTime) {
+    std::vector<BarRecord> bars;
+    for (long day : days) {
+        for (long t = day + OPEN; t < day + CLOSE && t <= lastTime; t += BAR) {
+            bars.push_back(barAt(t));
+        }
+    }
+    return bars;
+}
+
+} // namespace
+
+TEST(HistoricalBarCache, CachedRequestMatchesUncached) {
+    // Wednesday at noon: the cache holds Monday and Tuesday in full
+    long wednesday = MONDAY + 2 * DAY;
+    long now = wednesday + 12 * 3600;
+    std::vector<BarRecord> cached = sessions({MONDAY, MONDAY + DAY, wednesday}, now - BAR);
+
+    // An uncached "1 D" request returns today's session so far, "2 D" adds yesterday
+    std::vector<BarRecord> uncached_one = sessions({wednesday}, now - BAR);
+    std::vector<BarRecord> uncached_two = sessions({MONDAY + DAY, wednesday}, now - BAR);
+
+    std::vector<BarRecord> bars = cached;
+    HistoricalBarCache::trimToDuration(bars, "1 D");
+    ASSERT_EQ(uncached_one.size(), bars.size());
+    EXPECT_EQ(uncached_one.front().time, bars.front().time);
+
+    bars = cached;
+    HistoricalBarCache::trimToDuration(bars, "2 D");
+    ASSERT_EQ(uncached_two.size(), bars.size());
+    EXPECT_EQ(uncached_two.front().time, bars.front().time);
+
+    // A 24-hour span would have kept Tuesday afternoon as well
+    bars = cached;
+    HistoricalBarCache::trimToSpan(bars, durationToSeconds("1 D"));
+    EXPECT_GT(bars.size(), uncached_one.size());
+}
+
+TEST(HistoricalBarCache, TradingDaysSkipWeekends) {
+    // Monday morning: "2 D" reaches back to Friday, not Sunday
+    long friday = MONDAY - 3 * DAY;
+    long monday_noon = MONDAY + 12 * 3600;
+    std::vector<BarRecord> bars = sessions({friday - DAY, friday, MONDAY}, monday_noon);
+
+    HistoricalBarCache::trimToDuration(bars, "2 D");
+    ASSERT_FALSE(bars.empty());
+    EXPECT_EQ(friday + OPEN, bars.front().time);
+    EXPECT_EQ(sessions({friday, MONDAY}, monday_noon).size(), bars.size());
+}
+
+TEST(HistoricalBarCache, DailyBarsKeepOneBarPerDay) {
+    std::vector<BarRecord> bars;
+    for (int i = 0; i < 10; ++i) {
+        bars.push_back(barAt(MONDAY + i * DAY));
+    }
+
+    HistoricalBarCache::trimToDuration(bars, "5 D");
+    ASSERT_EQ(5u, bars.size());
+    EXPECT_EQ(MONDAY + 5 * DAY, bars.front().time);
+}
+
+TEST(HistoricalBarCache, OtherDurationsKeepCalendarSpan) {
+    std::vector<BarRecord> bars = sessions({MONDAY}, MONDAY + CLOSE);
+
+    // The last hour before the 15:55 bar: 15:00 onwards
+    HistoricalBarCache::trimToDuration(bars, "3600 S");
+    ASSERT_EQ(12u, bars.size());
+    EXPECT_EQ(MONDAY + CLOSE - 3600, bars.front().time);
+
+    std::vector<BarRecord> empty;
+    HistoricalBarCache::trimToDuration(empty, "1 D");
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST(HistoricalBarCache, MergeReplacesRefetchedTail) {
+    BarChunkPool pool(4);
+    std::vector<BarRecord> cached = sessions({MONDAY}, MONDAY + OPEN + 5 * BAR);
+    ASSERT_EQ(6u, cached.size());
+
+    // The last cached bar is downloaded again, followed by two new ones
+    BarArena fresh(&pool);
+    for (long t = MONDAY + OPEN + 5 * BAR; t <= MONDAY + OPEN + 7 * BAR; t += BAR) {
+        BarRecord bar = barAt(t);
+        bar.close = 1;
+        fresh.append(bar);
+    }
+
+    HistoricalBarCache::merge(cached, fresh);
+    ASSERT_EQ(8u, cached.size());
+    EXPECT_EQ(1, cached[5].close);
+    EXPECT_EQ(MONDAY + OPEN + 7 * BAR, cached.back().time);
+}
+
+TEST(HistoricalBarCache, StoreAndLoadRoundTrip) {
+    std::string directory = ::testing::TempDir() + "autofib_bar_cache_" + std::to_string(::getpid());
+    HistoricalBarCache cache(directory);
+    std::string key = HistoricalBarCache::makeKey("AAPL", "STK", "SMART", "USD", "5 mins", "TRADES");
+
+    std::vector<BarRecord> bars = sessions({MONDAY}, MONDAY + CLOSE);
+    bars[3].open = 123.456789012345678;
+    ASSERT_TRUE(cache.store(key, bars));
+
+    std::vector<BarRecord> loaded;
+    ASSERT_TRUE(cache.load(key, loaded));
+    ASSERT_EQ(bars.size(), loaded.size());
+    EXPECT_EQ(bars[3].time, loaded[3].time);
+    EXPECT_EQ(bars[3].open, loaded[3].open);
+
+    std::vector<BarRecord> missing;
+    EXPECT_FALSE(cache.load(key + "_other", missing));
+
+    std::string path = directory + "/AAPL_STK_SMART_USD_5_mins_TRADES.csv";
+    std::remove(path.c_str());
+    ::rmdir(directory.c_str());
+}
@@ -0,0 +1,159 @@
+/**
+ * Historical Request Scheduler Tests
+ */
+
+#include "HistoricalRequestScheduler.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+typedef HistoricalRequestScheduler::Clock Clock;
+
+Clock::time_point after(Clock::time_point start, double seconds) {
+    return start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+PacingConfig smallBucket() {
+    PacingConfig pacing;
+    pacing.burst = 2;
+    pacing.refill_per_second = 1;
+    pacing.max_in_flight = 10;
+    pacing.identical_gap_seconds = 15;
+    pacing.initial_backoff_seconds = 4;
+    pacing.max_backoff_seconds = 10;
+    return pacing;
+}
+
+} // namespace
+
+TEST(HistoricalRequestScheduler, BurstThenRefillRate) {
+    HistoricalRequestScheduler scheduler(smallBucket());
+    Clock::time_point start = Clock::now();
+
+    for (int id = 1; id <= 4; ++id) {
+        scheduler.enqueue(id, "key" + std::to_string(id));
+    }
+
+    EXPECT_EQ(1, scheduler.nextReady(start));
+    EXPECT_EQ(2, scheduler.nextReady(start));
+    EXPECT_EQ(-1, scheduler.nextReady(start));
+    EXPECT_EQ(-1, scheduler.nextReady(after(start, 0.5)));
+    EXPECT_EQ(3, scheduler.nextReady(after(start, 1.0)));
+    EXPECT_EQ(-1, scheduler.nextReady(after(start, 1.5)));
+    EXPECT_EQ(4, scheduler.nextReady(after(start, 2.0)));
+
+    EXPECT_EQ(0u, scheduler.pending());
+    EXPECT_EQ(4, scheduler.issued());
+    EXPECT_EQ(4, scheduler.inFlight());
+}
+
+TEST(HistoricalRequestScheduler, UnpacedRequestsNeedNoTokens) {
+    HistoricalRequestScheduler scheduler(smallBucket());
+    Clock::time_point start = Clock::now();
+
+    scheduler.enqueue(1, "a");
+    scheduler.enqueue(2, "b");
+    scheduler.enqueue(3, "c");
+    scheduler.enqueue(4, "d", false);
+
+    EXPECT_EQ(1, scheduler.nextReady(start));
+    EXPECT_EQ(2, scheduler.nextReady(start));
+
+    // Out of tokens: the unpaced request overtakes the paced one
+    EXPECT_EQ(4, scheduler.nextReady(start));
+    EXPECT_EQ(-1, scheduler.nextReady(start));
+}
+
+TEST(HistoricalRequestScheduler, LimitsOpenRequests) {
+    PacingConfig pacing = smallBucket();
+    pacing.burst = 10;
+    pacing.max_in_flight = 2;
+    HistoricalRequestScheduler scheduler(pacing);
+    Clock::time_point start = Clock::now();
+
+    for (int id = 1; id <= 3; ++id) {
+        scheduler.enqueue(id, "key" + std::to_string(id));
+    }
+
+    EXPECT_EQ(1, scheduler.nextReady(start));
+    EXPECT_EQ(2, scheduler.nextReady(start));
+    EXPECT_EQ(-1, scheduler.nextReady(start));
+
+    scheduler.onCompleted(1);
+    EXPECT_EQ(3, scheduler.nextReady(start));
+}
+
+TEST(HistoricalRequestScheduler, SpacesIdenticalRequests) {
+    PacingConfig pacing = smallBucket();
+    pacing.burst = 10;
+    HistoricalRequestScheduler scheduler(pacing);
+    Clock::time_point start = Clock::now();
+
+    scheduler.enqueue(1, "same");
+    scheduler.enqueue(2, "same");
+    scheduler.enqueue(3, "other");
+
+    EXPECT_EQ(1, scheduler.nextReady(start));
+    EXPECT_EQ(3, scheduler.nextReady(start));
+    EXPECT_EQ(-1, scheduler.nextReady(after(start, 14.9)));
+    EXPECT_EQ(2, scheduler.nextReady(after(start, 15.0)));
+}
+
+TEST(HistoricalRequestScheduler, PacingViolationBacksOff) {
+    PacingConfig pacing = smallBucket();
+    pacing.burst = 10;
+    pacing.refill_per_second = 10;
+    HistoricalRequestScheduler scheduler(pacing);
+    Clock::time_point start = Clock::now();
+
+    scheduler.enqueue(1, "a");
+    scheduler.enqueue(2, "b");
+    ASSERT_EQ(1, scheduler.nextReady(start));
+
+    // The violated request goes back to the front and everything waits 4 s
+    scheduler.onPacingViolation(1, "a", true, start);
+    EXPECT_EQ(1, scheduler.violations());
+    EXPECT_EQ(0, scheduler.inFlight());
+    EXPECT_EQ(2u, scheduler.pending());
+    EXPECT_EQ(-1, scheduler.nextReady(after(start, 3.9)));
+    EXPECT_EQ(1, scheduler.nextReady(after(start, 4.0)));
+
+    // A second violation doubles the back-off
+    scheduler.onPacingViolation(1, "a", true, after(start, 4.0));
+    EXPECT_EQ(-1, scheduler.nextReady(after(start, 11.9)));
+    EXPECT_EQ(1, scheduler.nextReady(after(start, 12.0)));
+
+    // ... up to the ceiling
+    scheduler.onPacingViolation(1, "a", true, after(start, 12.0));
+    EXPECT_EQ(-1, scheduler.nextReady(after(start, 21.9)));
+    EXPECT_EQ(1, scheduler.nextReady(after(start, 22.0)));
+
+    // A completed request resets it
+    scheduler.onCompleted(1);
+    ASSERT_EQ(2, scheduler.nextReady(after(start, 22.0)));
+    scheduler.onPacingViolation(2, "b", true, after(start, 22.0));
+    EXPECT_EQ(-1, scheduler.nextReady(after(start, 25.9)));
+    EXPECT_EQ(2, scheduler.nextReady(after(start, 26.0)));
+}
+
+TEST(HistoricalRequestScheduler, ReleaseKeepsBackOff) {
+    PacingConfig pacing = smallBucket();
+    pacing.burst = 10;
+    pacing.refill_per_second = 10;
+    HistoricalRequestScheduler scheduler(pacing);
+    Clock::time_point start = Clock::now();
+
+    scheduler.enqueue(1, "a");
+    scheduler.enqueue(2, "b");
+    ASSERT_EQ(1, scheduler.nextReady(start));
+    scheduler.onPacingViolation(1, "a", true, start);
+    ASSERT_EQ(1, scheduler.nextReady(after(start, 4.0)));
+
+    // A timed-out request frees its slot but is no sign that pacing recovered
+    scheduler.release(1);
+    EXPECT_EQ(0, scheduler.inFlight());
+    ASSERT_EQ(2, scheduler.nextReady(after(start, 4.0)));
+    scheduler.onPacingViolation(2, "b", true, after(start, 4.0));
+    EXPECT_EQ(-1, scheduler.nextReady(after(start, 11.9)));
+    EXPECT_EQ(2, scheduler.nextReady(after(start, 12.0)));
+}
@@ -0,0 +1,100 @@
+/**
+ * Iceberg Detector Tests
+ */
+
+#include "IcebergDetector.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+class IcebergDetectorTest : public ::testing::Test {
+protected:
+    OrderBook book;
+    IcebergDetector detector;
+    TickRingBuffer<IcebergEvent> events;
+    std::vector<double> bid_icebergs;
+    std::vector<double> ask_icebergs;
+    int64_t now_ms;
+
+    IcebergDetectorTest() : events(16), now_ms(0) {}
+
+    // Asks 100.01 .. 100.05 of size 10, with a large level on top
+    void SetUp() override {
+        for (int i = 0; i < 5; ++i) {
+            ASSERT_TRUE(book.apply(i, BOOK_OP_INSERT, BOOK_SIDE_ASK, 100.01 + 0.01 * i, 10));
+            ASSERT_TRUE(book.apply(i, BOOK_OP_INSERT, BOOK_SIDE_BID, 100.00 - 0.01 * i, 10));
+        }
+        ASSERT_TRUE(book.apply(0, BOOK_OP_UPDATE, BOOK_SIDE_ASK, 100.01, 200));
+        update();
+    }
+
+    void update() {
+        now_ms += 100;
+        detector.update(book, now_ms, 3, bid_icebergs, ask_icebergs, events);
+    }
+};
+
+} // namespace
+
+TEST_F(IcebergDetectorTest, FlagsLargeLevelThatHolds) {
+    update();
+    ASSERT_EQ(1u, ask_icebergs.size());
+    EXPECT_DOUBLE_EQ(100.01, ask_icebergs[0]);
+    EXPECT_TRUE(bid_icebergs.empty());
+    EXPECT_EQ(0u, events.size());
+}
+
+TEST_F(IcebergDetectorTest, PartialHitAndRefill) {
+    ASSERT_TRUE(book.apply(0, BOOK_OP_UPDATE, BOOK_SIDE_ASK, 100.01, 120));
+    update();
+    ASSERT_TRUE(book.apply(0, BOOK_OP_UPDATE, BOOK_SIDE_ASK, 100.01, 200));
+    update();
+
+    ASSERT_EQ(1u, events.size());
+    EXPECT_DOUBLE_EQ(100.01, events[0].price);
+    EXPECT_EQ(BOOK_SIDE_ASK, events[0].side);
+    EXPECT_EQ(3, events[0].slot);
+    EXPECT_EQ(1, events[0].refills);
+}
+
+TEST_F(IcebergDetectorTest, FullHitRefilledAtSamePrice) {
+    // The level is taken out entirely, then shows again at the same size
+    ASSERT_TRUE(book.apply(0, BOOK_OP_DELETE, BOOK_SIDE_ASK, 100.01, 0));
+    update();
+    EXPECT_EQ(0u, events.size());
+
+    ASSERT_TRUE(book.apply(0, BOOK_OP_INSERT, BOOK_SIDE_ASK, 100.01, 200));
+    update();
+    ASSERT_EQ(1u, events.size());
+    EXPECT_DOUBLE_EQ(100.01, events[0].price);
+    EXPECT_EQ(1, events[0].refills);
+
+    // A second full hit and refill keeps counting
+    ASSERT_TRUE(book.apply(0, BOOK_OP_DELETE, BOOK_SIDE_ASK, 100.01, 0));
+    update();
+    ASSERT_TRUE(book.apply(0, BOOK_OP_INSERT, BOOK_SIDE_ASK, 100.01, 200));
+    update();
+    ASSERT_EQ(2u, events.size());
+    EXPECT_EQ(2, events[1].refills);
+}
+
+TEST_F(IcebergDetectorTest, RemovedLevelIsForgottenAfterOneUpdate) {
+    ASSERT_TRUE(book.apply(0, BOOK_OP_DELETE, BOOK_SIDE_ASK, 100.01, 0));
+    update();
+    update();
+
+    ASSERT_TRUE(book.apply(0, BOOK_OP_INSERT, BOOK_SIDE_ASK, 100.01, 200));
+    update();
+    EXPECT_EQ(0u, events.size());
+}
+
+TEST_F(IcebergDetectorTest, ResetForgetsHistory) {
+    ASSERT_TRUE(book.apply(0, BOOK_OP_DELETE, BOOK_SIDE_ASK, 100.01, 0));
+    update();
+    detector.reset();
+
+    ASSERT_TRUE(book.apply(0, BOOK_OP_INSERT, BOOK_SIDE_ASK, 100.01, 200));
+    update();
+    EXPECT_EQ(0u, events.size());
+    EXPECT_TRUE(ask_icebergs.empty());
+}
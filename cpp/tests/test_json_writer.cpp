@@ -0,0 +1,75 @@
+/**
+ * JSON Writer Tests
+ */
+
+#include "JsonWriter.h"
+#include "AutoFibIndicator.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+
+std::string written(double number) {
+    JsonWriter json;
+    json.value(number);
+    return json.str();
+}
+
+} // namespace
+
+TEST(JsonWriter, WritesNestedDocument) {
+    JsonWriter json(4);
+    json.beginObject();
+    json.key("name");
+    json.value("a\"b\\c\n");
+    json.key("list");
+    json.beginArray();
+    json.value(1);
+    json.value(true);
+    json.null();
+    json.endArray();
+    json.key("empty");
+    json.beginObject();
+    json.endObject();
+    json.endObject();
+
+    EXPECT_EQ("{\"name\":\"a\\\"b\\\\c\\n\",\"list\":[1,true,null],\"empty\":{}}", json.str());
+
+    // clear() starts a new document
+    json.clear();
+    json.value(false);
+    EXPECT_EQ("false", json.str());
+}
+
+TEST(JsonWriter, DoublesRoundTrip) {
+    EXPECT_EQ("150.25", written(150.25));
+    EXPECT_EQ("-0.001", written(-0.001));
+    EXPECT_EQ("100", written(100));
+    EXPECT_EQ("0", written(0.0));
+
+    const double values[] = {150.67061999999999, 1e-9, 123456789.125, -2.5e300, 0.1 + 0.2};
+    for (double value : values) {
+        EXPECT_EQ(value, std::strtod(written(value).c_str(), nullptr)) << written(value);
+    }
+}
+
+TEST(JsonWriter, KeepsSignOfNegativeZero) {
+    EXPECT_EQ("-0", written(-0.0));
+    EXPECT_TRUE(std::signbit(std::strtod(written(-0.0).c_str(), nullptr)));
+}
+
+TEST(JsonWriter, NonFiniteIsNull) {
+    EXPECT_EQ("null", written(std::numeric_limits<double>::quiet_NaN()));
+    EXPECT_EQ("null", written(-std::numeric_limits<double>::infinity()));
+}
+
+TEST(JsonWriter, ErrorResultsCarryOnlyErrorAndSignal) {
+    FibonacciResults results;
+    results.error = "No data received";
+
+    JsonWriter json;
+    writeResultsJSON(json, "AAPL", results, "NO_DATA");
+    EXPECT_EQ("{\"symbol\":\"AAPL\",\"error\":\"No data received\",\"signal\":\"NO_DATA\"}", json.str());
+}
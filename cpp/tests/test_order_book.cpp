@@ -0,0 +1,140 @@
+/**
+ * Order Book Tests
+ */
+
+#include "OrderBook.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+
+namespace {
+
+// Bids 100.00, 99.99, ... and asks 100.01, 100.02, ... of the given sizes
+void fill(OrderBook& book, int levels, double size) {
+    for (int i = 0; i < levels; ++i) {
+        ASSERT_TRUE(book.apply(i, BOOK_OP_INSERT, BOOK_SIDE_BID, 100.00 - 0.01 * i, size));
+        ASSERT_TRUE(book.apply(i, BOOK_OP_INSERT, BOOK_SIDE_ASK, 100.01 + 0.01 * i, size));
+    }
+}
+
+} // namespace
+
+TEST(OrderBook, StartsEmpty) {
+    OrderBook book;
+    EXPECT_EQ(0, book.levels(BOOK_SIDE_BID));
+    EXPECT_EQ(0, book.levels(BOOK_SIDE_ASK));
+    EXPECT_EQ(0, book.bestBid());
+    EXPECT_EQ(0, book.spread());
+    EXPECT_EQ(0, book.midpoint());
+    EXPECT_EQ(0, book.totalSize(BOOK_SIDE_BID));
+}
+
+TEST(OrderBook, HeapBooksKeepAlignment) {
+    // MarketDepthEngine allocates its books with plain new
+    for (int i = 0; i < 8; ++i) {
+        std::unique_ptr<OrderBook> book = std::make_unique<OrderBook>();
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(book.get()) % alignof(OrderBook));
+    }
+}
+
+TEST(OrderBook, InsertShiftsWorseLevels) {
+    OrderBook book;
+    ASSERT_TRUE(book.apply(0, BOOK_OP_INSERT, BOOK_SIDE_BID, 99.98, 300));
+    ASSERT_TRUE(book.apply(0, BOOK_OP_INSERT, BOOK_SIDE_BID, 100.00, 100));
+    ASSERT_TRUE(book.apply(1, BOOK_OP_INSERT, BOOK_SIDE_BID, 99.99, 200));
+
+    ASSERT_EQ(3, book.levels(BOOK_SIDE_BID));
+    EXPECT_DOUBLE_EQ(100.00, book.price(BOOK_SIDE_BID, 0));
+    EXPECT_DOUBLE_EQ(99.99, book.price(BOOK_SIDE_BID, 1));
+    EXPECT_DOUBLE_EQ(99.98, book.price(BOOK_SIDE_BID, 2));
+    EXPECT_DOUBLE_EQ(100, book.cumulativeSize(BOOK_SIDE_BID, 1));
+    EXPECT_DOUBLE_EQ(300, book.cumulativeSize(BOOK_SIDE_BID, 2));
+    EXPECT_DOUBLE_EQ(600, book.totalSize(BOOK_SIDE_BID));
+}
+
+TEST(OrderBook, UpdateAndDeleteKeepPrefixSums) {
+    OrderBook book;
+    fill(book, 5, 100);
+
+    ASSERT_TRUE(book.apply(2, BOOK_OP_UPDATE, BOOK_SIDE_ASK, 100.03, 700));
+    EXPECT_DOUBLE_EQ(900, book.cumulativeSize(BOOK_SIDE_ASK, 3));
+    EXPECT_DOUBLE_EQ(1100, book.totalSize(BOOK_SIDE_ASK));
+
+    ASSERT_TRUE(book.apply(0, BOOK_OP_DELETE, BOOK_SIDE_ASK, 0, 0));
+    ASSERT_EQ(4, book.levels(BOOK_SIDE_ASK));
+    EXPECT_DOUBLE_EQ(100.02, book.bestAsk());
+    EXPECT_DOUBLE_EQ(800, book.cumulativeSize(BOOK_SIDE_ASK, 2));
+    EXPECT_DOUBLE_EQ(1000, book.totalSize(BOOK_SIDE_ASK));
+
+    // Depth requests past the book are clamped
+    EXPECT_DOUBLE_EQ(1000, book.cumulativeSize(BOOK_SIDE_ASK, 50));
+    EXPECT_DOUBLE_EQ(0, book.cumulativeSize(BOOK_SIDE_ASK, 0));
+}
+
+TEST(OrderBook, UpdatePastTheEndInserts) {
+    OrderBook book;
+    ASSERT_TRUE(book.apply(0, BOOK_OP_UPDATE, BOOK_SIDE_BID, 100.00, 100));
+    ASSERT_TRUE(book.apply(1, BOOK_OP_UPDATE, BOOK_SIDE_BID, 99.99, 200));
+    EXPECT_EQ(2, book.levels(BOOK_SIDE_BID));
+    EXPECT_DOUBLE_EQ(300, book.totalSize(BOOK_SIDE_BID));
+}
+
+TEST(OrderBook, RejectsOperationsOutsideTheBook) {
+    OrderBook book;
+    fill(book, 2, 100);
+
+    EXPECT_FALSE(book.apply(5, BOOK_OP_INSERT, BOOK_SIDE_BID, 99.0, 100));
+    EXPECT_FALSE(book.apply(3, BOOK_OP_UPDATE, BOOK_SIDE_BID, 99.0, 100));
+    EXPECT_FALSE(book.apply(2, BOOK_OP_DELETE, BOOK_SIDE_BID, 0, 0));
+    EXPECT_FALSE(book.apply(-1, BOOK_OP_INSERT, BOOK_SIDE_BID, 99.0, 100));
+    EXPECT_FALSE(book.apply(OrderBook::MAX_LEVELS, BOOK_OP_INSERT, BOOK_SIDE_BID, 99.0, 100));
+    EXPECT_FALSE(book.apply(0, BOOK_OP_INSERT, 2, 99.0, 100));
+    EXPECT_FALSE(book.apply(0, 7, BOOK_SIDE_BID, 99.0, 100));
+    EXPECT_EQ(2, book.levels(BOOK_SIDE_BID));
+}
+
+TEST(OrderBook, FullBookDropsWorstLevel) {
+    OrderBook book;
+    fill(book, OrderBook::MAX_LEVELS, 1);
+
+    ASSERT_TRUE(book.apply(0, BOOK_OP_INSERT, BOOK_SIDE_BID, 100.50, 10));
+    EXPECT_EQ(OrderBook::MAX_LEVELS, book.levels(BOOK_SIDE_BID));
+    EXPECT_DOUBLE_EQ(100.50, book.bestBid());
+    EXPECT_DOUBLE_EQ(100.00 - 0.01 * (OrderBook::MAX_LEVELS - 2),
+                     book.price(BOOK_SIDE_BID, OrderBook::MAX_LEVELS - 1));
+    EXPECT_DOUBLE_EQ(10 + OrderBook::MAX_LEVELS - 1, book.totalSize(BOOK_SIDE_BID));
+}
+
+TEST(OrderBook, SpreadAndMidpoint) {
+    OrderBook book;
+    fill(book, 3, 100);
+    EXPECT_NEAR(0.01, book.spread(), 1e-9);
+    EXPECT_NEAR(100.005, book.midpoint(), 1e-9);
+
+    book.clear();
+    EXPECT_EQ(0, book.levels(BOOK_SIDE_ASK));
+    EXPECT_EQ(0, book.spread());
+}
+
+TEST(OrderBook, DepthWithinPriceLimit) {
+    OrderBook book;
+    fill(book, 10, 100);
+
+    // Bids at or above the limit, asks at or below it
+    EXPECT_EQ(3, book.levelsWithin(BOOK_SIDE_BID, 99.975));
+    EXPECT_EQ(3, book.levelsWithin(BOOK_SIDE_ASK, 100.035));
+    EXPECT_EQ(0, book.levelsWithin(BOOK_SIDE_BID, 100.5));
+    EXPECT_EQ(10, book.levelsWithin(BOOK_SIDE_ASK, 101.0));
+    EXPECT_DOUBLE_EQ(300, book.sizeWithin(BOOK_SIDE_BID, 99.975));
+    EXPECT_DOUBLE_EQ(1000, book.sizeWithin(BOOK_SIDE_ASK, 101.0));
+}
+
+TEST(OrderBook, CopiesAreIndependent) {
+    OrderBook book;
+    fill(book, 4, 100);
+
+    OrderBook copy = book;
+    ASSERT_TRUE(book.apply(0, BOOK_OP_DELETE, BOOK_SIDE_BID, 0, 0));
+    EXPECT_EQ(4, copy.levels(BOOK_SIDE_BID));
+    EXPECT_DOUBLE_EQ(400, copy.totalSize(BOOK_SIDE_BID));
+}
@@ -0,0 +1,231 @@
+/**
+ * Real-Time Bar Aggregator Tests
+ */
+
+#include "RealTimeBarAggregator.h"
+#include "BarTime.h"
+#include "Decimal.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+const long T0 = 1700000040;     // Start of a minute
+
+double volumeOf(const Bar& bar) {
+    return DecimalFunctions::decimalToDouble(bar.volume);
+}
+
+double wapOf(const Bar& bar) {
+    return DecimalFunctions::decimalToDouble(bar.wap);
+}
+
+// A value as it reads back from a Decimal (the stub Decimal truncates)
+double viaDecimal(double value) {
+    return DecimalFunctions::decimalToDouble(DecimalFunctions::doubleToDecimal(value));
+}
+
+} // namespace
+
+TEST(RealTimeBarAggregator, RollsFiveSecondBarsIntoTargetBar) {
+    RealTimeBarAggregator aggregator;
+    int slot = aggregator.addSymbol("AAPL", 60);
+
+    // Eleven slices complete nothing; the twelfth closes the minute
+    for (int i = 0; i < 11; ++i) {
+        double price = 100 + i;
+        EXPECT_FALSE(aggregator.onRealTimeBar(slot, T0 + 5 * i, price, price + 0.5, price - 0.5,
+                                              price + 0.25, 10, price, 2));
+    }
+    EXPECT_EQ(T0, aggregator.state(slot).bucket_start);
+    EXPECT_TRUE(aggregator.onRealTimeBar(slot, T0 + 55, 111, 111.5, 110.5, 111.25, 10, 111, 2));
+
+    const RealTimeBarState& state = aggregator.state(slot);
+    ASSERT_EQ(1u, state.window.size());
+    const Bar& bar = state.window[0];
+    EXPECT_EQ(formatBarTime(T0), bar.time);
+    EXPECT_DOUBLE_EQ(100, bar.open);
+    EXPECT_DOUBLE_EQ(111.5, bar.high);
+    EXPECT_DOUBLE_EQ(99.5, bar.low);
+    EXPECT_DOUBLE_EQ(111.25, bar.close);
+    EXPECT_DOUBLE_EQ(120, volumeOf(bar));
+    EXPECT_DOUBLE_EQ(viaDecimal(105.5), wapOf(bar));
+    EXPECT_EQ(24, bar.count);
+    EXPECT_EQ(-1, state.bucket_start);
+    EXPECT_EQ(T0, state.last_closed);
+}
+
+TEST(RealTimeBarAggregator, GapInFeedClosesPendingBar) {
+    RealTimeBarAggregator aggregator;
+    int slot = aggregator.addSymbol("AAPL", 60);
+
+    EXPECT_FALSE(aggregator.onRealTimeBar(slot, T0, 100, 101, 99, 100.5, 10, 100, 1));
+    EXPECT_FALSE(aggregator.onRealTimeBar(slot, T0 + 5, 100.5, 102, 100, 101, 10, 101, 1));
+
+    // The feed skips to the next minute
+    EXPECT_TRUE(aggregator.onRealTimeBar(slot, T0 + 65, 105, 106, 104, 105, 10, 105, 1));
+
+    const RealTimeBarState& state = aggregator.state(slot);
+    ASSERT_EQ(1u, state.window.size());
+    EXPECT_DOUBLE_EQ(102, state.window[0].high);
+    EXPECT_DOUBLE_EQ(101, state.window[0].close);
+    EXPECT_EQ(T0 + 60, state.bucket_start);
+    EXPECT_DOUBLE_EQ(105, state.open);
+}
+
+TEST(RealTimeBarAggregator, WindowKeepsMostRecentBars) {
+    RealTimeBarAggregator aggregator(3, 2);
+    int slot = aggregator.addSymbol("AAPL", 5);
+
+    for (int i = 0; i < 5; ++i) {
+        double price = 100 + i;
+        EXPECT_TRUE(aggregator.onRealTimeBar(slot, T0 + 5 * i, price, price + 1, price - 1, price, 1, price, 1));
+    }
+
+    const RealTimeBarState& state = aggregator.state(slot);
+    ASSERT_EQ(3u, state.window.size());
+    EXPECT_DOUBLE_EQ(102, state.window[0].open);
+    EXPECT_DOUBLE_EQ(104, state.window[2].open);
+    EXPECT_GT(state.atr.value(), 0);
+}
+
+TEST(RealTimeBarAggregator, ClampsBarLengthToSourceBars) {
+    RealTimeBarAggregator aggregator;
+    int slot = aggregator.addSymbol("AAPL", 1);
+    EXPECT_EQ(RealTimeBarAggregator::SOURCE_BAR_SECONDS, aggregator.state(slot).bar_seconds);
+    EXPECT_EQ(1u, aggregator.size());
+}
+
+TEST(RealTimeBarAggregator, TicksBuildBarsWithoutBarFeed) {
+    RealTimeBarAggregator aggregator;
+    int slot = aggregator.addSymbol("AAPL", 60);
+
+    EXPECT_FALSE(aggregator.onTick(slot, T0 + 1, 100, 5));
+    EXPECT_FALSE(aggregator.onTick(slot, T0 + 20, 103, 10));
+    EXPECT_FALSE(aggregator.onTick(slot, T0 + 59, 99, 5));
+
+    // The first tick of the next minute completes the bar
+    EXPECT_TRUE(aggregator.onTick(slot, T0 + 61, 101, 1));
+
+    const RealTimeBarState& state = aggregator.state(slot);
+    ASSERT_EQ(1u, state.window.size());
+    const Bar& bar = state.window[0];
+    EXPECT_DOUBLE_EQ(100, bar.open);
+    EXPECT_DOUBLE_EQ(103, bar.high);
+    EXPECT_DOUBLE_EQ(99, bar.low);
+    EXPECT_DOUBLE_EQ(99, bar.close);
+    EXPECT_DOUBLE_EQ(20, volumeOf(bar));
+    EXPECT_DOUBLE_EQ(viaDecimal((100 * 5 + 103 * 10 + 99 * 5) / 20.0), wapOf(bar));
+    EXPECT_EQ(3, bar.count);
+}
+
+TEST(RealTimeBarAggregator, TicksMovePriceButNotVolumeOfBarFeed) {
+    RealTimeBarAggregator aggregator;
+    int slot = aggregator.addSymbol("AAPL", 60);
+
+    EXPECT_FALSE(aggregator.onRealTimeBar(slot, T0, 100, 101, 99, 100, 10, 100, 1));
+    EXPECT_FALSE(aggregator.onTick(slot, T0 + 7, 104, 50));
+    EXPECT_FALSE(aggregator.onTick(slot, T0 + 8, 98, 50));
+
+    const RealTimeBarState& state = aggregator.state(slot);
+    EXPECT_DOUBLE_EQ(104, state.high);
+    EXPECT_DOUBLE_EQ(98, state.low);
+    EXPECT_DOUBLE_EQ(98, state.close);
+    EXPECT_DOUBLE_EQ(10, state.volume);
+}
+
+TEST(RealTimeBarAggregator, TicksCountVolumeAgainAfterBarFeedEnds) {
+    RealTimeBarAggregator aggregator;
+    int slot = aggregator.addSymbol("AAPL", 60);
+
+    EXPECT_FALSE(aggregator.onRealTimeBar(slot, T0, 100, 101, 99, 100, 10, 100, 1));
+    aggregator.endBarFeed(slot);
+    EXPECT_FALSE(aggregator.onTick(slot, T0 + 7, 102, 50));
+    EXPECT_TRUE(aggregator.onTick(slot, T0 + 60, 103, 5));
+
+    const Bar& bar = aggregator.state(slot).window.back();
+    EXPECT_DOUBLE_EQ(60, volumeOf(bar));
+    EXPECT_EQ(2, bar.count);
+    EXPECT_DOUBLE_EQ(5, aggregator.state(slot).volume);
+}
+
+TEST(RealTimeBarAggregator, IgnoresTicksOfClosedBars) {
+    RealTimeBarAggregator aggregator;
+    int slot = aggregator.addSymbol("AAPL", 5);
+
+    EXPECT_TRUE(aggregator.onRealTimeBar(slot, T0, 100, 101, 99, 100, 10, 100, 1));
+    EXPECT_FALSE(aggregator.onTick(slot, T0 + 3, 150, 1));
+
+    const RealTimeBarState& state = aggregator.state(slot);
+    EXPECT_EQ(-1, state.bucket_start);
+    ASSERT_EQ(1u, state.window.size());
+    EXPECT_DOUBLE_EQ(101, state.window[0].high);
+}
+
+TEST(RealTimeBarAggregator, LateBarMergesIntoBarClosedByTick) {
+    RealTimeBarAggregator aggregator;
+    int slot = aggregator.addSymbol("AAPL", 60);
+
+    for (int i = 0; i < 11; ++i) {
+        EXPECT_FALSE(aggregator.onRealTimeBar(slot, T0 + 5 * i, 100, 101, 99, 100, 10, 100, 1));
+    }
+
+    // A tick of the next minute arrives before the minute's last 5-second bar
+    EXPECT_TRUE(aggregator.onTick(slot, T0 + 60, 104, 1));
+    EXPECT_FALSE(aggregator.onRealTimeBar(slot, T0 + 55, 100, 103, 98, 102, 10, 100, 1));
+
+    // The late bar completed nothing and left the tick-opened bar alone
+    const RealTimeBarState& state = aggregator.state(slot);
+    EXPECT_EQ(T0 + 60, state.bucket_start);
+    EXPECT_DOUBLE_EQ(104, state.open);
+    ASSERT_EQ(1u, state.window.size());
+    const Bar& bar = state.window[0];
+    EXPECT_DOUBLE_EQ(103, bar.high);
+    EXPECT_DOUBLE_EQ(98, bar.low);
+    EXPECT_DOUBLE_EQ(102, bar.close);
+    EXPECT_DOUBLE_EQ(120, volumeOf(bar));
+    EXPECT_EQ(12, bar.count);
+
+    // The next minute completes normally and keeps the tick's open
+    for (int i = 1; i < 11; ++i) {
+        EXPECT_FALSE(aggregator.onRealTimeBar(slot, T0 + 60 + 5 * i, 105, 106, 104, 105, 10, 105, 1));
+    }
+    EXPECT_TRUE(aggregator.onRealTimeBar(slot, T0 + 115, 105, 106, 104, 105, 10, 105, 1));
+    ASSERT_EQ(2u, state.window.size());
+    EXPECT_DOUBLE_EQ(104, state.window[1].open);
+    EXPECT_EQ(formatBarTime(T0 + 60), state.window[1].time);
+}
+
+TEST(RealTimeBarAggregator, DropsLateBarOlderThanTickOpenedBar) {
+    RealTimeBarAggregator aggregator;
+    int slot = aggregator.addSymbol("AAPL", 60);
+
+    EXPECT_TRUE(aggregator.onRealTimeBar(slot, T0 + 55, 100, 101, 99, 100, 10, 100, 1));
+
+    // Ticks skip a minute; a bar of the skipped minute then arrives
+    EXPECT_FALSE(aggregator.onTick(slot, T0 + 121, 110, 1));
+    EXPECT_FALSE(aggregator.onRealTimeBar(slot, T0 + 65, 105, 106, 104, 105, 10, 105, 1));
+
+    // Bars older than the last completed one are dropped as well
+    EXPECT_FALSE(aggregator.onRealTimeBar(slot, T0 - 5, 90, 91, 89, 90, 10, 90, 1));
+
+    const RealTimeBarState& state = aggregator.state(slot);
+    EXPECT_EQ(T0 + 120, state.bucket_start);
+    EXPECT_DOUBLE_EQ(110, state.open);
+    EXPECT_DOUBLE_EQ(110, state.high);
+    ASSERT_EQ(1u, state.window.size());
+    EXPECT_DOUBLE_EQ(101, state.window[0].high);
+    EXPECT_DOUBLE_EQ(10, volumeOf(state.window[0]));
+}
+
+TEST(RealTimeBarAggregator, SubscriptionsAreIndependent) {
+    RealTimeBarAggregator aggregator;
+    int first = aggregator.addSymbol("AAPL", 5);
+    int second = aggregator.addSymbol("MSFT", 60);
+    EXPECT_NE(first, second);
+
+    EXPECT_TRUE(aggregator.onRealTimeBar(first, T0, 100, 101, 99, 100, 10, 100, 1));
+    EXPECT_FALSE(aggregator.onRealTimeBar(second, T0, 200, 201, 199, 200, 10, 200, 1));
+    EXPECT_EQ(1u, aggregator.state(first).window.size());
+    EXPECT_EQ(0u, aggregator.state(second).window.size());
+    EXPECT_EQ("MSFT", aggregator.state(second).symbol);
+}
@@ -0,0 +1,244 @@
+/**
+ * Result Record and Result File Tests
+ */
+
+#include "ResultRecord.h"
+#include "AutoFibIndicator.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+
+namespace {
+
+FibonacciResults sampleResults() {
+    FibonacciResults results;
+    results.trend = "BULLISH";
+    results.high_value = 110;
+    results.low_value = 100;
+    results.fibo_range = 10;
+    results.fibo_levels["0.0"] = 110;
+    results.fibo_levels["0.5"] = 105;
+    results.fibo_levels["1.0"] = 100;
+    results.golden_zone_low = 103.82;
+    results.golden_zone_high = 104.48;
+    results.current_price = 104;
+    results.price_in_golden_zone = true;
+    results.atr = 1.5;
+    results.high_bar_index = 3;
+    results.low_bar_index = 12;
+    return results;
+}
+
+class ResultFileTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        path = ::testing::TempDir() + "autofib_result_file_" + std::to_string(::getpid()) + ".bin";
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    void write(const std::string& bytes) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+};
+
+std::string fileHeader() {
+    return resultFileHeader(AutoFibIndicator().getFibonacciLevels());
+}
+
+std::string recordBytes(const ResultRecord& record) {
+    return std::string(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+} // namespace
+
+TEST(ResultRecord, LayoutIsFixed) {
+    EXPECT_EQ(64u, sizeof(ResultFileHeader));
+    EXPECT_EQ(168u, sizeof(ResultRecord));
+    EXPECT_EQ(32u, sizeof(ResultLevelInfo));
+    EXPECT_EQ(64u + 10 * sizeof(ResultLevelInfo), fileHeader().size());
+}
+
+TEST(ResultRecord, FillsFromResults) {
+    ResultRecord record;
+    toResultRecord(7, "VERY_LONG_SYMBOL_NAME", 1700000000, sampleResults(), record);
+
+    EXPECT_EQ(1700000000, record.time);
+    EXPECT_EQ(7u, record.symbol_id);
+    EXPECT_STREQ("VERY_LONG_SYMBO", record.symbol);
+    EXPECT_EQ(RESULT_SIGNAL_BUY, record.signal);
+    EXPECT_EQ(RESULT_FLAG_BULLISH | RESULT_FLAG_IN_GOLDEN_ZONE, record.flags);
+    EXPECT_DOUBLE_EQ(110, record.high);
+    EXPECT_DOUBLE_EQ(100, record.low);
+    EXPECT_DOUBLE_EQ(1.5, record.atr);
+    EXPECT_EQ(3, record.high_bar_index);
+    EXPECT_EQ(12, record.low_bar_index);
+
+    // Levels in key order, the rest NaN
+    EXPECT_DOUBLE_EQ(110, record.levels[0]);
+    EXPECT_DOUBLE_EQ(105, record.levels[1]);
+    EXPECT_DOUBLE_EQ(100, record.levels[2]);
+    for (int i = 3; i < ResultRecord::MAX_LEVELS; ++i) {
+        EXPECT_TRUE(std::isnan(record.levels[i]));
+    }
+}
+
+TEST(ResultRecord, ErrorResultsCarryOnlyTheFlag) {
+    FibonacciResults results = sampleResults();
+    results.error = "Insufficient data";
+
+    ResultRecord record;
+    toResultRecord(1, "AAPL", 1, results, record);
+    EXPECT_EQ(RESULT_FLAG_ERROR, record.flags);
+    EXPECT_EQ(RESULT_SIGNAL_NO_DATA, record.signal);
+    EXPECT_EQ(0, record.high);
+    EXPECT_TRUE(std::isnan(record.levels[0]));
+}
+
+TEST(ResultRecord, SignalNamesRoundTrip) {
+    const int signals[] = {RESULT_SIGNAL_NO_DATA, RESULT_SIGNAL_HOLD, RESULT_SIGNAL_BUY, RESULT_SIGNAL_SELL};
+    for (int signal : signals) {
+        EXPECT_EQ(signal, resultSignalCode(resultSignalName(signal)));
+    }
+    EXPECT_EQ(RESULT_SIGNAL_NO_DATA, resultSignalCode("bogus"));
+}
+
+TEST_F(ResultFileTest, MapsRecordsAndIgnoresPartialTail) {
+    ResultRecord first, second;
+    toResultRecord(0, "AAPL", 100, sampleResults(), first);
+    toResultRecord(1, "MSFT", 200, sampleResults(), second);
+    write(fileHeader() + recordBytes(first) + recordBytes(second) + recordBytes(first).substr(0, 40));
+
+    std::string error;
+    ResultFile file = ResultFile::map(path, &error);
+    ASSERT_TRUE(error.empty()) << error;
+    ASSERT_EQ(2u, file.size());
+    EXPECT_STREQ("AAPL", file[0].symbol);
+    EXPECT_STREQ("MSFT", file[1].symbol);
+    EXPECT_EQ(200, file[1].time);
+}
+
+TEST_F(ResultFileTest, HeaderOnlyFileIsEmpty) {
+    write(fileHeader());
+    ResultFile file = ResultFile::map(path);
+    EXPECT_TRUE(file.empty());
+}
+
+TEST_F(ResultFileTest, UsesRecordSizeAsStride) {
+    // A newer producer appended 8 bytes to every record
+    std::string header = fileHeader();
+    ResultFileHeader fields;
+    std::memcpy(&fields, header.data(), sizeof(fields));
+    fields.record_size = sizeof(ResultRecord) + 8;
+    header.replace(0, sizeof(fields), reinterpret_cast<const char*>(&fields), sizeof(fields));
+
+    ResultRecord first, second;
+    toResultRecord(0, "AAPL", 100, sampleResults(), first);
+    toResultRecord(1, "MSFT", 200, sampleResults(), second);
+    std::string padding(8, '\xff');
+    write(header + recordBytes(first) + padding + recordBytes(second) + padding);
+
+    ResultFile file = ResultFile::map(path);
+    ASSERT_EQ(2u, file.size());
+    EXPECT_STREQ("MSFT", file[1].symbol);
+}
+
+TEST_F(ResultFileTest, NamesLevelsOfCustomIndicator) {
+    // Levels replaced at runtime: the table maps levels[i] back to them
+    AutoFibIndicator indicator;
+    std::map<std::string, double> levels;
+    levels["a_zero"] = 0;
+    levels["b_golden"] = 0.618;
+    levels["c_a_name_longer_than_the_field"] = 1;
+    indicator.setFibonacciLevels(levels);
+
+    FibonacciResults results = sampleResults();
+    results.fibo_levels.clear();
+    results.fibo_levels["a_zero"] = 100;
+    results.fibo_levels["b_golden"] = 106.18;
+    results.fibo_levels["c_a_name_longer_than_the_field"] = 110;
+    ResultRecord record;
+    toResultRecord(0, "AAPL", 100, results, record);
+    write(resultFileHeader(indicator.getFibonacciLevels()) + recordBytes(record));
+
+    std::string error;
+    ResultFile file = ResultFile::map(path, &error);
+    ASSERT_TRUE(error.empty()) << error;
+    ASSERT_EQ(1u, file.size());
+    ASSERT_EQ(3u, file.levelCount());
+    EXPECT_STREQ("b_golden", file.level(1).name);
+    EXPECT_DOUBLE_EQ(0.618, file.level(1).ratio);
+    EXPECT_DOUBLE_EQ(106.18, file[0].levels[1]);
+    EXPECT_STREQ("c_a_name_longer_than_th", file.level(2).name);
+    EXPECT_TRUE(std::isnan(file[0].levels[3]));
+}
+
+TEST_F(ResultFileTest, ReadsVersionOneFiles) {
+    ResultFileHeader fields;
+    std::memcpy(&fields, fileHeader().data(), sizeof(fields));
+    fields.version = 1;
+    fields.header_size = sizeof(ResultFileHeader);
+    fields.level_count = ResultRecord::MAX_LEVELS;
+
+    ResultRecord record;
+    toResultRecord(0, "AAPL", 100, sampleResults(), record);
+    write(std::string(reinterpret_cast<const char*>(&fields), sizeof(fields)) + recordBytes(record));
+
+    std::string error;
+    ResultFile file = ResultFile::map(path, &error);
+    ASSERT_TRUE(error.empty()) << error;
+    ASSERT_EQ(1u, file.size());
+    EXPECT_STREQ("AAPL", file[0].symbol);
+    EXPECT_EQ(0u, file.levelCount());
+}
+
+TEST_F(ResultFileTest, RejectsInvalidFiles) {
+    std::string error;
+    EXPECT_TRUE(ResultFile::map(path + ".missing", &error).empty());
+    EXPECT_NE(std::string::npos, error.find("Cannot open"));
+
+    write("short");
+    error.clear();
+    EXPECT_TRUE(ResultFile::map(path, &error).empty());
+    EXPECT_NE(std::string::npos, error.find("Not a result file"));
+
+    std::string header = fileHeader();
+    header[0] = 'X';
+    write(header);
+    error.clear();
+    EXPECT_TRUE(ResultFile::map(path, &error).empty());
+    EXPECT_NE(std::string::npos, error.find("Not a result file"));
+
+    ResultFileHeader fields;
+    std::memcpy(&fields, fileHeader().data(), sizeof(fields));
+    fields.byte_order = 0x04030201;
+    write(std::string(reinterpret_cast<const char*>(&fields), sizeof(fields)));
+    error.clear();
+    EXPECT_TRUE(ResultFile::map(path, &error).empty());
+    EXPECT_NE(std::string::npos, error.find("byte order"));
+
+    std::memcpy(&fields, fileHeader().data(), sizeof(fields));
+    fields.record_size = 16;
+    write(std::string(reinterpret_cast<const char*>(&fields), sizeof(fields)));
+    error.clear();
+    EXPECT_TRUE(ResultFile::map(path, &error).empty());
+    EXPECT_NE(std::string::npos, error.find("Corrupt"));
+
+    // A level table that does not fit in the header
+    header = fileHeader();
+    std::memcpy(&fields, header.data(), sizeof(fields));
+    fields.level_count = 11;
+    header.replace(0, sizeof(fields), reinterpret_cast<const char*>(&fields), sizeof(fields));
+    write(header);
+    error.clear();
+    EXPECT_TRUE(ResultFile::map(path, &error).empty());
+    EXPECT_NE(std::string::npos, error.find("level table"));
+}
@@ -0,0 +1,164 @@
+/**
+ * Result Publisher / Subscriber Tests
+ */
+
+#include "ResultPublisher.h"
+#include "AutoFibIndicator.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+class ResultPublisherTest : public ::testing::Test {
+protected:
+    std::string name;
+
+    void SetUp() override {
+        name = "/autofib_test_" + std::to_string(::getpid());
+    }
+
+    void TearDown() override {
+        ResultPublisher::unlink(name);
+    }
+};
+
+FibonacciResults resultsAt(double price) {
+    FibonacciResults results;
+    results.trend = "BEARISH";
+    results.high_value = 110;
+    results.low_value = 100;
+    results.fibo_range = 10;
+    results.current_price = price;
+    return results;
+}
+
+} // namespace
+
+TEST_F(ResultPublisherTest, SubscriberReadsPublishedResults) {
+    ResultPublisher publisher;
+    std::string error;
+    ASSERT_TRUE(publisher.open(name, 4, &error)) << error;
+    ASSERT_TRUE(publisher.publish("AAPL", 100, resultsAt(101)));
+    ASSERT_TRUE(publisher.publish("MSFT", 100, resultsAt(102)));
+
+    ResultSubscriber subscriber;
+    ASSERT_TRUE(subscriber.open(name, &error)) << error;
+    EXPECT_EQ(2, subscriber.size());
+    EXPECT_EQ(0, subscriber.find("AAPL"));
+    EXPECT_EQ(1, subscriber.find("MSFT"));
+    EXPECT_EQ(-1, subscriber.find("SPY"));
+
+    ResultRecord record;
+    uint64_t first = 0;
+    ASSERT_TRUE(subscriber.read(1, record, &first));
+    EXPECT_STREQ("MSFT", record.symbol);
+    EXPECT_DOUBLE_EQ(102, record.current_price);
+    EXPECT_EQ(1u, record.symbol_id);
+
+    // A new publish changes the sequence; an unchanged slot keeps it
+    uint64_t second = 0;
+    ASSERT_TRUE(publisher.publish("MSFT", 101, resultsAt(103)));
+    ASSERT_TRUE(subscriber.read(1, record, &second));
+    EXPECT_NE(first, second);
+    EXPECT_DOUBLE_EQ(103, record.current_price);
+    ASSERT_TRUE(subscriber.read(1, record, &first));
+    EXPECT_EQ(first, second);
+}
+
+TEST_F(ResultPublisherTest, UnpublishedSlotsAreNotReadable) {
+    ResultPublisher publisher;
+    ASSERT_TRUE(publisher.open(name, 4));
+    ASSERT_EQ(0, publisher.slotFor("AAPL"));
+
+    ResultSubscriber subscriber;
+    ASSERT_TRUE(subscriber.open(name));
+    ResultRecord record;
+    EXPECT_FALSE(subscriber.read(0, record));
+    EXPECT_FALSE(subscriber.read(1, record));
+    EXPECT_FALSE(subscriber.read(-1, record));
+}
+
+TEST_F(ResultPublisherTest, FindsSymbolsLongerThanTheRecordField) {
+    ResultPublisher publisher;
+    ASSERT_TRUE(publisher.open(name, 4));
+    const std::string option = "AAPL  241220C00150000";
+    ASSERT_TRUE(publisher.publish("AAPL", 100, resultsAt(101)));
+    ASSERT_TRUE(publisher.publish(option, 100, resultsAt(2.5)));
+
+    ResultSubscriber subscriber;
+    ASSERT_TRUE(subscriber.open(name));
+    EXPECT_EQ(1, subscriber.find(option));
+    EXPECT_EQ(1, subscriber.find(option.substr(0, 15)));
+    EXPECT_EQ(-1, subscriber.find(option.substr(0, 14)));
+    EXPECT_EQ(0, subscriber.find("AAPL"));
+
+    ResultRecord record;
+    ASSERT_TRUE(subscriber.read(subscriber.find(option), record));
+    EXPECT_DOUBLE_EQ(2.5, record.current_price);
+}
+
+TEST_F(ResultPublisherTest, FullSegmentRefusesNewSymbols) {
+    ResultPublisher publisher;
+    ASSERT_TRUE(publisher.open(name, 2));
+    EXPECT_EQ(0, publisher.slotFor("A"));
+    EXPECT_EQ(1, publisher.slotFor("B"));
+    EXPECT_EQ(-1, publisher.slotFor("C"));
+    EXPECT_EQ(0, publisher.slotFor("A"));
+    EXPECT_FALSE(publisher.publish("C", 1, resultsAt(1)));
+}
+
+TEST_F(ResultPublisherTest, OpenFailsWithoutSegment) {
+    ResultSubscriber subscriber;
+    std::string error;
+    EXPECT_FALSE(subscriber.open(name + "_missing", &error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_FALSE(subscriber.isOpen());
+}
+
+TEST_F(ResultPublisherTest, ReadsAreNeverTorn) {
+    ResultPublisher publisher;
+    ASSERT_TRUE(publisher.open(name, 1));
+    int slot = publisher.slotFor("AAPL");
+    ASSERT_EQ(0, slot);
+
+    ResultRecord record;
+    std::memset(&record, 0, sizeof(record));
+    std::strcpy(record.symbol, "AAPL");
+    publisher.publish(slot, record);
+
+    ResultSubscriber subscriber;
+    ASSERT_TRUE(subscriber.open(name));
+
+    // Every field of a record written by the publisher carries the same value
+    std::atomic<bool> running(true);
+    std::thread writer([&]() {
+        ResultRecord next = record;
+        for (int64_t n = 1; running.load(); ++n) {
+            next.time = n;
+            next.high = next.low = next.current_price = static_cast<double>(n);
+            for (int i = 0; i < ResultRecord::MAX_LEVELS; ++i) {
+                next.levels[i] = static_cast<double>(n);
+            }
+            publisher.publish(slot, next);
+        }
+    });
+
+    int consistent = 0;
+    for (int i = 0; i < 20000; ++i) {
+        ResultRecord copy;
+        if (!subscriber.read(slot, copy)) {
+            continue;
+        }
+        double expected = static_cast<double>(copy.time);
+        ASSERT_EQ(expected, copy.high);
+        ASSERT_EQ(expected, copy.current_price);
+        ASSERT_EQ(expected, copy.levels[ResultRecord::MAX_LEVELS - 1]);
+        ++consistent;
+    }
+    running.store(false);
+    writer.join();
+    EXPECT_GT(consistent, 0);
+}
@@ -0,0 +1,238 @@
+/**
+ * Result Writer Tests
+ */
+
+#include "ResultWriter.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+class ResultWriterTest : public ::testing::Test {
+protected:
+    std::string directory;
+    ResultWriterConfig config;
+
+    void SetUp() override {
+        directory = ::testing::TempDir() + "autofib_result_writer_" + std::to_string(::getpid());
+        config.directory = directory;
+        config.segment_bytes = 1;           // Every commit starts a new segment
+        config.flush_interval_ms = 10;
+    }
+
+    void TearDown() override {
+        removeDirectory();
+    }
+
+    std::vector<std::string> segmentFiles() {
+        std::vector<std::string> files;
+        DIR* dir = ::opendir(directory.c_str());
+        if (!dir) {
+            return files;
+        }
+        while (struct dirent* entry = ::readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                files.push_back(directory + "/" + entry->d_name);
+            }
+        }
+        ::closedir(dir);
+        return files;
+    }
+
+    void removeDirectory() {
+        for (const auto& file : segmentFiles()) {
+            ::unlink(file.c_str());
+        }
+        ::rmdir(directory.c_str());
+    }
+
+    static std::string readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream contents;
+        contents << in.rdbuf();
+        return contents.str();
+    }
+
+    std::string writtenText() {
+        std::string text;
+        for (const auto& file : segmentFiles()) {
+            text += readFile(file);
+        }
+        return text;
+    }
+
+    // Segment contents in name order
+    std::vector<std::string> segmentContents() {
+        std::vector<std::string> files = segmentFiles();
+        std::sort(files.begin(), files.end());
+        std::vector<std::string> contents;
+        for (const auto& file : files) {
+            contents.push_back(readFile(file));
+        }
+        return contents;
+    }
+
+    // Wait until the writer thread has finished `count` commit attempts
+    static bool waitForAttempts(ResultWriter& writer, uint64_t count) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            ResultWriter::Stats stats = writer.getStats();
+            if (stats.commits + stats.write_errors >= count) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+};
+
+/**
+ * Makes writes past `bytes` of any file fail short (EFBIG) while in scope
+ */
+class FileSizeLimit {
+private:
+    rlimit saved;
+    void (*saved_handler)(int);
+
+public:
+    explicit FileSizeLimit(rlim_t bytes) {
+        saved_handler = std::signal(SIGXFSZ, SIG_IGN);
+        ::getrlimit(RLIMIT_FSIZE, &saved);
+        rlimit limit = saved;
+        limit.rlim_cur = bytes;
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+    }
+
+    ~FileSizeLimit() {
+        ::setrlimit(RLIMIT_FSIZE, &saved);
+        std::signal(SIGXFSZ, saved_handler);
+    }
+};
+
+} // namespace
+
+TEST_F(ResultWriterTest, WritesRecordsInOrder) {
+    ResultWriter writer(config);
+    std::string error;
+    ASSERT_TRUE(writer.start(&error)) << error;
+
+    ASSERT_TRUE(writer.append("a\n", 2));
+    ASSERT_TRUE(writer.append("b\n", 2));
+    writer.stop();
+
+    ResultWriter::Stats stats = writer.getStats();
+    EXPECT_EQ(2u, stats.records);
+    EXPECT_EQ(0u, stats.dropped);
+    EXPECT_EQ(4u, stats.bytes_written);
+    EXPECT_EQ("a\nb\n", writtenText());
+}
+
+TEST_F(ResultWriterTest, KeepsRecordsWhileNoSegmentOpens) {
+    ResultWriter writer(config);
+    ASSERT_TRUE(writer.start());
+    ASSERT_TRUE(writer.append("a\n", 2));
+    writer.flush();
+    ASSERT_TRUE(waitForAttempts(writer, 1));
+
+    // The next commit rolls the segment, which cannot be created any more
+    removeDirectory();
+    ASSERT_TRUE(writer.append("b\n", 2));
+    writer.flush();
+    ASSERT_TRUE(waitForAttempts(writer, 2));
+    EXPECT_GE(writer.getStats().write_errors, 1u);
+    EXPECT_FALSE(writer.lastError().empty());
+
+    // Once the directory is back the held records are written, in order
+    ASSERT_EQ(0, ::mkdir(directory.c_str(), 0755));
+    ASSERT_TRUE(writer.append("c\n", 2));
+    writer.stop();
+
+    ResultWriter::Stats stats = writer.getStats();
+    EXPECT_EQ(3u, stats.records);
+    EXPECT_EQ(0u, stats.dropped);
+    EXPECT_EQ("b\nc\n", writtenText());
+}
+
+TEST_F(ResultWriterTest, HeldRecordsCountAgainstPendingLimit) {
+    config.max_pending_bytes = 4;
+    ResultWriter writer(config);
+    ASSERT_TRUE(writer.start());
+    ASSERT_TRUE(writer.append("a\n", 2));
+    writer.flush();
+    ASSERT_TRUE(waitForAttempts(writer, 1));
+
+    removeDirectory();
+    ASSERT_TRUE(writer.append("bb\n", 3));
+    writer.flush();
+    ASSERT_TRUE(waitForAttempts(writer, 2));
+
+    // 3 bytes are held back, so a 2-byte record exceeds the 4-byte limit
+    EXPECT_FALSE(writer.append("c\n", 2));
+    EXPECT_EQ(1u, writer.getStats().dropped);
+    writer.stop();
+
+    // Records held at stop() are written after the next start()
+    ASSERT_EQ(0, ::mkdir(directory.c_str(), 0755));
+    ASSERT_TRUE(writer.start());
+    writer.stop();
+    EXPECT_EQ("bb\n", writtenText());
+}
+
+TEST_F(ResultWriterTest, ShortWriteStartsNewSegment) {
+    config.segment_bytes = 1 << 20;
+    config.segment_header = "HDR\n";
+    ResultWriter writer(config);
+    std::string error;
+    ASSERT_TRUE(writer.start(&error)) << error;
+    ASSERT_TRUE(writer.append("a\n", 2));
+    writer.flush();
+    ASSERT_TRUE(waitForAttempts(writer, 1));
+
+    {
+        // Only 3 bytes of the next record fit
+        FileSizeLimit limit(9);
+        ASSERT_TRUE(writer.append("bbbbbb\n", 7));
+        writer.flush();
+        ASSERT_TRUE(waitForAttempts(writer, 2));
+    }
+    ResultWriter::Stats stats = writer.getStats();
+    EXPECT_EQ(1u, stats.write_errors);
+    EXPECT_EQ(1u, stats.dropped);
+
+    ASSERT_TRUE(writer.append("c\n", 2));
+    writer.stop();
+
+    // The torn record is cut off and the next one opens a segment of its own
+    std::vector<std::string> contents = segmentContents();
+    ASSERT_EQ(2u, contents.size());
+    EXPECT_EQ("HDR\na\n", contents[0]);
+    EXPECT_EQ("HDR\nc\n", contents[1]);
+}
+
+TEST_F(ResultWriterTest, ShortHeaderWriteLeavesNoSegment) {
+    config.segment_bytes = 1 << 20;
+    config.segment_header = "HEADER\n";
+    ResultWriter writer(config);
+    {
+        FileSizeLimit limit(3);
+        std::string error;
+        EXPECT_FALSE(writer.start(&error));
+        EXPECT_NE(std::string::npos, error.find("Cannot open"));
+    }
+    EXPECT_TRUE(segmentFiles().empty());
+
+    std::string error;
+    ASSERT_TRUE(writer.start(&error)) << error;
+    ASSERT_TRUE(writer.append("a\n", 2));
+    writer.stop();
+    EXPECT_EQ("HEADER\na\n", writtenText());
+}
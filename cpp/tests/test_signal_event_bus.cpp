@@ -0,0 +1,138 @@
+/**
+ * Signal Event Bus Tests
+ */
+
+#include "SignalEventBus.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+SignalEvent eventFor(uint32_t id, uint64_t n) {
+    // The price encodes the producer and its count, so a torn copy is detectable
+    return makeSignalEvent(id, "SYM" + std::to_string(id), 1, 2, id * 1e9 + n, static_cast<int64_t>(n));
+}
+
+} // namespace
+
+TEST(SignalEventBus, RoundsCapacityUpToPowerOfTwo) {
+    EXPECT_EQ(8u, SignalEventBus(5).capacity());
+    EXPECT_EQ(16u, SignalEventBus(16).capacity());
+    EXPECT_EQ(1u, SignalEventBus(0).capacity());
+}
+
+TEST(SignalEventBus, DeliversEventsInOrderFromSubscription) {
+    SignalEventBus bus(8);
+    bus.publish(eventFor(1, 0));
+
+    SignalSubscription subscription = bus.subscribe();
+    SignalEvent event;
+    EXPECT_FALSE(subscription.poll(event));
+
+    for (uint64_t n = 1; n <= 3; ++n) {
+        bus.publish(eventFor(1, n));
+    }
+    for (uint64_t n = 1; n <= 3; ++n) {
+        ASSERT_TRUE(subscription.poll(event));
+        EXPECT_EQ(static_cast<int64_t>(n), event.time_ns);
+        EXPECT_STREQ("SYM1", event.symbol);
+        EXPECT_EQ(1, event.old_signal);
+        EXPECT_EQ(2, event.new_signal);
+    }
+    EXPECT_FALSE(subscription.poll(event));
+    EXPECT_EQ(0u, subscription.lost());
+    EXPECT_EQ(4u, bus.total());
+}
+
+TEST(SignalEventBus, SubscriptionsHaveIndependentCursors) {
+    SignalEventBus bus(8);
+    SignalSubscription first = bus.subscribe();
+    bus.publish(eventFor(1, 1));
+    SignalSubscription second = bus.subscribe();
+    bus.publish(eventFor(1, 2));
+
+    SignalEvent event;
+    ASSERT_TRUE(first.poll(event));
+    EXPECT_EQ(1, event.time_ns);
+    ASSERT_TRUE(second.poll(event));
+    EXPECT_EQ(2, event.time_ns);
+    ASSERT_TRUE(first.poll(event));
+    EXPECT_EQ(2, event.time_ns);
+}
+
+TEST(SignalEventBus, SlowSubscriberSkipsOverwrittenEvents) {
+    SignalEventBus bus(4);
+    SignalSubscription subscription = bus.subscribe();
+    for (uint64_t n = 0; n < 10; ++n) {
+        bus.publish(eventFor(1, n));
+    }
+
+    // Only the last four are still in the ring
+    SignalEvent event;
+    ASSERT_TRUE(subscription.poll(event));
+    EXPECT_EQ(6, event.time_ns);
+    EXPECT_EQ(6u, subscription.lost());
+    for (int64_t n = 7; n < 10; ++n) {
+        ASSERT_TRUE(subscription.poll(event));
+        EXPECT_EQ(n, event.time_ns);
+    }
+    EXPECT_FALSE(subscription.poll(event));
+}
+
+TEST(SignalEventBus, DefaultSubscriptionIsEmpty) {
+    SignalSubscription subscription;
+    SignalEvent event;
+    EXPECT_FALSE(subscription.poll(event));
+}
+
+TEST(SignalEventBus, ConcurrentProducersNeverTearEvents) {
+    // A two-slot ring, so producers lap each other all the time
+    const int producers = 6;
+    const uint64_t per_producer = 50000;
+    SignalEventBus bus(2);
+    SignalSubscription subscription = bus.subscribe();
+
+    std::atomic<int> running(producers);
+    std::vector<std::thread> threads;
+    for (int p = 1; p <= producers; ++p) {
+        threads.emplace_back([&bus, &running, p, per_producer]() {
+            for (uint64_t n = 0; n < per_producer; ++n) {
+                bus.publish(eventFor(static_cast<uint32_t>(p), n));
+                if (n % 64 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            running.fetch_sub(1);
+        });
+    }
+
+    // Every event read must be exactly one producer's event, and each
+    // producer's events arrive in the order it published them
+    std::vector<int64_t> last(producers + 1, -1);
+    uint64_t received = 0;
+    SignalEvent event;
+    for (;;) {
+        bool done = running.load() == 0;
+        while (subscription.poll(event)) {
+            ++received;
+            ASSERT_GE(event.symbol_id, 1u);
+            ASSERT_LE(event.symbol_id, static_cast<uint32_t>(producers));
+            ASSERT_EQ("SYM" + std::to_string(event.symbol_id), event.symbol);
+            ASSERT_EQ(event.symbol_id * 1e9 + event.time_ns, event.price);
+            ASSERT_GT(event.time_ns, last[event.symbol_id]);
+            last[event.symbol_id] = event.time_ns;
+        }
+        if (done) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(producers * per_producer, bus.total());
+    EXPECT_EQ(bus.total(), received + subscription.lost());
+}
@@ -0,0 +1,74 @@
+/**
+ * Tick Ring Buffer and Tick Ingestor Tests
+ */
+
+#include "TickRingBuffer.h"
+#include "TickIngestor.h"
+#include <gtest/gtest.h>
+
+TEST(TickRingBuffer, RoundsCapacityUpToPowerOfTwo) {
+    EXPECT_EQ(8u, TickRingBuffer<int>(5).capacity());
+    EXPECT_EQ(8u, TickRingBuffer<int>(8).capacity());
+    EXPECT_EQ(0u, TickRingBuffer<int>().capacity());
+}
+
+TEST(TickRingBuffer, KeepsInsertionOrderBeforeWrapping) {
+    TickRingBuffer<int> ring(4);
+    EXPECT_TRUE(ring.empty());
+
+    ring.push(1);
+    ring.push(2);
+    ring.push(3);
+    ASSERT_EQ(3u, ring.size());
+    EXPECT_EQ(1, ring[0]);
+    EXPECT_EQ(3, ring[2]);
+    EXPECT_EQ(3, ring.back());
+    EXPECT_EQ(3u, ring.total());
+}
+
+TEST(TickRingBuffer, OverwritesOldestWhenFull) {
+    TickRingBuffer<int> ring(4);
+    for (int i = 0; i < 11; ++i) {
+        ring.push(i);
+    }
+
+    // Only the four newest survive, still oldest first
+    ASSERT_EQ(4u, ring.size());
+    EXPECT_EQ(11u, ring.total());
+    for (size_t i = 0; i < ring.size(); ++i) {
+        EXPECT_EQ(static_cast<int>(7 + i), ring[i]);
+    }
+    EXPECT_EQ(10, ring.back());
+}
+
+TEST(TickIngestor, StoresTicksPerSlot) {
+    TickIngestor ingestor(4);
+    ingestor.addSymbol(1);
+    EXPECT_FALSE(ingestor.hasSymbol(0));
+    EXPECT_TRUE(ingestor.hasSymbol(1));
+    EXPECT_FALSE(ingestor.hasSymbol(2));
+
+    ingestor.onLast(1, 100, 10.5, 200);
+    ingestor.onBidAsk(1, 101, 10.4, 10.6, 300, 400);
+    ingestor.onMidPoint(1, 102, 10.45);
+
+    const TickRingBuffer<TickRecord>& ticks = ingestor.ticks(1);
+    ASSERT_EQ(3u, ticks.size());
+    EXPECT_EQ(TICK_KIND_LAST, ticks[0].kind);
+    EXPECT_DOUBLE_EQ(200, ticks[0].size);
+    EXPECT_EQ(TICK_KIND_BID_ASK, ticks[1].kind);
+    EXPECT_DOUBLE_EQ(10.5, ticks[1].price);
+    EXPECT_DOUBLE_EQ(400, ticks[1].ask_size);
+    EXPECT_EQ(TICK_KIND_MIDPOINT, ticks[2].kind);
+    EXPECT_EQ(102, ticks[2].time);
+}
+
+TEST(TickIngestor, AddingSymbolTwiceKeepsTicks) {
+    TickIngestor ingestor(4);
+    ingestor.addSymbol(0);
+    ingestor.onLast(0, 100, 10, 1);
+    ingestor.addSymbol(0);
+    ingestor.addSymbol(3);
+    EXPECT_EQ(1u, ingestor.ticks(0).size());
+    EXPECT_TRUE(ingestor.ticks(3).empty());
+}
@@ -0,0 +1,95 @@
+/**
+ * Wire Log Tests
+ */
+
+#include "WireLog.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+
+class WireLogTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        path = ::testing::TempDir() + "autofib_wire_log_" + std::to_string(::getpid()) + ".wire";
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    void writeLog() {
+        WireLogWriter writer;
+        std::string error;
+        ASSERT_TRUE(writer.open(path, 176, &error)) << error;
+        ASSERT_TRUE(writer.append(10, "first", 5));
+        ASSERT_TRUE(writer.append(20, "second", 6));
+        writer.close();
+    }
+
+    // Rewrite the header of the log at path
+    void patchHeader(void (*patch)(WireLogHeader&)) {
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream contents;
+        contents << in.rdbuf();
+        std::string bytes = contents.str();
+        in.close();
+
+        WireLogHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        patch(header);
+        bytes.replace(0, sizeof(header), reinterpret_cast<const char*>(&header), sizeof(header));
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+};
+
+} // namespace
+
+TEST_F(WireLogTest, ReadsMessagesInOrder) {
+    writeLog();
+
+    WireLogReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.open(path, &error)) << error;
+    EXPECT_EQ(176, reader.serverVersion());
+
+    WireMessage message;
+    ASSERT_TRUE(reader.next(message));
+    EXPECT_EQ(10, message.time_ns);
+    EXPECT_EQ("first", std::string(message.data, message.size));
+    ASSERT_TRUE(reader.next(message));
+    EXPECT_EQ("second", std::string(message.data, message.size));
+    EXPECT_FALSE(reader.next(message));
+
+    reader.rewind();
+    ASSERT_TRUE(reader.next(message));
+    EXPECT_EQ(10, message.time_ns);
+}
+
+TEST_F(WireLogTest, RejectsNewerVersions) {
+    writeLog();
+    patchHeader([](WireLogHeader& header) { header.version = WireLogReader::FORMAT_VERSION + 1; });
+
+    WireLogReader reader;
+    std::string error;
+    EXPECT_FALSE(reader.open(path, &error));
+    EXPECT_NE(std::string::npos, error.find("Unsupported wire log version 2"));
+    EXPECT_FALSE(reader.isOpen());
+}
+
+TEST_F(WireLogTest, RejectsCorruptHeader) {
+    writeLog();
+    patchHeader([](WireLogHeader& header) { header.header_size = 1 << 20; });
+
+    WireLogReader reader;
+    std::string error;
+    EXPECT_FALSE(reader.open(path, &error));
+    EXPECT_NE(std::string::npos, error.find("Corrupt"));
+}